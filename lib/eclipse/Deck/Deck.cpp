@@ -18,6 +18,7 @@
  */
 
 #include <algorithm>
+#include <iterator>
 #include <vector>
 
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -29,32 +30,36 @@
 namespace Opm {
 
     bool DeckView::hasKeyword( const DeckKeyword& keyword ) const {
-        auto key = this->keywordMap.find( keyword.name() );
+        const auto found = this->find( keyword.name() );
 
-        if( key == this->keywordMap.end() ) return false;
-
-        for( auto index : key->second )
-            if( &this->getKeyword( index ) == &keyword ) return true;
+        for( auto pos = found.first; pos != found.second; ++pos )
+            if( &this->getKeyword( *pos - this->offset ) == &keyword ) return true;
 
         return false;
     }
 
     bool DeckView::hasKeyword( const std::string& keyword ) const {
-        return this->keywordMap.find( keyword ) != this->keywordMap.end();
+        const auto found = this->find( keyword );
+        return found.first != found.second;
     }
 
     const DeckKeyword& DeckView::getKeyword( const std::string& keyword, size_t index ) const {
-        if( !this->hasKeyword( keyword ) )
+        const auto found = this->find( keyword );
+        if( found.first == found.second )
             throw std::invalid_argument("Keyword " + keyword + " not in deck.");
 
-        return this->getKeyword( this->offsets( keyword ).at( index ) );
+        if( index >= size_t( found.second - found.first ) )
+            throw std::out_of_range("Keyword " + keyword + " index " + std::to_string( index ) + " is out of range.");
+
+        return this->getKeyword( *( found.first + index ) - this->offset );
     }
 
     const DeckKeyword& DeckView::getKeyword( const std::string& keyword ) const {
-        if( !this->hasKeyword( keyword ) )
+        const auto found = this->find( keyword );
+        if( found.first == found.second )
             throw std::invalid_argument("Keyword " + keyword + " not in deck.");
 
-        return this->getKeyword( this->offsets( keyword ).back() );
+        return this->getKeyword( *( found.second - 1 ) - this->offset );
     }
 
     const DeckKeyword& DeckView::getKeyword( size_t index ) const {
@@ -65,21 +70,18 @@ namespace Opm {
     }
 
     size_t DeckView::count( const std::string& keyword ) const {
-        if( !this->hasKeyword( keyword ) ) return 0;
-
-        return this->offsets( keyword ).size();
+        const auto found = this->find( keyword );
+        return found.second - found.first;
    }
 
     const std::vector< const DeckKeyword* > DeckView::getKeywordList( const std::string& keyword ) const {
-        if( !hasKeyword( keyword ) ) return {};
-
-        const auto& indices = this->offsets( keyword );
+        const auto found = this->find( keyword );
 
         std::vector< const DeckKeyword* > ret;
-        ret.reserve( indices.size() );
+        ret.reserve( found.second - found.first );
 
-        for( size_t i : indices )
-            ret.push_back( &this->getKeyword( i ) );
+        for( auto pos = found.first; pos != found.second; ++pos )
+            ret.push_back( &this->getKeyword( *pos - this->offset ) );
 
         return ret;
     }
@@ -96,51 +98,60 @@ namespace Opm {
         return this->last;
     }
 
-    void DeckView::add( const DeckKeyword* kw, const_iterator f, const_iterator l ) {
-        this->keywordMap[ kw->name() ].push_back( std::distance( f, l ) - 1 );
-        this->first = f;
-        this->last = l;
-    }
+    static const std::vector< size_t > empty_positions = {};
 
-    static const std::vector< size_t > empty_indices = {};
-    const std::vector< size_t >& DeckView::offsets( const std::string& keyword ) const {
-        if( !hasKeyword( keyword ) ) return empty_indices;
+    /* the positions in the deck of the keywords of the view with this name */
+    DeckView::positions DeckView::find( const std::string& keyword ) const {
+        const auto found = this->m_index->find( keyword );
+        if( found == this->m_index->end() )
+            return { empty_positions.begin(), empty_positions.end() };
 
-        return this->keywordMap.find( keyword )->second;
+        const auto& all = found->second;
+        if( this->offset == 0 && ( all.empty() || all.back() < this->size() ) )
+            return { all.begin(), all.end() };
+
+        const auto lower = std::lower_bound( all.begin(), all.end(), this->offset );
+        const auto upper = std::lower_bound( lower, all.end(), this->offset + this->size() );
+        return { lower, upper };
     }
 
-    DeckView::DeckView( const_iterator first_arg, const_iterator last_arg ) :
-        first( first_arg ), last( last_arg )
-    {
-        size_t index = 0;
-        for( const auto& kw : *this )
-            this->keywordMap[ kw.name() ].push_back( index++ );
+    size_t DeckView::position( const std::string& keyword, size_t from ) const {
+        const auto found = this->find( keyword );
+        const auto pos = std::lower_bound( found.first, found.second, this->offset + from );
+        if( pos == found.second ) return this->size();
+
+        return *pos - this->offset;
     }
 
+    DeckView::DeckView( const KeywordIndex& keywords, const_iterator first_arg, const_iterator last_arg ) :
+        first( first_arg ), last( last_arg ), m_index( &keywords )
+    {}
+
+    DeckView::DeckView( const DeckView& view, size_t first_arg, size_t last_arg ) :
+        first( view.begin() + first_arg ),
+        last( view.begin() + last_arg ),
+        m_index( view.m_index ),
+        offset( view.offset + first_arg )
+    {}
+
     void DeckView::reinit( const_iterator first_arg, const_iterator last_arg ) {
         this->first = first_arg;
         this->last = last_arg;
-
-        this->keywordMap.clear();
-
-        size_t index = 0;
-        for( const auto& kw : *this )
-            this->keywordMap[ kw.name() ].push_back( index++ );
     }
 
-    DeckView::DeckView( std::pair< const_iterator, const_iterator > limits ) :
-        DeckView( limits.first, limits.second )
-    {}
-
     Deck::Deck() : Deck( std::vector< DeckKeyword >() ) {}
 
     Deck::Deck( std::vector< DeckKeyword >&& x ) :
-        DeckView( x.begin(), x.end() ),
+        DeckView( this->keywordIndex, x.begin(), x.end() ),
         keywordList( std::move( x ) ),
         defaultUnits( UnitSystem::newMETRIC() ),
         activeUnits( UnitSystem::newMETRIC() ),
-        m_dataFile("")
+        m_dataFile(""),
+        m_symbols( std::make_shared< SymbolTable >() ),
+        m_sourceNames( std::make_shared< SourceNames >() )
     {
+        this->reindex();
+
         /*
          * If multiple unit systems are requested, metric is preferred over
          * lab, and field over metric, for as long as we have no easy way of
@@ -165,23 +176,43 @@ namespace Opm {
     {}
 
     Deck::Deck( const Deck& d ) :
-        DeckView( d.begin(), d.begin() ),
+        DeckView( this->keywordIndex, d.begin(), d.begin() ),
         keywordList( d.keywordList ),
+        keywordIndex( d.keywordIndex ),
         m_messageContainer( d.m_messageContainer ),
         defaultUnits( d.defaultUnits ),
         activeUnits( d.activeUnits ),
-        m_dataFile( d.m_dataFile ) {
+        m_dataFile( d.m_dataFile ),
+        m_includeGraph( d.m_includeGraph ),
+        m_symbols( d.m_symbols ),
+        m_sourceNames( d.m_sourceNames ) {
+
+        this->reinit(this->keywordList.begin(), this->keywordList.end());
+    }
+
+    Deck::Deck( Deck&& d ) :
+        DeckView( this->keywordIndex, d.begin(), d.begin() ),
+        keywordList( std::move( d.keywordList ) ),
+        keywordIndex( std::move( d.keywordIndex ) ),
+        m_messageContainer( std::move( d.m_messageContainer ) ),
+        defaultUnits( std::move( d.defaultUnits ) ),
+        activeUnits( std::move( d.activeUnits ) ),
+        m_dataFile( std::move( d.m_dataFile ) ),
+        m_includeGraph( std::move( d.m_includeGraph ) ),
+        m_symbols( d.m_symbols ),
+        m_sourceNames( d.m_sourceNames ) {
 
         this->reinit(this->keywordList.begin(), this->keywordList.end());
+        d.keywordList.clear();
+        d.keywordIndex.clear();
+        d.reinit(d.keywordList.begin(), d.keywordList.end());
     }
 
     void Deck::addKeyword( DeckKeyword&& keyword ) {
         this->keywordList.push_back( std::move( keyword ) );
+        this->keywordIndex[ this->keywordList.back().name() ].push_back( this->keywordList.size() - 1 );
 
-        auto fst = this->keywordList.begin();
-        auto lst = this->keywordList.end();
-
-        this->add( &this->keywordList.back(), fst, lst );
+        this->reinit( this->keywordList.begin(), this->keywordList.end() );
     }
 
     void Deck::addKeyword( const DeckKeyword& keyword ) {
@@ -189,6 +220,30 @@ namespace Opm {
         this->addKeyword( std::move( kw ) );
     }
 
+    void Deck::replaceKeywords( size_t from, size_t to, std::vector< DeckKeyword >&& keywords ) {
+        if( from > to || to > this->keywordList.size() )
+            throw std::out_of_range( "Keyword range [" + std::to_string( from ) + ", "
+                                   + std::to_string( to ) + ") is out of range." );
+
+        const auto pos = this->keywordList.erase( this->keywordList.begin() + from,
+                                                  this->keywordList.begin() + to );
+        this->keywordList.insert( pos,
+                                  std::make_move_iterator( keywords.begin() ),
+                                  std::make_move_iterator( keywords.end() ) );
+
+        this->reindex();
+    }
+
+    void Deck::reindex() {
+        this->keywordIndex.clear();
+
+        size_t position = 0;
+        for( const auto& kw : this->keywordList )
+            this->keywordIndex[ kw.name() ].push_back( position++ );
+
+        this->reinit( this->keywordList.begin(), this->keywordList.end() );
+    }
+
 
     DeckKeyword& Deck::getKeyword( size_t index ) {
         return this->keywordList.at( index );
@@ -222,6 +277,22 @@ namespace Opm {
         m_dataFile = dataFile;
     }
 
+    const IncludeGraph& Deck::getIncludeGraph() const {
+        return this->m_includeGraph;
+    }
+
+    IncludeGraph& Deck::getIncludeGraph() {
+        return this->m_includeGraph;
+    }
+
+    const std::shared_ptr< SymbolTable >& Deck::getSymbols() const {
+        return this->m_symbols;
+    }
+
+    const std::shared_ptr< SourceNames >& Deck::getSourceNames() const {
+        return this->m_sourceNames;
+    }
+
     Deck::iterator Deck::begin() {
         return this->keywordList.begin();
     }
@@ -19,19 +19,87 @@
 
 #include <opm/parser/eclipse/Deck/DeckOutput.hpp>
 #include <opm/parser/eclipse/Deck/DeckItem.hpp>
+#include <opm/parser/eclipse/Deck/SymbolTable.hpp>
 #include <opm/parser/eclipse/Units/Dimension.hpp>
 
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <numeric>
+#include <mutex>
 #include <stdexcept>
 #include <cmath>
 
 namespace Opm {
 
+/*
+ * The expanded copies of the values, which are made once for every item
+ * that is asked for them. An item only has values of one type, so only one
+ * of the vectors is ever filled.
+ */
+struct DeckItem::expansion {
+    std::once_flag data_once;
+    std::once_flag si_once;
+    std::vector< int > ints;
+    std::vector< double > doubles;
+    std::vector< std::string > strings;
+    std::vector< double > si;
+
+    std::vector< int >& values( int ) { return this->ints; }
+    std::vector< double >& values( double ) { return this->doubles; }
+    std::vector< std::string >& values( const std::string& ) { return this->strings; }
+};
+
+/*
+ * The shared names and dimensions are never released. The names are the
+ * ones of the items of the keywords, so there are only so many of them.
+ */
+const std::string* DeckItem::shared( const std::string& name ) {
+    static SymbolTable names;
+    return names.intern( name );
+}
+
+/*
+ * The dimensions are found by name, and then compared with operator==, which
+ * also matches the dimensions with a context dependent (NaN) factor.
+ */
+const Dimension* DeckItem::shared( const Dimension& dim ) {
+    static std::mutex lock;
+    static std::map< std::string, std::vector< std::unique_ptr< Dimension > > > dimensions;
+
+    std::lock_guard< std::mutex > guard( lock );
+    auto& candidates = dimensions[ dim.getName() ];
+    for( const auto& candidate : candidates )
+        if( *candidate == dim ) return candidate.get();
+
+    candidates.emplace_back( new Dimension( dim ) );
+    return candidates.back().get();
+}
+
 template< typename T >
-std::vector< T >& DeckItem::value_ref() {
-    return const_cast< std::vector< T >& >(
+DeckItem::stored< T > DeckItem::store( T x ) {
+    return x;
+}
+
+template<>
+const std::string* DeckItem::store( std::string x ) {
+    if( !this->symbols ) this->symbols = std::make_shared< SymbolTable >();
+    return this->symbols->intern( x );
+}
+
+namespace {
+
+const int& value_of( const int& x ) { return x; }
+const double& value_of( const double& x ) { return x; }
+const std::string& value_of( const std::string* x ) { return *x; }
+
+}
+
+template< typename T >
+std::vector< DeckItem::stored< T > >& DeckItem::value_ref() {
+    return const_cast< std::vector< stored< T > >& >(
             const_cast< const DeckItem& >( *this ).value_ref< T >()
          );
 }
@@ -53,57 +121,201 @@ const std::vector< double >& DeckItem::value_ref< double >() const {
 }
 
 template<>
-const std::vector< std::string >& DeckItem::value_ref< std::string >() const {
+const std::vector< const std::string* >& DeckItem::value_ref< std::string >() const {
     if( this->type != get_type< std::string >() )
         throw std::invalid_argument( "Item of wrong type." );
 
     return this->sval;
 }
 
-DeckItem::DeckItem( const std::string& nm ) : item_name( nm ) {}
+void DeckItem::init( type_tag tag, size_t hint ) {
+    switch( tag ) {
+        case type_tag::integer:
+            new( &this->ival ) std::vector< int >();
+            this->type = tag;
+            this->ival.reserve( hint );
+            break;
+        case type_tag::fdouble:
+            new( &this->dval ) std::vector< double >();
+            this->type = tag;
+            this->dval.reserve( hint );
+            break;
+        case type_tag::string:
+            new( &this->sval ) std::vector< const std::string* >();
+            this->type = tag;
+            this->sval.reserve( hint );
+            break;
+        default:
+            this->type = type_tag::unknown;
+    }
+}
+
+void DeckItem::init( const DeckItem& other ) {
+    switch( other.type ) {
+        case type_tag::integer: new( &this->ival ) std::vector< int >( other.ival ); break;
+        case type_tag::fdouble: new( &this->dval ) std::vector< double >( other.dval ); break;
+        case type_tag::string:  new( &this->sval ) std::vector< const std::string* >( other.sval ); break;
+        default: break;
+    }
+
+    this->type = other.type;
+    this->si_converted = other.si_converted;
+}
+
+void DeckItem::init( DeckItem&& other ) {
+    switch( other.type ) {
+        case type_tag::integer: new( &this->ival ) std::vector< int >( std::move( other.ival ) ); break;
+        case type_tag::fdouble: new( &this->dval ) std::vector< double >( std::move( other.dval ) ); break;
+        case type_tag::string:  new( &this->sval ) std::vector< const std::string* >( std::move( other.sval ) ); break;
+        default: break;
+    }
+
+    this->type = other.type;
+    this->si_converted = other.si_converted;
+}
+
+void DeckItem::clear() {
+    using ints = std::vector< int >;
+    using doubles = std::vector< double >;
+    using strings = std::vector< const std::string* >;
+
+    switch( this->type ) {
+        case type_tag::integer: this->ival.~ints(); break;
+        case type_tag::fdouble: this->dval.~doubles(); break;
+        case type_tag::string:  this->sval.~strings(); break;
+        default: break;
+    }
+
+    this->type = type_tag::unknown;
+}
+
+DeckItem::DeckItem() : item_name( shared( "" ) ) {}
+
+DeckItem::DeckItem( const std::string& nm ) : item_name( shared( nm ) ) {}
 
 DeckItem::DeckItem( const std::string& nm, int, size_t hint ) :
-    type( get_type< int >() ),
-    item_name( nm )
+    item_name( shared( nm ) )
 {
-    this->ival.reserve( hint );
-    this->defaulted.reserve( hint );
+    this->init( get_type< int >(), hint );
 }
 
 DeckItem::DeckItem( const std::string& nm, double, size_t hint ) :
-    type( get_type< double >() ),
-    item_name( nm )
+    item_name( shared( nm ) )
+{
+    this->init( get_type< double >(), hint );
+}
+
+DeckItem::DeckItem( const std::string& nm, std::string, size_t hint,
+                    std::shared_ptr< SymbolTable > symbol_table ) :
+    item_name( shared( nm ) ),
+    symbols( std::move( symbol_table ) )
+{
+    this->init( get_type< std::string >(), hint );
+}
+
+DeckItem::DeckItem( const DeckItem& other ) :
+    item_name( other.item_name ),
+    symbols( other.symbols ),
+    default_runs( other.default_runs ),
+    run_ends( other.run_ends ),
+    dimensions( other.dimensions )
 {
-    this->dval.reserve( hint );
-    this->defaulted.reserve( hint );
+    this->init( other );
 }
 
-DeckItem::DeckItem( const std::string& nm, std::string, size_t hint ) :
-    type( get_type< std::string >() ),
-    item_name( nm )
+DeckItem::DeckItem( DeckItem&& other ) noexcept :
+    item_name( other.item_name ),
+    symbols( std::move( other.symbols ) ),
+    default_runs( std::move( other.default_runs ) ),
+    run_ends( std::move( other.run_ends ) ),
+    dimensions( std::move( other.dimensions ) ),
+    expanded( other.expanded.exchange( nullptr ) )
 {
-    this->sval.reserve( hint );
-    this->defaulted.reserve( hint );
+    this->init( std::move( other ) );
+}
+
+DeckItem& DeckItem::operator=( const DeckItem& other ) {
+    if( this == &other ) return *this;
+
+    this->clear();
+    this->init( other );
+    this->item_name = other.item_name;
+    this->symbols = other.symbols;
+    this->default_runs = other.default_runs;
+    this->run_ends = other.run_ends;
+    this->dimensions = other.dimensions;
+    this->drop_expansion();
+    return *this;
+}
+
+DeckItem& DeckItem::operator=( DeckItem&& other ) noexcept {
+    if( this == &other ) return *this;
+
+    this->clear();
+    this->init( std::move( other ) );
+    this->item_name = other.item_name;
+    this->symbols = std::move( other.symbols );
+    this->default_runs = std::move( other.default_runs );
+    this->run_ends = std::move( other.run_ends );
+    this->dimensions = std::move( other.dimensions );
+    this->drop_expansion();
+    this->expanded = other.expanded.exchange( nullptr );
+    return *this;
+}
+
+DeckItem::~DeckItem() {
+    this->clear();
+    this->drop_expansion();
+}
+
+/*
+ * The threads that ask for the expansion of the same item at once race to
+ * publish theirs, and the losers throw theirs away.
+ */
+DeckItem::expansion& DeckItem::expanded_values() const {
+    auto* current = this->expanded.load( std::memory_order_acquire );
+    if( current ) return *current;
+
+    std::unique_ptr< expansion > made( new expansion() );
+    if( this->expanded.compare_exchange_strong( current, made.get(),
+                                                std::memory_order_acq_rel ) )
+        return *made.release();
+
+    return *current;
+}
+
+void DeckItem::drop_expansion() {
+    delete this->expanded.exchange( nullptr );
 }
 
 const std::string& DeckItem::name() const {
-    return this->item_name;
+    return *this->item_name;
 }
 
 bool DeckItem::defaultApplied( size_t index ) const {
-    return this->defaulted.at( index );
+    if( index >= this->out_size() )
+        throw std::out_of_range( "No value " + std::to_string( index ) + " in item " + this->name() );
+
+    using run = std::pair< uint32_t, uint32_t >;
+    const auto next = std::upper_bound( this->default_runs.begin(),
+                                        this->default_runs.end(),
+                                        index,
+                                        []( size_t i, const run& r ) { return i < r.first; } );
+
+    return next != this->default_runs.begin() && index < std::prev( next )->second;
 }
 
 bool DeckItem::hasValue( size_t index ) const {
-    switch( this->type ) {
-        case type_tag::integer: return this->ival.size() > index;
-        case type_tag::fdouble: return this->dval.size() > index;
-        case type_tag::string:  return this->sval.size() > index;
-        default: throw std::logic_error( "Type not set." );
-    }
+    return index < this->size();
 }
 
 size_t DeckItem::size() const {
+    if( !this->run_ends.empty() ) return this->run_ends.back();
+    return this->value_count();
+}
+
+/* the number of stored values, which is the number of runs once there are runs */
+size_t DeckItem::value_count() const {
     switch( this->type ) {
         case type_tag::integer: return this->ival.size();
         case type_tag::fdouble: return this->dval.size();
@@ -114,25 +326,122 @@ size_t DeckItem::size() const {
 
 size_t DeckItem::out_size() const {
     size_t data_size = this->size();
-    return std::max( data_size , this->defaulted.size() );
+    size_t defaulted_size = this->default_runs.empty() ? 0 : this->default_runs.back().second;
+    return std::max( data_size , defaulted_size );
+}
+
+size_t DeckItem::value_index( size_t index ) const {
+    const auto end = std::upper_bound( this->run_ends.begin(),
+                                       this->run_ends.end(),
+                                       index,
+                                       []( size_t i, uint32_t e ) { return i < e; } );
+    return end - this->run_ends.begin();
 }
 
 template< typename T >
 const T& DeckItem::get( size_t index ) const {
-    return this->value_ref< T >().at( index );
+    const auto& val = this->value_ref< T >();
+    if( this->run_ends.empty() ) return value_of( val.at( index ) );
+
+    if( index >= this->size() )
+        throw std::out_of_range( "No value " + std::to_string( index ) + " in item " + this->name() );
+
+    return value_of( val[ this->value_index( index ) ] );
+}
+
+/* the runs of the values, expanded in place for the SI conversion */
+template< typename T >
+void DeckItem::expand() {
+    auto& val = this->value_ref< T >();
+
+    std::vector< stored< T > > expanded_val;
+    expanded_val.reserve( this->size() );
+
+    size_t begin = 0;
+    for( size_t run = 0; run < this->run_ends.size(); ++run ) {
+        expanded_val.insert( expanded_val.end(), this->run_ends[ run ] - begin, val[ run ] );
+        begin = this->run_ends[ run ];
+    }
+
+    val.swap( expanded_val );
+    this->run_ends.clear();
+    this->run_ends.shrink_to_fit();
+}
+
+template< typename T >
+void DeckItem::spell( std::vector< T >& out ) const {
+    const auto& val = this->value_ref< T >();
+    out.reserve( this->size() );
+
+    if( this->run_ends.empty() ) {
+        for( const auto& value : val ) out.push_back( value_of( value ) );
+        return;
+    }
+
+    size_t begin = 0;
+    for( size_t run = 0; run < this->run_ends.size(); ++run ) {
+        out.insert( out.end(), this->run_ends[ run ] - begin, value_of( val[ run ] ) );
+        begin = this->run_ends[ run ];
+    }
 }
 
 template< typename T >
 const std::vector< T >& DeckItem::getData() const {
-    return this->value_ref< T >();
+    const auto& val = this->value_ref< T >();
+    if( this->run_ends.empty() ) return val;
+
+    auto& copy = this->expanded_values();
+    auto& data = copy.values( T() );
+    std::call_once( copy.data_once, [this, &data] { this->spell( data ); } );
+    return data;
+}
+
+/* the symbols are always spelled out, also when there are no runs */
+template<>
+const std::vector< std::string >& DeckItem::getData< std::string >() const {
+    this->value_ref< std::string >();
+
+    auto& copy = this->expanded_values();
+    auto& data = copy.strings;
+    std::call_once( copy.data_once, [this, &data] { this->spell( data ); } );
+    return data;
+}
+
+size_t DeckItem::runCount() const {
+    return this->run_ends.empty() ? this->size() : this->run_ends.size();
+}
+
+size_t DeckItem::runEnd( size_t run ) const {
+    if( run >= this->runCount() )
+        throw std::out_of_range( "No run " + std::to_string( run ) + " in item " + this->name() );
+
+    return this->run_ends.empty() ? run + 1 : this->run_ends[ run ];
+}
+
+template< typename T >
+const T& DeckItem::runValue( size_t run ) const {
+    return value_of( this->value_ref< T >().at( run ) );
+}
+
+/* the runs are merged, so two items with the same defaults have the same runs */
+void DeckItem::push_defaulted( size_t index, size_t count ) {
+    if( !this->default_runs.empty() && this->default_runs.back().second == index ) {
+        this->default_runs.back().second += count;
+        return;
+    }
+
+    this->default_runs.emplace_back( index, index + count );
 }
 
 template< typename T >
 void DeckItem::push( T x ) {
     auto& val = this->value_ref< T >();
 
-    val.push_back( std::move( x ) );
-    this->defaulted.push_back( false );
+    if( !this->run_ends.empty() )
+        this->run_ends.push_back( this->run_ends.back() + 1 );
+
+    val.push_back( store( std::move( x ) ) );
+    this->drop_expansion();
 }
 
 void DeckItem::push_back( int x ) {
@@ -147,12 +456,28 @@ void DeckItem::push_back( std::string x ) {
     this->push( std::move( x ) );
 }
 
+/*
+ * The first run of more than one value gives the values before it a run of
+ * their own, and from then on every value is pushed with the end of its run.
+ */
 template< typename T >
 void DeckItem::push( T x, size_t n ) {
+    if( n == 0 ) return;
+
     auto& val = this->value_ref< T >();
+    const size_t end = this->size() + n;
+    const bool runs = n > 1 || !this->run_ends.empty();
+
+    if( runs && this->run_ends.empty() ) {
+        this->run_ends.resize( val.size() );
+        std::iota( this->run_ends.begin(), this->run_ends.end(), 1 );
+    }
+
+    if( runs )
+        this->run_ends.push_back( end );
 
-    val.insert( val.end(), n, x );
-    this->defaulted.insert( this->defaulted.end(), n, false );
+    val.push_back( store( std::move( x ) ) );
+    this->drop_expansion();
 }
 
 void DeckItem::push_back( int x, size_t n ) {
@@ -168,80 +493,180 @@ void DeckItem::push_back( std::string x, size_t n ) {
 }
 
 template< typename T >
-void DeckItem::push_default( T x ) {
-    auto& val = this->value_ref< T >();
-    if( this->defaulted.size() != val.size() )
+void DeckItem::push_default( T x, size_t n ) {
+    if( n == 0 ) return;
+
+    /* the type is checked before the size, which needs a type */
+    this->value_ref< T >();
+    const auto index = this->size();
+    if( this->out_size() != index )
         throw std::logic_error("To add a value to an item, "
                 "no 'pseudo defaults' can be added before");
 
-    val.push_back( std::move( x ) );
-    this->defaulted.push_back( true );
+    this->push( std::move( x ), n );
+    this->push_defaulted( index, n );
 }
 
 void DeckItem::push_backDefault( int x ) {
-    this->push_default( x );
+    this->push_default( x, 1 );
 }
 
 void DeckItem::push_backDefault( double x ) {
-    this->push_default( x );
+    this->push_default( x, 1 );
 }
 
 void DeckItem::push_backDefault( std::string x ) {
-    this->push_default( std::move( x ) );
+    this->push_default( std::move( x ), 1 );
+}
+
+void DeckItem::push_backDefault( int x, size_t n ) {
+    this->push_default( x, n );
+}
+
+void DeckItem::push_backDefault( double x, size_t n ) {
+    this->push_default( x, n );
+}
+
+void DeckItem::push_backDefault( std::string x, size_t n ) {
+    this->push_default( std::move( x ), n );
 }
 
 
 void DeckItem::push_backDummyDefault() {
-    if( !this->defaulted.empty() )
+    const bool empty = this->type == type_tag::unknown || this->size() == 0;
+    if( !this->default_runs.empty() || !empty )
         throw std::logic_error("Pseudo defaults can only be specified for empty items");
 
-    this->defaulted.push_back( true );
+    this->push_defaulted( 0, 1 );
 }
 
 std::string DeckItem::getTrimmedString( size_t index ) const {
-    return boost::algorithm::trim_copy(
-               this->value_ref< std::string >().at( index )
-           );
+    return boost::algorithm::trim_copy( this->get< std::string >( index ) );
 }
 
+/* the values of an item with runs are converted one by one, until getSIDoubleData */
 double DeckItem::getSIDouble( size_t index ) const {
-    return this->getSIDoubleData().at( index );
+    if( this->si_converted ) return this->get< double >( index );
+
+    if( this->run_ends.empty() )
+        return this->getSIDoubleData().at( index );
+
+    const auto& raw = this->get< double >( index );
+    if( this->dimensions.empty() )
+        throw std::invalid_argument("No dimension has been set for item'"
+                                    + this->name()
+                                    + "'; can not ask for SI data");
+
+    return this->dimensions[ index % this->dimensions.size() ]->convertRawToSi( raw );
 }
 
 const std::vector< double >& DeckItem::getSIDoubleData() const {
-    const auto& raw = this->value_ref< double >();
-    // we already converted this item to SI?
-    if( !this->SIdata.empty() ) return this->SIdata;
+    if( this->si_converted ) return this->getData< double >();
 
+    const auto& raw = this->value_ref< double >();
     if( this->dimensions.empty() )
         throw std::invalid_argument("No dimension has been set for item'"
                                     + this->name()
                                     + "'; can not ask for SI data");
 
-    /*
-     * This is an unobservable state change - SIData is lazily converted to
-     * SI units, so externally the object still behaves as const
-     */
-    const auto dim_size = dimensions.size();
-    const auto sz = raw.size();
-    this->SIdata.resize( sz );
-
-    for( size_t index = 0; index < sz; index++ ) {
-        const auto dimIndex = index % dim_size;
-        this->SIdata[ index ] = this->dimensions[ dimIndex ]
-                                .convertRawToSi( raw[ index ] );
+    auto& copy = this->expanded_values();
+    std::call_once( copy.si_once, [this, &raw, &copy] {
+        const auto dim_size = this->dimensions.size();
+        const auto sz = this->size();
+        copy.si.resize( sz );
+
+        for( size_t index = 0, value = 0; index < sz; index++ ) {
+            if( this->run_ends.empty() ) value = index;
+            else if( index == this->run_ends[ value ] ) ++value;
+
+            const auto dimIndex = index % dim_size;
+            copy.si[ index ] = this->dimensions[ dimIndex ]
+                               ->convertRawToSi( raw[ value ] );
+        }
+    } );
+
+    return copy.si;
+}
+
+namespace {
+
+/*
+ * A plain loop over contiguous or strided doubles, which the compiler turns
+ * into vector instructions for the contiguous case.
+ */
+void scale_offset( double* first, size_t count, size_t stride, double factor, double offset ) {
+    if( stride == 1 ) {
+        for( size_t i = 0; i < count; ++i )
+            first[ i ] = first[ i ] * factor + offset;
+
+        return;
     }
 
-    return this->SIdata;
+    for( size_t i = 0; i < count; ++i )
+        first[ i * stride ] = first[ i * stride ] * factor + offset;
+}
+
+}
+
+/*
+ * The values of a run share a dimension when there is only one, so the runs
+ * are only expanded for the items with several, where the dimension of a
+ * value is dimensions[ index % dimensions.size() ]. Every dimension then
+ * scales its own stride of the values, unless they all scale the same way.
+ */
+void DeckItem::convertToSI() {
+    auto& raw = this->value_ref< double >();
+    if( this->si_converted || this->dimensions.empty() ) return;
+
+    for( const auto* dim : this->dimensions )
+        if( dim->isContextDependent() ) return;
+
+    const auto same = []( const Dimension* lhs, const Dimension* rhs ) {
+        return lhs->getSIScaling() == rhs->getSIScaling()
+            && lhs->getSIOffset() == rhs->getSIOffset();
+    };
+
+    const auto& first = *this->dimensions.front();
+    const bool uniform = std::all_of( this->dimensions.begin(),
+                                      this->dimensions.end(),
+                                      [&]( const Dimension* dim ) { return same( dim, &first ); } );
+
+    if( uniform ) {
+        scale_offset( raw.data(), raw.size(), 1, first.getSIScaling(), first.getSIOffset() );
+    } else {
+        if( !this->run_ends.empty() ) this->expand< double >();
+
+        const auto period = this->dimensions.size();
+        for( size_t k = 0; k < period && k < raw.size(); ++k ) {
+            const auto* dim = this->dimensions[ k ];
+            const auto count = ( raw.size() - k + period - 1 ) / period;
+            scale_offset( raw.data() + k, count, period, dim->getSIScaling(), dim->getSIOffset() );
+        }
+    }
+
+    this->si_converted = true;
+    this->drop_expansion();
+}
+
+bool DeckItem::isSIConverted() const {
+    return this->si_converted;
+}
+
+double DeckItem::getRawDouble( size_t index ) const {
+    const auto& value = this->get< double >( index );
+    if( !this->si_converted ) return value;
+
+    return this->dimensions[ index % this->dimensions.size() ]->convertSiToRaw( value );
 }
 
 void DeckItem::push_backDimension( const Dimension& active,
                                     const Dimension& def ) {
     const auto& ds = this->value_ref< double >();
     const bool dim_inactive = ds.empty()
-                            || this->defaultApplied( ds.size() - 1 );
+                            || this->defaultApplied( this->size() - 1 );
 
-    this->dimensions.push_back( dim_inactive ? def : active );
+    this->dimensions.push_back( shared( dim_inactive ? def : active ) );
+    this->drop_expansion();
 }
 
 type_tag DeckItem::getType() const {
@@ -251,12 +676,23 @@ type_tag DeckItem::getType() const {
 
 
 template< typename T >
-void DeckItem::write_vector(DeckOutput& stream, const std::vector<T>& data) const {
+void DeckItem::write_vector(DeckOutput& stream) const {
     for (size_t index = 0; index < this->out_size(); index++) {
         if (this->defaultApplied(index))
             stream.stash_default( );
         else
-            stream.write( data[index] );
+            stream.write( this->get< T >( index ) );
+    }
+}
+
+/* the values of an item converted to SI are written in the units of the deck */
+template<>
+void DeckItem::write_vector< double >(DeckOutput& stream) const {
+    for (size_t index = 0; index < this->out_size(); index++) {
+        if (this->defaultApplied(index))
+            stream.stash_default( );
+        else
+            stream.write( this->getRawDouble( index ) );
     }
 }
 
@@ -264,13 +700,13 @@ void DeckItem::write_vector(DeckOutput& stream, const std::vector<T>& data) cons
 void DeckItem::write(DeckOutput& stream) const {
     switch( this->type ) {
     case type_tag::integer:
-        this->write_vector( stream, this->ival );
+        this->write_vector< int >( stream );
         break;
     case type_tag::fdouble:
-        this->write_vector( stream,  this->dval );
+        this->write_vector< double >( stream );
         break;
     case type_tag::string:
-        this->write_vector( stream,  this->sval );
+        this->write_vector< std::string >( stream );
         break;
     default:
         throw std::logic_error( "Type not set." );
@@ -297,6 +733,15 @@ bool double_equal(double value1, double value2, double abs_eps , double rel_eps)
     }
     return equal;
 }
+
+/* the items have the same size, but not necessarily the same runs */
+template< typename T >
+bool values_equal( const DeckItem& lhs, const DeckItem& rhs ) {
+    for( size_t i = 0; i < lhs.size(); ++i )
+        if( lhs.get< T >( i ) != rhs.get< T >( i ) ) return false;
+
+    return true;
+}
 }
 
 
@@ -314,28 +759,30 @@ bool DeckItem::equal(const DeckItem& other, bool cmp_default, bool cmp_numeric)
         return false;
 
     if (cmp_default)
-        if (this->defaulted != other.defaulted)
+        if (this->default_runs != other.default_runs)
             return false;
 
+    const bool same_runs = this->run_ends == other.run_ends;
+
     switch( this->type ) {
     case type_tag::integer:
-        if (this->ival != other.ival)
+        if (same_runs ? this->ival != other.ival : !values_equal< int >( *this, other ))
             return false;
         break;
     case type_tag::string:
-        if (this->sval != other.sval)
+        if (same_runs && this->symbols == other.symbols
+                ? this->sval != other.sval
+                : !values_equal< std::string >( *this, other ))
             return false;
         break;
     case type_tag::fdouble:
         if (cmp_numeric) {
-            const std::vector<double>& this_data = this->dval;
-            const std::vector<double>& other_data = other.dval;
-            for (size_t i=0; i < this_data.size(); i++) {
-                if (!double_equal( this_data[i] , other_data[i], rel_eps, abs_eps))
+            for (size_t i=0; i < this->size(); i++) {
+                if (!double_equal( this->get< double >(i) , other.get< double >(i), rel_eps, abs_eps))
                     return false;
             }
         } else {
-            if (this->dval != other.dval)
+            if (same_runs ? this->dval != other.dval : !values_equal< double >( *this, other ))
                 return false;
         }
         break;
@@ -369,5 +816,8 @@ template const std::string& DeckItem::get< std::string >( size_t ) const;
 
 template const std::vector< int >& DeckItem::getData< int >() const;
 template const std::vector< double >& DeckItem::getData< double >() const;
-template const std::vector< std::string >& DeckItem::getData< std::string >() const;
+
+template const int& DeckItem::runValue< int >( size_t ) const;
+template const double& DeckItem::runValue< double >( size_t ) const;
+template const std::string& DeckItem::runValue< std::string >( size_t ) const;
 }
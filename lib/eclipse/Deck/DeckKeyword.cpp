@@ -48,12 +48,29 @@ namespace Opm {
     }
 
     void DeckKeyword::setLocation(const std::string& fileName, int lineNumber) {
-        m_fileName = fileName;
+        auto names = std::make_shared< SourceNames >();
+        const auto file = names->intern( fileName );
+        this->setLocation( names, file, lineNumber );
+    }
+
+    void DeckKeyword::setLocation(const std::shared_ptr< SourceNames >& names, SourceNames::id file, int lineNumber) {
+        m_names = names;
+        m_file = file;
         m_lineNumber = lineNumber;
     }
 
     const std::string& DeckKeyword::getFileName() const {
-        return m_fileName;
+        static const std::string nofile;
+        if( !m_names ) return nofile;
+        return m_names->name( m_file );
+    }
+
+    SourceNames::id DeckKeyword::getFileId() const {
+        return m_file;
+    }
+
+    const std::shared_ptr< SourceNames >& DeckKeyword::getSourceNames() const {
+        return m_names;
     }
 
     int DeckKeyword::getLineNumber() const {
@@ -68,6 +85,29 @@ namespace Opm {
         return m_isDataKeyword;
     }
 
+    bool DeckKeyword::isPlaceholder() const {
+        return m_placeholder;
+    }
+
+    void DeckKeyword::setPlaceholder(size_t offset, size_t length, size_t records) {
+        m_placeholder = true;
+        m_inputOffset = offset;
+        m_inputLength = length;
+        m_skippedRecords = records;
+    }
+
+    size_t DeckKeyword::getInputOffset() const {
+        return m_inputOffset;
+    }
+
+    size_t DeckKeyword::getInputLength() const {
+        return m_inputLength;
+    }
+
+    size_t DeckKeyword::getSkippedRecords() const {
+        return m_skippedRecords;
+    }
+
 
     const std::string& DeckKeyword::name() const {
         return m_keywordName;
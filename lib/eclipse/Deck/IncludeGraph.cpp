@@ -0,0 +1,145 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+
+#include <opm/parser/eclipse/Deck/IncludeGraph.hpp>
+
+namespace Opm {
+
+    const size_t IncludeGraph::npos = -1;
+
+    size_t IncludeGraph::size() const {
+        return this->files.size();
+    }
+
+    bool IncludeGraph::empty() const {
+        return this->files.empty();
+    }
+
+    const IncludeGraph::File& IncludeGraph::operator[]( size_t index ) const {
+        return this->files.at( index );
+    }
+
+    IncludeGraph::File& IncludeGraph::operator[]( size_t index ) {
+        return this->files.at( index );
+    }
+
+    IncludeGraph::const_iterator IncludeGraph::begin() const {
+        return this->files.begin();
+    }
+
+    IncludeGraph::const_iterator IncludeGraph::end() const {
+        return this->files.end();
+    }
+
+    size_t IncludeGraph::add( File file ) {
+        this->files.push_back( std::move( file ) );
+        return this->files.size() - 1;
+    }
+
+    bool IncludeGraph::includes( size_t ancestor, size_t file ) const {
+        for( auto parent = this->files.at( file ).parent;
+             parent != npos;
+             parent = this->files[ parent ].parent ) {
+            if( parent == ancestor ) return true;
+        }
+
+        return false;
+    }
+
+    /* the files are in the order they were opened, so the included ones follow */
+    size_t IncludeGraph::last( size_t file ) const {
+        auto next = file + 1;
+        while( next < this->files.size() && this->includes( file, next ) )
+            ++next;
+
+        return next;
+    }
+
+    /*
+     * The sizes are unsigned, and the ranges after the file may move either
+     * way, so they are moved by subtracting the old size before adding the
+     * new one.
+     */
+    void IncludeGraph::replace( size_t file, const IncludeGraph& graph ) {
+        if( graph.empty() )
+            throw std::invalid_argument( "The replacement of a file must have a root file" );
+
+        const auto old = this->files.at( file );
+        const auto& root = graph.files.front();
+
+        const auto oldLast = this->last( file );
+        const auto oldFiles = oldLast - file;
+        const auto oldKeywords = old.lastKeyword - old.firstKeyword;
+        const auto oldMessages = old.lastMessage - old.firstMessage;
+        const auto newKeywords = root.lastKeyword - root.firstKeyword;
+        const auto newMessages = root.lastMessage - root.firstMessage;
+
+        for( size_t i = 0; i < file; ++i ) {
+            if( !this->includes( i, file ) ) continue;
+
+            auto& f = this->files[ i ];
+            f.lastKeyword = f.lastKeyword - oldKeywords + newKeywords;
+            f.lastMessage = f.lastMessage - oldMessages + newMessages;
+        }
+
+        for( size_t i = oldLast; i < this->files.size(); ++i ) {
+            auto& f = this->files[ i ];
+            f.firstKeyword = f.firstKeyword - oldKeywords + newKeywords;
+            f.lastKeyword = f.lastKeyword - oldKeywords + newKeywords;
+            f.firstMessage = f.firstMessage - oldMessages + newMessages;
+            f.lastMessage = f.lastMessage - oldMessages + newMessages;
+
+            if( f.parent != npos && f.parent >= oldLast )
+                f.parent = f.parent - oldFiles + graph.size();
+        }
+
+        std::vector< File > replacement;
+        for( const auto& g : graph.files ) {
+            replacement.push_back( g );
+            auto& f = replacement.back();
+
+            f.firstKeyword = f.firstKeyword - root.firstKeyword + old.firstKeyword;
+            f.lastKeyword = f.lastKeyword - root.firstKeyword + old.firstKeyword;
+            f.firstMessage = f.firstMessage - root.firstMessage + old.firstMessage;
+            f.lastMessage = f.lastMessage - root.firstMessage + old.firstMessage;
+            f.parent = f.parent == npos ? old.parent : f.parent + file;
+        }
+
+        this->files.erase( this->files.begin() + file, this->files.begin() + oldLast );
+        this->files.insert( this->files.begin() + file, replacement.begin(), replacement.end() );
+    }
+
+    std::vector< std::string > IncludeGraph::paths() const {
+        std::vector< std::string > result;
+        for( const auto& file : this->files )
+            result.push_back( file.path );
+
+        return result;
+    }
+
+    bool IncludeGraph::ended() const {
+        return this->m_ended;
+    }
+
+    void IncludeGraph::setEnded( bool ended ) {
+        this->m_ended = ended;
+    }
+}
@@ -32,33 +32,26 @@
 
 namespace Opm {
 
-    static bool isSectionDelimiter( const DeckKeyword& keyword ) {
-        const auto& name = keyword.name();
-        for( const auto& x : { "RUNSPEC", "GRID", "EDIT", "PROPS",
-                               "REGIONS", "SOLUTION", "SUMMARY", "SCHEDULE" } )
-            if( name == x ) return true;
-
-        return false;
-    }
-
-    static std::pair< DeckView::const_iterator, DeckView::const_iterator >
-    find_section( const Deck& deck, const std::string& keyword ) {
-
-        const auto fn = [&keyword]( const DeckKeyword& kw ) {
-            return kw.name() == keyword;
-        };
-
-        auto first = std::find_if( deck.begin(), deck.end(), fn );
-
-        if( first == deck.end() )
-            return { first, first };
-
-        auto last = std::find_if( first + 1, deck.end(), isSectionDelimiter );
-
-        if( last != deck.end() && last->name() == keyword )
+    /*
+     * The section is found with the index of the deck, from the first keyword
+     * with its name to the first section keyword after it, so making one does
+     * not look at the keywords of the deck.
+     */
+    DeckView Section::find_section( const Deck& deck, const std::string& keyword ) {
+        const DeckView& view = deck;
+        const auto first = view.position( keyword, 0 );
+        if( first == view.size() )
+            return DeckView( view, first, first );
+
+        auto last = view.size();
+        for( const auto& delimiter : { "RUNSPEC", "GRID", "EDIT", "PROPS",
+                                       "REGIONS", "SOLUTION", "SUMMARY", "SCHEDULE" } )
+            last = std::min( last, view.position( delimiter, first + 1 ) );
+
+        if( last != view.size() && view.getKeyword( last ).name() == keyword )
             throw std::invalid_argument( std::string( "Deck contains the '" ) + keyword + "' section multiple times" );
 
-        return { first, last };
+        return DeckView( view, first, last );
     }
 
     Section::Section( const Deck& deck, const std::string& section )
@@ -0,0 +1,42 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <functional>
+
+#include <opm/parser/eclipse/Deck/SymbolTable.hpp>
+
+namespace Opm {
+
+    const std::string* SymbolTable::intern( const std::string& value ) {
+        auto& part = this->table[ std::hash< std::string >()( value ) % stripes ];
+
+        std::lock_guard< std::mutex > guard( part.lock );
+        return &*part.symbols.insert( value ).first;
+    }
+
+    size_t SymbolTable::size() const {
+        size_t count = 0;
+        for( const auto& part : this->table ) {
+            std::lock_guard< std::mutex > guard( part.lock );
+            count += part.symbols.size();
+        }
+
+        return count;
+    }
+}
@@ -17,6 +17,7 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <stdexcept>
@@ -235,10 +236,15 @@ namespace Opm {
     template< typename T >
     void GridProperty< T >::loadFromDeckKeyword( const DeckKeyword& deckKeyword ) {
         const auto& deckItem = getDeckItem(deckKeyword);
-        const auto size = deckItem.size();
-        for (size_t dataPointIdx = 0; dataPointIdx < size; ++dataPointIdx) {
-            if (!deckItem.defaultApplied(dataPointIdx))
-                setDataPoint(dataPointIdx, dataPointIdx, deckItem);
+
+        /* the runs of N*value are filled without expanding them in the item */
+        size_t begin = 0;
+        for (size_t run = 0; run < deckItem.runCount(); ++run) {
+            const size_t end = deckItem.runEnd(run);
+            if (!deckItem.defaultApplied(begin))
+                setDataPoints(run, begin, end, deckItem);
+
+            begin = end;
         }
     }
 
@@ -380,6 +386,17 @@ void GridProperty<double>::setDataPoint(size_t sourceIdx, size_t targetIdx, cons
     m_data[targetIdx] = deckItem.getSIDouble(sourceIdx);
 }
 
+template<>
+void GridProperty<int>::setDataPoints(size_t run, size_t begin, size_t end, const DeckItem& deckItem) {
+    std::fill(m_data.begin() + begin, m_data.begin() + end, deckItem.runValue< int >(run));
+}
+
+/* the item of a grid property has a single dimension, so a run has a single SI value */
+template<>
+void GridProperty<double>::setDataPoints(size_t, size_t begin, size_t end, const DeckItem& deckItem) {
+    std::fill(m_data.begin() + begin, m_data.begin() + end, deckItem.getSIDouble(begin));
+}
+
 template<>
 bool GridProperty<int>::containsNaN( ) const {
     throw std::logic_error("Only <double> and can be meaningfully queried for nan");
@@ -18,6 +18,7 @@
 */
 
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -29,6 +30,7 @@
 #include <opm/json/JsonObject.hpp>
 #include <opm/parser/eclipse/Generator/KeywordGenerator.hpp>
 #include <opm/parser/eclipse/Generator/KeywordLoader.hpp>
+#include <opm/parser/eclipse/Parser/DeckNameIndex.hpp>
 #include <opm/parser/eclipse/Parser/ParserKeyword.hpp>
 
 
@@ -49,6 +51,7 @@ const std::string testHeader =
     "auto unitSystem =  UnitSystem::newMETRIC();\n";
 
 const std::string sourceHeader =
+    "#include <opm/parser/eclipse/Parser/DeckNameIndex.hpp>\n"
     "#include <opm/parser/eclipse/Parser/ParserKeyword.hpp>\n"
     "#include <opm/parser/eclipse/Parser/ParserItem.hpp>\n"
     "#include <opm/parser/eclipse/Parser/ParserRecord.hpp>\n"
@@ -125,11 +128,49 @@ namespace Opm {
 
         newSource << "void Parser::addDefaultKeywords() {" << std::endl
                   << "Opm::ParserKeywords::addDefaultKeywords(*this);" << std::endl
-                  << "}}" << std::endl;
+                  << "}" << std::endl;
+
+        newSource << deckNameHash( loader ) << "}" << std::endl;
 
         return write_file( newSource, sourceFile, m_verbose, "source" );
     }
 
+    /*
+      The perfect hash of the deck names of the default keywords, which the
+      parser looks the keywords up in. Longer deck names can not be hashed,
+      and are kept in a map by the parser.
+    */
+    std::string KeywordGenerator::deckNameHash(const KeywordLoader& loader) {
+        std::vector< std::string > names;
+        for( auto iter = loader.keyword_begin(); iter != loader.keyword_end(); ++iter ) {
+            const auto& keyword = *iter->second;
+            for( auto name = keyword.deckNamesBegin(); name != keyword.deckNamesEnd(); ++name ) {
+                uint64_t key;
+                if( DeckNameHash::pack( *name, key ) )
+                    names.push_back( *name );
+            }
+        }
+
+        const auto table = DeckNameHash::build( names );
+
+        std::stringstream stream;
+        stream << "const DeckNameHash& Parser::defaultDeckNames() {" << std::endl
+               << "static const DeckNameHash table( {";
+
+        for( size_t i = 0; i < table.displacements().size(); ++i )
+            stream << ( i % 16 == 0 ? "\n" : " " ) << table.displacements()[ i ] << "U,";
+
+        stream << "}, {" << std::hex;
+        for( size_t i = 0; i < table.keys().size(); ++i )
+            stream << ( i % 4 == 0 ? "\n" : " " ) << "0x" << table.keys()[ i ] << "ULL,";
+
+        stream << std::dec << "} );" << std::endl
+               << "return table;" << std::endl
+               << "}" << std::endl;
+
+        return stream.str();
+    }
+
     bool KeywordGenerator::updateHeader(const KeywordLoader& loader, const std::string& headerBuildPath, const std::string& headerFile) const {
         bool update = false;
 
@@ -0,0 +1,786 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+#if !defined(WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <boost/filesystem.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckItem.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/DeckRecord.hpp>
+#include <opm/parser/eclipse/Deck/IncludeGraph.hpp>
+#include <opm/parser/eclipse/Parser/DeckCache.hpp>
+#include <opm/parser/eclipse/Parser/MessageContainer.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Units/Dimension.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+namespace Opm {
+
+namespace {
+
+    /*
+     * Bump the version whenever the layout of an entry changes. Entries
+     * written on a machine with another byte order are rejected by the byte
+     * order mark.
+     */
+    const char magic[ 8 ] = { 'O', 'P', 'M', 'D', 'E', 'C', 'K', '\0' };
+    const uint32_t format_version = 6;
+    const uint32_t byte_order_mark = 0x01020304;
+
+    const uint64_t prime1 = 0x9e3779b185ebca87ULL;
+    const uint64_t prime2 = 0xc2b2ae3d27d4eb4fULL;
+    const uint64_t prime3 = 0x165667b19e3779f9ULL;
+
+    inline uint64_t rotl( uint64_t x, int r ) {
+        return ( x << r ) | ( x >> ( 64 - r ) );
+    }
+
+    inline uint64_t fmix( uint64_t x ) {
+        x ^= x >> 33;
+        x *= prime2;
+        x ^= x >> 29;
+        x *= prime3;
+        x ^= x >> 32;
+        return x;
+    }
+
+    /*
+     * A single lane of xxhash64 in spirit: the input is consumed eight bytes
+     * at a time, so hashing the included files costs about as much as
+     * reading them.
+     */
+    class hasher {
+        public:
+            explicit hasher( uint64_t seed = 0 ) : state( seed + prime3 ) {}
+
+            void update( const char* data, size_t size );
+            uint64_t digest() const;
+
+        private:
+            void word( const char* data );
+
+            uint64_t state;
+            uint64_t length = 0;
+            char tail[ 8 ];
+            size_t fill = 0;
+    };
+
+    void hasher::word( const char* data ) {
+        uint64_t w;
+        std::memcpy( &w, data, sizeof( w ) );
+        this->state ^= rotl( w * prime2, 31 ) * prime1;
+        this->state = rotl( this->state, 27 ) * prime1 + prime3;
+    }
+
+    void hasher::update( const char* data, size_t size ) {
+        this->length += size;
+
+        if( this->fill > 0 ) {
+            const size_t take = std::min( size, sizeof( this->tail ) - this->fill );
+            std::memcpy( this->tail + this->fill, data, take );
+            this->fill += take;
+            data += take;
+            size -= take;
+
+            if( this->fill < sizeof( this->tail ) ) return;
+
+            this->word( this->tail );
+            this->fill = 0;
+        }
+
+        for( ; size >= 8; data += 8, size -= 8 )
+            this->word( data );
+
+        std::memcpy( this->tail, data, size );
+        this->fill = size;
+    }
+
+    uint64_t hasher::digest() const {
+        uint64_t h = this->state ^ this->length;
+        for( size_t i = 0; i < this->fill; ++i )
+            h = rotl( h ^ ( uint64_t( static_cast< unsigned char >( this->tail[ i ] ) ) * prime3 ), 11 ) * prime1;
+
+        return fmix( h );
+    }
+
+    void update( hasher& h, const std::string& str ) {
+        const uint64_t size = str.size();
+        h.update( reinterpret_cast< const char* >( &size ), sizeof( size ) );
+        h.update( str.data(), str.size() );
+    }
+
+    /*
+     * The content hash of the file, or false if it cannot be read.
+     */
+    bool hash_file( const std::string& path, uint64_t& digest ) {
+        std::ifstream stream( path, std::ios::binary );
+        if( !stream ) return false;
+
+        hasher h;
+        std::vector< char > buffer( 1 << 20 );
+        while( stream ) {
+            stream.read( buffer.data(), buffer.size() );
+            h.update( buffer.data(), stream.gcount() );
+        }
+
+        if( stream.bad() ) return false;
+
+        digest = h.digest();
+        return true;
+    }
+
+    /*
+     * The state of an input file when the deck was parsed. A file that did not
+     * exist is recorded as well, so that the entry is stale once it does.
+     */
+    struct file_state {
+        std::string path;
+        bool exists = false;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t digest = 0;
+    };
+
+    bool stat_file( const std::string& path, file_state& st ) {
+        boost::system::error_code ec;
+        st.path = path;
+        st.exists = boost::filesystem::is_regular_file( path, ec );
+        if( ec || !st.exists ) {
+            st.exists = false;
+            return true;
+        }
+
+        st.size = boost::filesystem::file_size( path, ec );
+        if( ec ) return false;
+
+        st.mtime = boost::filesystem::last_write_time( path, ec );
+        return !ec;
+    }
+
+}
+
+    class DeckCache::writer {
+        public:
+            template< typename T >
+            void put( T x ) {
+                static_assert( std::is_arithmetic< T >::value, "Only numbers are written raw" );
+                this->buffer.append( reinterpret_cast< const char* >( &x ), sizeof( x ) );
+            }
+
+            template< typename T >
+            void put( const std::vector< T >& xs ) {
+                static_assert( std::is_arithmetic< T >::value, "Only numbers are written raw" );
+                this->put< uint64_t >( xs.size() );
+                this->buffer.append( reinterpret_cast< const char* >( xs.data() ), xs.size() * sizeof( T ) );
+            }
+
+            void put( const std::string& str ) {
+                this->put< uint64_t >( str.size() );
+                this->buffer.append( str );
+            }
+
+            void put( const std::vector< std::string >& xs ) {
+                this->put< uint64_t >( xs.size() );
+                for( const auto& x : xs ) this->put( x );
+            }
+
+            void put( const std::vector< const std::string* >& xs ) {
+                this->put< uint64_t >( xs.size() );
+                for( const auto* x : xs ) this->put( *x );
+            }
+
+            const std::string& data() const { return this->buffer; }
+
+        private:
+            std::string buffer;
+    };
+
+    /*
+     * Reading past the end of the entry throws, which is caught by load() and
+     * treated as a corrupt entry.
+     */
+    class DeckCache::reader {
+        public:
+            reader( const char* first, const char* last ) : pos( first ), end( last ) {}
+
+            template< typename T >
+            T get() {
+                static_assert( std::is_arithmetic< T >::value, "Only numbers are read raw" );
+                T x;
+                std::memcpy( &x, this->take( sizeof( x ) ), sizeof( x ) );
+                return x;
+            }
+
+            template< typename T >
+            void get( std::vector< T >& xs ) {
+                static_assert( std::is_arithmetic< T >::value, "Only numbers are read raw" );
+                const auto size = this->get< uint64_t >();
+                if( size > size_t( this->end - this->pos ) / sizeof( T ) )
+                    throw std::out_of_range( "Deck cache entry is truncated" );
+
+                xs.resize( size );
+                std::memcpy( xs.data(), this->take( size * sizeof( T ) ), size * sizeof( T ) );
+            }
+
+            std::string get_string() {
+                const auto size = this->get< uint64_t >();
+                return std::string( this->take( size ), size );
+            }
+
+            void get( std::vector< std::string >& xs ) {
+                const auto size = this->get< uint64_t >();
+                xs.clear();
+                xs.reserve( std::min< uint64_t >( size, this->end - this->pos ) );
+                for( uint64_t i = 0; i < size; ++i )
+                    xs.push_back( this->get_string() );
+            }
+
+            bool done() const { return this->pos == this->end; }
+
+        private:
+            const char* take( uint64_t size ) {
+                if( size > uint64_t( this->end - this->pos ) )
+                    throw std::out_of_range( "Deck cache entry is truncated" );
+
+                const char* first = this->pos;
+                this->pos += size;
+                return first;
+            }
+
+            const char* pos;
+            const char* end;
+    };
+
+    void DeckCache::writeDimension( writer& out, const Dimension& dim ) {
+        out.put( dim.getName() );
+        out.put( dim.m_SIfactor );
+        out.put( dim.getSIOffset() );
+    }
+
+    Dimension DeckCache::readDimension( reader& in ) {
+        auto name = in.get_string();
+        const auto factor = in.get< double >();
+        const auto offset = in.get< double >();
+        return Dimension::newComposite( name, factor, offset );
+    }
+
+    void DeckCache::writeUnits( writer& out, const UnitSystem& units ) {
+        out.put( static_cast< int32_t >( units.getType() ) );
+
+        const auto& dims = units.m_dimensions;
+        out.put< uint64_t >( dims.size() );
+        for( const auto& dim : dims )
+            writeDimension( out, dim.second );
+    }
+
+    UnitSystem DeckCache::readUnits( reader& in ) {
+        const auto type = static_cast< UnitSystem::UnitType >( in.get< int32_t >() );
+
+        UnitSystem units;
+        switch( type ) {
+            case UnitSystem::UnitType::UNIT_TYPE_METRIC: units = UnitSystem::newMETRIC(); break;
+            case UnitSystem::UnitType::UNIT_TYPE_FIELD:  units = UnitSystem::newFIELD(); break;
+            case UnitSystem::UnitType::UNIT_TYPE_LAB:    units = UnitSystem::newLAB(); break;
+            case UnitSystem::UnitType::UNIT_TYPE_PVT_M:  units = UnitSystem::newPVT_M(); break;
+            default: throw std::invalid_argument( "Unknown unit system in deck cache entry" );
+        }
+
+        const auto size = in.get< uint64_t >();
+        for( uint64_t i = 0; i < size; ++i )
+            units.addDimension( readDimension( in ) );
+
+        return units;
+    }
+
+    void DeckCache::writeMessages( writer& out, const MessageContainer& messages ) {
+        out.put< uint64_t >( messages.size() );
+        for( const auto& msg : messages ) {
+            out.put( static_cast< int32_t >( msg.mtype ) );
+            out.put( msg.message );
+            out.put( msg.location.filename );
+            out.put< uint64_t >( msg.location.lineno );
+        }
+    }
+
+    /*
+     * The include graph is kept with the deck, so that the files of a deck
+     * read from the cache can be parsed again, and their placeholders checked
+     * against the stamps of the files.
+     */
+    void DeckCache::writeGraph( writer& out, const IncludeGraph& graph ) {
+        out.put< uint8_t >( graph.ended() );
+        out.put< uint64_t >( graph.size() );
+        for( const auto& file : graph ) {
+            out.put( file.path );
+            out.put< uint64_t >( file.parent );
+            out.put< uint64_t >( file.firstKeyword );
+            out.put< uint64_t >( file.lastKeyword );
+            out.put< uint64_t >( file.firstMessage );
+            out.put< uint64_t >( file.lastMessage );
+
+            out.put< uint64_t >( file.aliases.size() );
+            for( const auto& alias : file.aliases ) {
+                out.put( alias.first );
+                out.put( alias.second );
+            }
+
+            out.put( std::vector< std::string >( file.sizedBy.begin(), file.sizedBy.end() ) );
+            out.put< uint8_t >( file.paths );
+            out.put< uint8_t >( file.spans );
+
+            out.put< uint8_t >( file.stamp.valid );
+            out.put( file.stamp.size );
+            out.put( file.stamp.mtime );
+            out.put( file.stamp.digest );
+        }
+    }
+
+    void DeckCache::readGraph( reader& in, IncludeGraph& graph ) {
+        graph.setEnded( in.get< uint8_t >() );
+
+        const auto size = in.get< uint64_t >();
+        for( uint64_t i = 0; i < size; ++i ) {
+            IncludeGraph::File file;
+            file.path = in.get_string();
+            file.parent = in.get< uint64_t >();
+            file.firstKeyword = in.get< uint64_t >();
+            file.lastKeyword = in.get< uint64_t >();
+            file.firstMessage = in.get< uint64_t >();
+            file.lastMessage = in.get< uint64_t >();
+
+            const auto aliases = in.get< uint64_t >();
+            for( uint64_t j = 0; j < aliases; ++j ) {
+                auto alias = in.get_string();
+                file.aliases[ alias ] = in.get_string();
+            }
+
+            std::vector< std::string > sizedBy;
+            in.get( sizedBy );
+            file.sizedBy.insert( sizedBy.begin(), sizedBy.end() );
+            file.paths = in.get< uint8_t >();
+            file.spans = in.get< uint8_t >();
+
+            file.stamp.valid = in.get< uint8_t >();
+            file.stamp.size = in.get< uint64_t >();
+            file.stamp.mtime = in.get< int64_t >();
+            file.stamp.digest = in.get< uint64_t >();
+
+            graph.add( std::move( file ) );
+        }
+    }
+
+    void DeckCache::readMessages( reader& in, MessageContainer& messages ) {
+        const auto size = in.get< uint64_t >();
+        for( uint64_t i = 0; i < size; ++i ) {
+            const auto type = static_cast< Message::type >( in.get< int32_t >() );
+            auto text = in.get_string();
+            auto filename = in.get_string();
+            const auto lineno = in.get< uint64_t >();
+
+            if( lineno == 0 )
+                messages.add( Message( type, text ) );
+            else
+                messages.add( Message( type, text, Location( filename, lineno ) ) );
+        }
+    }
+
+    /*
+     * A file modified within the resolution of the file system's clock after
+     * it was parsed can not be told apart by its time, so a file whose time
+     * is that close to when the entry was written is always hashed.
+     */
+    bool DeckCache::readManifest( reader& in ) {
+        const auto written = in.get< int64_t >();
+        const auto size = in.get< uint64_t >();
+
+        for( uint64_t i = 0; i < size; ++i ) {
+            file_state recorded;
+            recorded.path = in.get_string();
+            recorded.exists = in.get< uint8_t >();
+            recorded.size = in.get< uint64_t >();
+            recorded.mtime = in.get< int64_t >();
+            recorded.digest = in.get< uint64_t >();
+
+            file_state current;
+            if( !stat_file( recorded.path, current ) ) return false;
+            if( current.exists != recorded.exists ) return false;
+            if( !current.exists ) continue;
+            if( current.size != recorded.size ) return false;
+
+            if( current.mtime == recorded.mtime && current.mtime + 1 < written )
+                continue;
+
+            if( !hash_file( recorded.path, current.digest ) ) return false;
+            if( current.digest != recorded.digest ) return false;
+        }
+
+        return true;
+    }
+
+    /*
+     * The items are written with their raw storage, so that the data of the
+     * big grid properties are copied straight in and out of the entry, with
+     * the N*value runs still unexpanded.
+     */
+    void DeckCache::writeItem( writer& out, const DeckItem& item ) {
+        out.put( item.name() );
+        out.put( static_cast< int32_t >( item.type ) );
+
+        switch( item.type ) {
+            case type_tag::integer: out.put( item.ival ); break;
+            case type_tag::fdouble: out.put( item.dval ); break;
+            case type_tag::string:  out.put( item.sval ); break;
+            default: break;
+        }
+
+        std::vector< uint32_t > runs;
+        for( const auto& run : item.default_runs ) {
+            runs.push_back( run.first );
+            runs.push_back( run.second );
+        }
+
+        out.put( runs );
+        out.put( item.run_ends );
+        out.put< uint8_t >( item.si_converted );
+
+        out.put< uint64_t >( item.dimensions.size() );
+        for( const auto* dim : item.dimensions )
+            writeDimension( out, *dim );
+    }
+
+    DeckItem DeckCache::readItem( reader& in, const std::shared_ptr< SymbolTable >& symbols ) {
+        const auto name = in.get_string();
+        const auto type = static_cast< type_tag >( in.get< int32_t >() );
+
+        DeckItem item( name );
+        switch( type ) {
+            case type_tag::unknown: break;
+            case type_tag::integer: item = DeckItem( name, int(), 0 ); in.get( item.ival ); break;
+            case type_tag::fdouble: item = DeckItem( name, double(), 0 ); in.get( item.dval ); break;
+            case type_tag::string:  item = DeckItem( name, std::string(), 0, symbols ); break;
+            default: throw std::invalid_argument( "Unknown item type in deck cache entry" );
+        }
+
+        /* the strings are written spelled out, and interned in the deck when read */
+        if( type == type_tag::string ) {
+            std::vector< std::string > values;
+            in.get( values );
+            for( const auto& value : values ) item.sval.push_back( item.store( value ) );
+        }
+
+        std::vector< uint32_t > runs;
+        in.get( runs );
+        if( runs.size() % 2 != 0 )
+            throw std::invalid_argument( "Corrupt default runs in deck cache entry" );
+
+        item.default_runs.reserve( runs.size() / 2 );
+        for( size_t i = 0; i < runs.size(); i += 2 )
+            item.default_runs.emplace_back( runs[ i ], runs[ i + 1 ] );
+
+        in.get( item.run_ends );
+        if( !item.run_ends.empty() && item.run_ends.size() != item.value_count() )
+            throw std::invalid_argument( "Corrupt value runs in deck cache entry" );
+
+        item.si_converted = in.get< uint8_t >();
+
+        const auto dims = in.get< uint64_t >();
+        item.dimensions.reserve( std::min< uint64_t >( dims, 1 << 10 ) );
+        for( uint64_t i = 0; i < dims; ++i )
+            item.dimensions.push_back( DeckItem::shared( readDimension( in ) ) );
+
+        return item;
+    }
+
+    void DeckCache::writeKeyword( writer& out, const DeckKeyword& keyword ) {
+        out.put( keyword.m_keywordName );
+        out.put( keyword.getFileName() );
+        out.put< int32_t >( keyword.m_lineNumber );
+        out.put< uint8_t >( keyword.m_knownKeyword );
+        out.put< uint8_t >( keyword.m_isDataKeyword );
+        out.put< uint8_t >( keyword.m_slashTerminated );
+        out.put< uint8_t >( keyword.m_placeholder );
+        out.put< uint64_t >( keyword.m_inputOffset );
+        out.put< uint64_t >( keyword.m_inputLength );
+        out.put< uint64_t >( keyword.m_skippedRecords );
+
+        out.put< uint64_t >( keyword.size() );
+        for( const auto& record : keyword ) {
+            out.put< uint64_t >( record.size() );
+            for( const auto& item : record )
+                writeItem( out, item );
+        }
+    }
+
+    DeckKeyword DeckCache::readKeyword( reader& in, const Deck& deck ) {
+        auto name = in.get_string();
+        auto filename = in.get_string();
+        const auto lineno = in.get< int32_t >();
+        const bool known = in.get< uint8_t >();
+
+        DeckKeyword keyword( name, known );
+        keyword.setLocation( deck.getSourceNames(), deck.getSourceNames()->intern( filename ), lineno );
+        keyword.m_isDataKeyword = in.get< uint8_t >();
+        keyword.m_slashTerminated = in.get< uint8_t >();
+        keyword.m_placeholder = in.get< uint8_t >();
+        keyword.m_inputOffset = in.get< uint64_t >();
+        keyword.m_inputLength = in.get< uint64_t >();
+        keyword.m_skippedRecords = in.get< uint64_t >();
+
+        const auto records = in.get< uint64_t >();
+        keyword.m_recordList.reserve( std::min< uint64_t >( records, 1 << 20 ) );
+        for( uint64_t r = 0; r < records; ++r ) {
+            const auto size = in.get< uint64_t >();
+            std::vector< DeckItem > items;
+            items.reserve( std::min< uint64_t >( size, 1 << 10 ) );
+            for( uint64_t i = 0; i < size; ++i )
+                items.push_back( readItem( in, deck.getSymbols() ) );
+
+            keyword.addRecord( DeckRecord( std::move( items ) ) );
+        }
+
+        return keyword;
+    }
+
+    DeckCache::DeckCache( const std::string& dir, uint64_t kwHash ) :
+        directory( dir ),
+        keywordHash( kwHash )
+    {}
+
+    uint64_t DeckCache::hash( const char* data, size_t size, uint64_t seed ) {
+        hasher h( seed );
+        h.update( data, size );
+        return h.digest();
+    }
+
+    uint64_t DeckCache::hash( const ParseContext& context, uint64_t seed ) {
+        hasher h( seed );
+        for( const auto& setting : context ) {
+            const int32_t action = setting.second;
+            update( h, setting.first );
+            h.update( reinterpret_cast< const char* >( &action ), sizeof( action ) );
+        }
+
+        return h.digest();
+    }
+
+    std::string DeckCache::entryPath( const std::string& rootFile, const ParseContext& context ) const {
+        boost::system::error_code ec;
+        const auto root = boost::filesystem::canonical( rootFile, ec );
+        if( ec ) return "";
+
+        hasher h( hash( context, this->keywordHash ) );
+        h.update( reinterpret_cast< const char* >( &format_version ), sizeof( format_version ) );
+        update( h, root.string() );
+
+        std::stringstream name;
+        name << std::hex << std::setw( 16 ) << std::setfill( '0' ) << h.digest() << ".deck";
+        return ( boost::filesystem::path( this->directory ) / name.str() ).string();
+    }
+
+    bool DeckCache::readEntry( const std::string& rootFile,
+                               uint64_t context,
+                               const char* begin,
+                               const char* end,
+                               Deck& deck ) {
+        reader in( begin, end );
+
+        char header[ sizeof( magic ) ];
+        for( auto& c : header ) c = in.get< char >();
+        if( !std::equal( header, header + sizeof( header ), magic ) ) return false;
+        if( in.get< uint32_t >() != format_version ) return false;
+        if( in.get< uint32_t >() != byte_order_mark ) return false;
+        if( in.get< uint64_t >() != context ) return false;
+
+        boost::system::error_code ec;
+        const auto root = boost::filesystem::canonical( rootFile, ec );
+        if( ec || in.get_string() != root.string() ) return false;
+
+        if( !readManifest( in ) ) return false;
+
+        deck.setDataFile( in.get_string() );
+        deck.getDefaultUnitSystem() = readUnits( in );
+        deck.getActiveUnitSystem() = readUnits( in );
+        readMessages( in, deck.getMessageContainer() );
+        readGraph( in, deck.getIncludeGraph() );
+
+        const auto keywords = in.get< uint64_t >();
+        for( uint64_t i = 0; i < keywords; ++i )
+            deck.addKeyword( readKeyword( in, deck ) );
+
+        return in.done();
+    }
+
+    bool DeckCache::load( const std::string& rootFile, const ParseContext& context, Deck& deck ) const {
+        const auto path = this->entryPath( rootFile, context );
+        if( path.empty() ) return false;
+
+        return this->loadEntry( path, rootFile, context, deck );
+    }
+
+    bool DeckCache::loadEntry( const std::string& path,
+                               const std::string& rootFile,
+                               const ParseContext& context,
+                               Deck& deck ) const {
+        const auto contextHash = hash( context, this->keywordHash );
+
+        try {
+#if !defined(WIN32)
+            const int fd = ::open( path.c_str(), O_RDONLY );
+            if( fd < 0 ) return false;
+
+            struct stat st;
+            void* ptr = MAP_FAILED;
+            size_t size = 0;
+            if( ::fstat( fd, &st ) == 0 && st.st_size > 0 ) {
+                size = st.st_size;
+                ptr = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            }
+            ::close( fd );
+            if( ptr == MAP_FAILED ) return false;
+
+            ::madvise( ptr, size, MADV_SEQUENTIAL );
+            const auto* begin = static_cast< const char* >( ptr );
+
+            bool loaded = false;
+            try {
+                loaded = readEntry( rootFile, contextHash, begin, begin + size, deck );
+            } catch( ... ) {
+                ::munmap( ptr, size );
+                throw;
+            }
+
+            ::munmap( ptr, size );
+            return loaded;
+#else
+            std::ifstream stream( path, std::ios::binary );
+            if( !stream ) return false;
+
+            const std::string content( ( std::istreambuf_iterator< char >( stream ) ),
+                                       std::istreambuf_iterator< char >() );
+            return readEntry( rootFile, contextHash, content.data(), content.data() + content.size(), deck );
+#endif
+        } catch( ... ) {
+            return false;
+        }
+    }
+
+    void DeckCache::store( const std::string& rootFile,
+                           const ParseContext& context,
+                           const IncludeGraph& files,
+                           const Deck& deck ) const {
+        const auto path = this->entryPath( rootFile, context );
+        if( path.empty() ) return;
+
+        this->storeEntry( path, rootFile, context, files, deck );
+    }
+
+    void DeckCache::storeEntry( const std::string& path,
+                                const std::string& rootFile,
+                                const ParseContext& context,
+                                const IncludeGraph& files,
+                                const Deck& deck ) const {
+        try {
+            std::vector< file_state > manifest;
+            for( const auto& file : files ) {
+                if( std::any_of( manifest.begin(), manifest.end(),
+                                 [&file]( const file_state& st ) { return st.path == file.path; } ) )
+                    continue;
+
+                file_state st;
+                if( file.stamp.valid ) {
+                    st.path = file.path;
+                    st.exists = true;
+                    st.size = file.stamp.size;
+                    st.mtime = file.stamp.mtime;
+                    st.digest = file.stamp.digest;
+                } else {
+                    if( !stat_file( file.path, st ) ) return;
+                    if( st.exists && !hash_file( file.path, st.digest ) ) return;
+                }
+
+                manifest.push_back( std::move( st ) );
+            }
+
+            writer out;
+            for( const char c : magic ) out.put( c );
+            out.put( format_version );
+            out.put( byte_order_mark );
+            out.put( hash( context, this->keywordHash ) );
+            out.put( boost::filesystem::canonical( rootFile ).string() );
+            out.put< int64_t >( std::time( nullptr ) );
+            out.put< uint64_t >( manifest.size() );
+            for( const auto& file : manifest ) {
+                out.put( file.path );
+                out.put< uint8_t >( file.exists );
+                out.put( file.size );
+                out.put( file.mtime );
+                out.put( file.digest );
+            }
+
+            out.put( deck.getDataFile() );
+            writeUnits( out, deck.getDefaultUnitSystem() );
+            writeUnits( out, deck.getActiveUnitSystem() );
+            writeMessages( out, deck.getMessageContainer() );
+            writeGraph( out, deck.getIncludeGraph() );
+
+            out.put< uint64_t >( deck.size() );
+            for( const auto& keyword : deck )
+                writeKeyword( out, keyword );
+
+            /*
+             * Write to a temporary file which is then renamed, so that a
+             * concurrent parse of the same deck never sees half an entry.
+             */
+            const auto parent = boost::filesystem::path( path ).parent_path();
+            if( !parent.empty() )
+                boost::filesystem::create_directories( parent );
+
+            const auto tmp = parent / boost::filesystem::unique_path( "%%%%-%%%%-%%%%-%%%%.tmp" );
+            {
+                std::ofstream stream( tmp.string(), std::ios::binary );
+                stream.write( out.data().data(), out.data().size() );
+                if( !stream ) {
+                    stream.close();
+                    boost::filesystem::remove( tmp );
+                    return;
+                }
+            }
+
+            boost::filesystem::rename( tmp, path );
+        } catch( ... ) {
+            /* a deck that could not be cached is parsed again next time */
+        }
+    }
+}
@@ -0,0 +1,250 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include <opm/parser/eclipse/Parser/DeckNameIndex.hpp>
+#include <opm/parser/eclipse/Parser/ParserKeyword.hpp>
+
+namespace Opm {
+
+    const size_t DeckNameHash::npos;
+
+    DeckNameHash::DeckNameHash( std::vector< uint32_t > displacements,
+                                std::vector< uint64_t > keys ) :
+        m_displacements( std::move( displacements ) ),
+        m_keys( std::move( keys ) )
+    {
+        const auto power_of_two = []( size_t x ) {
+            return x > 0 && ( x & ( x - 1 ) ) == 0;
+        };
+
+        if( !power_of_two( m_displacements.size() ) || !power_of_two( m_keys.size() ) )
+            throw std::invalid_argument( "The deck name hash tables must have a power of two size" );
+    }
+
+    DeckNameHash DeckNameHash::build( const std::vector< std::string >& names ) {
+        std::vector< uint64_t > packed;
+        for( const auto& name : names ) {
+            uint64_t key;
+            if( !pack( name, key ) )
+                throw std::invalid_argument( "Deck name '" + name + "' is not 1-8 characters" );
+
+            packed.push_back( key );
+        }
+
+        std::sort( packed.begin(), packed.end() );
+        packed.erase( std::unique( packed.begin(), packed.end() ), packed.end() );
+
+        /*
+         * With a load factor of at most 0.8, and four names per bucket on
+         * average, a displacement is found after a handful of attempts.
+         */
+        size_t num_slots = 1;
+        while( 5 * packed.size() > 4 * num_slots ) num_slots *= 2;
+
+        size_t num_buckets = 1;
+        while( packed.size() > 4 * num_buckets ) num_buckets *= 2;
+
+        DeckNameHash table( std::vector< uint32_t >( num_buckets, 0 ),
+                            std::vector< uint64_t >( num_slots, 0 ) );
+
+        std::vector< std::vector< uint64_t > > buckets( num_buckets );
+        for( const auto key : packed )
+            buckets[ table.bucket( key ) ].push_back( key );
+
+        /* place the largest buckets first, while there is still room */
+        std::vector< size_t > order( num_buckets );
+        for( size_t i = 0; i < num_buckets; ++i ) order[ i ] = i;
+        std::stable_sort( order.begin(), order.end(), [&]( size_t lhs, size_t rhs ) {
+            return buckets[ lhs ].size() > buckets[ rhs ].size();
+        } );
+
+        const uint32_t max_displacement = 1 << 24;
+        std::vector< size_t > positions;
+        for( const auto b : order ) {
+            const auto& bucket = buckets[ b ];
+            if( bucket.empty() ) break;
+
+            uint32_t displacement = 0;
+            for( ; displacement < max_displacement; ++displacement ) {
+                positions.clear();
+                for( const auto key : bucket ) {
+                    const auto pos = table.slot( key, displacement );
+                    if( table.m_keys[ pos ] != 0 ) break;
+                    if( std::find( positions.begin(), positions.end(), pos ) != positions.end() ) break;
+                    positions.push_back( pos );
+                }
+
+                if( positions.size() == bucket.size() ) break;
+            }
+
+            if( displacement == max_displacement )
+                throw std::runtime_error( "Unable to build a perfect hash of the deck names" );
+
+            table.m_displacements[ b ] = displacement;
+            for( size_t i = 0; i < bucket.size(); ++i )
+                table.m_keys[ positions[ i ] ] = bucket[ i ];
+        }
+
+        return table;
+    }
+
+    std::string DeckNameHash::unpack( uint64_t key ) {
+        std::string name;
+        for( ; key != 0; key >>= 8 )
+            name.push_back( char( key & 0xff ) );
+
+        return name;
+    }
+
+    size_t DeckNameHash::slots() const {
+        return this->m_keys.size();
+    }
+
+    const std::vector< uint32_t >& DeckNameHash::displacements() const {
+        return this->m_displacements;
+    }
+
+    const std::vector< uint64_t >& DeckNameHash::keys() const {
+        return this->m_keys;
+    }
+
+
+    DeckNamePrefixes::DeckNamePrefixes() :
+        nodes( 1 )
+    {}
+
+    void DeckNamePrefixes::clear() {
+        this->nodes.assign( 1, node() );
+    }
+
+    void DeckNamePrefixes::add( const std::string& regex, const ParserKeyword* keyword ) {
+        for( const auto& prefix : literalPrefixes( regex ) ) {
+            size_t current = 0;
+            for( const char c : prefix ) {
+                auto& next = this->nodes[ current ].next;
+                auto child = std::find_if( next.begin(), next.end(),
+                                           [c]( const std::pair< char, size_t >& x ) {
+                                               return x.first == c;
+                                           } );
+
+                if( child != next.end() ) {
+                    current = child->second;
+                    continue;
+                }
+
+                next.emplace_back( c, this->nodes.size() );
+                this->nodes.emplace_back();
+                current = this->nodes.size() - 1;
+            }
+
+            auto& keywords = this->nodes[ current ].keywords;
+            if( std::find( keywords.begin(), keywords.end(), keyword ) == keywords.end() )
+                keywords.push_back( keyword );
+        }
+    }
+
+    const ParserKeyword* DeckNamePrefixes::match( const string_view& name ) const {
+        const ParserKeyword* best = nullptr;
+
+        const auto try_node = [&]( const node& n ) {
+            for( const auto* keyword : n.keywords ) {
+                if( best && best->getName() < keyword->getName() ) continue;
+                if( keyword->matches( name ) ) best = keyword;
+            }
+        };
+
+        size_t current = 0;
+        try_node( this->nodes[ current ] );
+
+        for( const char c : name ) {
+            const auto& next = this->nodes[ current ].next;
+            auto child = std::find_if( next.begin(), next.end(),
+                                       [c]( const std::pair< char, size_t >& x ) {
+                                           return x.first == c;
+                                       } );
+
+            if( child == next.end() ) break;
+
+            current = child->second;
+            try_node( this->nodes[ current ] );
+        }
+
+        return best;
+    }
+
+    /*
+     * The literal prefix of every top-level alternative of the regular
+     * expression. A literal followed by a quantifier that allows zero
+     * repetitions is not part of the prefix, and anything but a plain
+     * character ends it.
+     */
+    std::vector< std::string > DeckNamePrefixes::literalPrefixes( const std::string& regex ) {
+        std::vector< std::string > alternatives( 1 );
+        int depth = 0;
+        bool in_class = false;
+
+        for( size_t i = 0; i < regex.size(); ++i ) {
+            const char c = regex[ i ];
+            auto& current = alternatives.back();
+
+            if( c == '\\' ) {
+                current += c;
+                if( i + 1 < regex.size() ) current += regex[ ++i ];
+                continue;
+            }
+
+            if( in_class ) in_class = c != ']';
+            else if( c == '[' ) in_class = true;
+            else if( c == '(' ) ++depth;
+            else if( c == ')' ) --depth;
+            else if( c == '|' && depth == 0 ) {
+                alternatives.emplace_back();
+                continue;
+            }
+
+            current += c;
+        }
+
+        const auto literal = []( char c ) {
+            return std::isalnum( static_cast< unsigned char >( c ) ) || c == '_' || c == '-';
+        };
+
+        const auto optional = []( char c ) {
+            return c == '?' || c == '*' || c == '{';
+        };
+
+        std::vector< std::string > prefixes;
+        for( const auto& alternative : alternatives ) {
+            std::string prefix;
+            for( size_t i = 0; i < alternative.size(); ++i ) {
+                if( !literal( alternative[ i ] ) ) break;
+                if( i + 1 < alternative.size() && optional( alternative[ i + 1 ] ) ) break;
+                prefix += alternative[ i ];
+            }
+
+            prefixes.push_back( prefix );
+        }
+
+        return prefixes;
+    }
+}
@@ -0,0 +1,213 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+
+#include <boost/filesystem.hpp>
+
+#include <opm/parser/eclipse/Parser/DeckCache.hpp>
+#include <opm/parser/eclipse/Parser/IncludeCache.hpp>
+
+namespace Opm {
+
+namespace {
+
+    size_t weight( const IncludeCache::File& file ) {
+        size_t bytes = file.content ? file.content->size() : 0;
+        return bytes + file.size * file.keywords.size();
+    }
+
+}
+
+    /* about the input of a large field model, with the keywords of its grid */
+    const size_t IncludeCache::default_budget = size_t( 1 ) << 30;
+
+    IncludeCache::IncludeCache( size_t budget ) :
+        m_budget( budget )
+    {}
+
+    std::shared_ptr< IncludeCache > IncludeCache::global() {
+        static const auto cache = std::make_shared< IncludeCache >();
+        return cache;
+    }
+
+    std::shared_ptr< const IncludeCache::File > IncludeCache::find( const std::string& canonical ) {
+        std::shared_ptr< const File > file;
+        {
+            std::lock_guard< std::mutex > guard( this->lock );
+            const auto entry = this->files.find( canonical );
+            if( entry == this->files.end() ) return {};
+            file = entry->second.file;
+            this->touch( entry->second );
+        }
+
+        boost::system::error_code ec;
+        const auto size = boost::filesystem::file_size( canonical, ec );
+        if( ec || size != file->size ) return {};
+
+        const int64_t mtime = boost::filesystem::last_write_time( canonical, ec );
+        if( ec ) return {};
+
+        if( mtime == file->mtime && mtime + 1 < file->hashed )
+            return file;
+
+        std::ifstream stream( canonical, std::ios::binary );
+        const std::string raw( ( std::istreambuf_iterator< char >( stream ) ),
+                               std::istreambuf_iterator< char >() );
+        if( stream.bad() || raw.size() != size ) return {};
+        if( DeckCache::hash( raw.data(), raw.size() ) != file->digest ) return {};
+
+        /* touched, but not changed */
+        auto touched = std::make_shared< File >( *file );
+        touched->mtime = mtime;
+        touched->hashed = std::time( nullptr );
+
+        std::lock_guard< std::mutex > guard( this->lock );
+        const auto entry = this->files.find( canonical );
+        if( entry != this->files.end() && entry->second.file->digest == file->digest )
+            this->put( canonical, touched );
+
+        return touched;
+    }
+
+    std::shared_ptr< const IncludeCache::File > IncludeCache::insert( const std::string& canonical,
+                                                                      uint64_t size,
+                                                                      int64_t mtime,
+                                                                      uint64_t digest,
+                                                                      std::string&& content ) {
+        auto file = std::make_shared< File >();
+        file->path = canonical;
+        file->size = size;
+        file->mtime = mtime;
+        file->digest = digest;
+        file->hashed = std::time( nullptr );
+        file->content = std::make_shared< const std::string >( std::move( content ) );
+
+        std::lock_guard< std::mutex > guard( this->lock );
+        const auto entry = this->files.find( canonical );
+        if( entry != this->files.end() ) {
+            const auto& cached = entry->second.file;
+            if( cached->digest == digest && cached->size == size ) {
+                if( cached->content ) {
+                    this->touch( entry->second );
+                    return cached;
+                }
+
+                file->keywords = cached->keywords;
+            }
+        }
+
+        this->put( canonical, file );
+        return file;
+    }
+
+    /*
+     * Entries are never modified once they are in the cache, as they may be
+     * used by other parsers, so adding keywords replaces the entry by a copy.
+     */
+    void IncludeCache::addKeywords( const std::shared_ptr< const File >& file,
+                                    std::shared_ptr< const Keywords > keywords ) {
+        std::lock_guard< std::mutex > guard( this->lock );
+        auto entry = this->files.find( file->path );
+        if( entry == this->files.end() || entry->second.file->digest != file->digest )
+            return;
+
+        auto updated = std::make_shared< File >( *entry->second.file );
+        auto& variants = updated->keywords;
+        variants.erase( std::remove_if( variants.begin(), variants.end(),
+                                        [&keywords]( const std::shared_ptr< const Keywords >& kw ) {
+                                            return kw->context == keywords->context;
+                                        } ),
+                        variants.end() );
+        variants.push_back( std::move( keywords ) );
+        updated->content.reset();
+
+        this->put( file->path, std::move( updated ) );
+    }
+
+    std::shared_ptr< const IncludeCache::Keywords > IncludeCache::keywords( const File& file, uint64_t context ) {
+        for( const auto& kw : file.keywords )
+            if( kw->context == context ) return kw;
+
+        return {};
+    }
+
+    size_t IncludeCache::size() const {
+        std::lock_guard< std::mutex > guard( this->lock );
+        return this->files.size();
+    }
+
+    void IncludeCache::clear() {
+        std::lock_guard< std::mutex > guard( this->lock );
+        this->files.clear();
+        this->recent.clear();
+        this->total = 0;
+    }
+
+    size_t IncludeCache::bytes() const {
+        std::lock_guard< std::mutex > guard( this->lock );
+        return this->total;
+    }
+
+    size_t IncludeCache::budget() const {
+        std::lock_guard< std::mutex > guard( this->lock );
+        return this->m_budget;
+    }
+
+    void IncludeCache::setBudget( size_t budget ) {
+        std::lock_guard< std::mutex > guard( this->lock );
+        this->m_budget = budget;
+        this->evict();
+    }
+
+    void IncludeCache::put( const std::string& canonical, std::shared_ptr< const File > file ) {
+        auto entry = this->files.find( canonical );
+        if( entry == this->files.end() ) {
+            this->recent.push_front( canonical );
+            entry = this->files.emplace( canonical, Entry() ).first;
+            entry->second.used = this->recent.begin();
+        } else {
+            this->total -= entry->second.bytes;
+            this->touch( entry->second );
+        }
+
+        entry->second.bytes = weight( *file );
+        entry->second.file = std::move( file );
+        this->total += entry->second.bytes;
+
+        this->evict();
+    }
+
+    void IncludeCache::touch( Entry& entry ) {
+        this->recent.splice( this->recent.begin(), this->recent, entry.used );
+    }
+
+    /* a file bigger than the whole budget is evicted right away */
+    void IncludeCache::evict() {
+        while( this->total > this->m_budget ) {
+            const auto entry = this->files.find( this->recent.back() );
+            this->total -= entry->second.bytes;
+            this->files.erase( entry );
+            this->recent.pop_back();
+        }
+    }
+}
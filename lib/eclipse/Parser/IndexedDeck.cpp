@@ -0,0 +1,126 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <functional>
+#include <stdexcept>
+
+#include <opm/parser/eclipse/Deck/Section.hpp>
+#include <opm/parser/eclipse/Parser/DeckCache.hpp>
+#include <opm/parser/eclipse/Parser/IndexedDeck.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+
+namespace Opm {
+
+namespace {
+
+    /*
+     * The index file is an entry of the deck cache, with a manifest of the
+     * files of the deck, but kept next to the data file.
+     */
+    Deck read_index( const Parser& parser, const std::string& dataFile, const ParseContext& context ) {
+        const DeckCache cache( "", parser.getKeywordHash() );
+        const auto path = IndexedDeck::indexPath( dataFile );
+
+        {
+            Deck deck;
+            if( cache.loadEntry( path, dataFile, context, deck ) )
+                return deck;
+        }
+
+        auto deck = parser.indexFile( dataFile, context );
+        cache.storeEntry( path, dataFile, context, deck.getIncludeGraph(), deck );
+        return deck;
+    }
+
+}
+
+    IndexedDeck::IndexedDeck( const Parser& p,
+                              const std::string& dataFile,
+                              const ParseContext& context ) :
+        parser( p ),
+        parseContext( context ),
+        index( read_index( p, dataFile, context ) )
+    {}
+
+    const Deck& IndexedDeck::getIndex() const {
+        return this->index;
+    }
+
+    size_t IndexedDeck::size() const {
+        return this->index.size();
+    }
+
+    bool IndexedDeck::hasKeyword( const std::string& keyword ) const {
+        return this->index.hasKeyword( keyword );
+    }
+
+    size_t IndexedDeck::count( const std::string& keyword ) const {
+        return this->index.count( keyword );
+    }
+
+    const DeckKeyword& IndexedDeck::getKeyword( size_t position ) const {
+        const auto& keyword = this->index.getKeyword( position );
+        if( !keyword.isPlaceholder() ) return keyword;
+
+        auto found = this->decoded.find( position );
+        if( found == this->decoded.end() )
+            found = this->decoded.emplace( position, this->parser.decodeKeyword( this->index,
+                                                                                 keyword,
+                                                                                 this->parseContext,
+                                                                                 &this->inputs ) ).first;
+
+        return found->second;
+    }
+
+    const DeckKeyword& IndexedDeck::getKeyword( const std::string& keyword, size_t nth ) const {
+        return this->decode( this->index.getKeyword( keyword, nth ) );
+    }
+
+    const DeckKeyword& IndexedDeck::getKeyword( const std::string& keyword ) const {
+        return this->decode( this->index.getKeyword( keyword ) );
+    }
+
+    const DeckKeyword& IndexedDeck::getKeyword( const std::string& section,
+                                                const std::string& keyword,
+                                                size_t nth ) const {
+        return this->decode( Section( this->index, section ).getKeyword( keyword, nth ) );
+    }
+
+    const DeckKeyword& IndexedDeck::decode( const DeckKeyword& keyword ) const {
+        const std::less< const DeckKeyword* > less;
+        const auto* first = this->index.size() > 0 ? &this->index.getKeyword( 0 ) : nullptr;
+
+        if( !first || less( &keyword, first ) || !less( &keyword, first + this->index.size() ) )
+            throw std::invalid_argument( "The keyword " + keyword.name() + " is not from the index of the deck" );
+
+        return this->getKeyword( size_t( &keyword - first ) );
+    }
+
+    const MessageContainer& IndexedDeck::getMessageContainer() const {
+        return this->index.getMessageContainer();
+    }
+
+    const UnitSystem& IndexedDeck::getActiveUnitSystem() const {
+        return this->index.getActiveUnitSystem();
+    }
+
+    std::string IndexedDeck::indexPath( const std::string& dataFile ) {
+        return dataFile + ".index";
+    }
+}
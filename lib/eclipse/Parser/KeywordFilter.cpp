@@ -0,0 +1,54 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <opm/parser/eclipse/Parser/KeywordFilter.hpp>
+
+namespace Opm {
+
+    KeywordFilter::KeywordFilter( bool allow,
+                                  std::set< std::string > kws,
+                                  std::set< std::string > secs ) :
+        allowList( allow ),
+        keywords( std::move( kws ) ),
+        sections( std::move( secs ) )
+    {}
+
+    KeywordFilter KeywordFilter::allow( std::set< std::string > keywords,
+                                        std::set< std::string > sections ) {
+        return KeywordFilter( true, std::move( keywords ), std::move( sections ) );
+    }
+
+    KeywordFilter KeywordFilter::deny( std::set< std::string > keywords,
+                                       std::set< std::string > sections ) {
+        return KeywordFilter( false, std::move( keywords ), std::move( sections ) );
+    }
+
+    bool KeywordFilter::decode( const std::string& keyword, const std::string& section ) const {
+        const bool listed = this->keywords.count( keyword ) || this->sections.count( section );
+        return this->allowList == listed;
+    }
+
+    bool KeywordFilter::isSection( const std::string& keyword ) {
+        for( const auto& x : { "RUNSPEC", "GRID", "EDIT", "PROPS",
+                               "REGIONS", "SOLUTION", "SUMMARY", "SCHEDULE" } )
+            if( keyword == x ) return true;
+
+        return false;
+    }
+}
@@ -17,9 +17,31 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <stack>
+#include <thread>
+
+#if !defined(WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
@@ -30,19 +52,28 @@
 #include <opm/parser/eclipse/Deck/DeckItem.hpp>
 #include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
 #include <opm/parser/eclipse/Deck/DeckRecord.hpp>
+#include <opm/parser/eclipse/Deck/IncludeGraph.hpp>
 #include <opm/parser/eclipse/Deck/Section.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+#include <opm/parser/eclipse/Parser/DeckCache.hpp>
+#include <opm/parser/eclipse/Parser/DecodeCache.hpp>
+#include <opm/parser/eclipse/Parser/DeckReader.hpp>
+#include <opm/parser/eclipse/Parser/IncludeCache.hpp>
+#include <opm/parser/eclipse/Parser/KeywordFilter.hpp>
 #include <opm/parser/eclipse/Parser/ParseContext.hpp>
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/parser/eclipse/Parser/ParserItem.hpp>
 #include <opm/parser/eclipse/Parser/ParserKeyword.hpp>
 #include <opm/parser/eclipse/Parser/ParserRecord.hpp>
+#include <opm/parser/eclipse/RawDeck/Cleaner.hpp>
 #include <opm/parser/eclipse/RawDeck/RawConsts.hpp>
 #include <opm/parser/eclipse/RawDeck/RawEnums.hpp>
 #include <opm/parser/eclipse/RawDeck/RawRecord.hpp>
 #include <opm/parser/eclipse/RawDeck/RawKeyword.hpp>
 #include <opm/parser/eclipse/RawDeck/StarToken.hpp>
+#include <opm/parser/eclipse/Utility/String.hpp>
+#include <opm/parser/eclipse/Utility/SourceNames.hpp>
 #include <opm/parser/eclipse/Utility/Stringview.hpp>
 
 namespace Opm {
@@ -85,154 +116,903 @@ inline Itr find_terminator( Itr begin, Itr end, Term terminator ) {
     return find_terminator( qend + 1, end, terminator );
 }
 
-/**
-    This function will return a copy of the input string where all
-    characters following '--' are removed. The copy is a view and relies on
-    the source string to remain alive. The function handles quoting with
-    single quotes and double quotes:
+inline bool getline( string_view& input, string_view& line ) {
+    if( input.empty() ) return false;
+
+    auto end = std::find( input.begin(), input.end(), '\n' );
+
+    line = string_view( input.begin(), end );
+    input = string_view( end + 1, input.end() );
+    return true;
 
-    ABC --Comment                =>  ABC
-    ABC '--Comment1' --Comment2  =>  ABC '--Comment1'
-    ABC "-- Not balanced quote?  =>  ABC "-- Not balanced quote?
-*/
-static inline string_view strip_comments( string_view str ) {
-    return { str.begin(),
-             find_terminator( str.begin(), str.end(), find_comment() ) };
+    /* we know that the cleaner terminates every line with a newline, so we can
+     * safely assume that end+1 will either be end-of-input (i.e. empty range)
+     * or the start of the next line
+     */
 }
 
-template< typename Itr >
-inline Itr trim_left( Itr begin, Itr end ) {
-    return std::find_if_not( begin, end, RawConsts::is_separator() );
+/*
+ * The storage behind the input of a single file. A deck is usually dominated
+ * by a few huge data files (ZCORN, COORD, PERMX ...), and reading those into a
+ * string before cleaning them into another would keep the input resident two
+ * or three times over. Instead the file is mapped privately and cleaned in
+ * place, and the pages are given back as soon as the keywords in them have
+ * been consumed. Input that cannot be mapped is read into a string which is
+ * then cleaned in place.
+ */
+class input_buffer {
+    public:
+        explicit input_buffer( std::string&& );
+        /* input cleaned up front, shared with the include cache */
+        explicit input_buffer( std::shared_ptr< const std::string > cleaned );
+#if !defined(WIN32)
+        input_buffer( char* mapping, size_t size );
+#endif
+        input_buffer( const input_buffer& ) = delete;
+        input_buffer& operator=( const input_buffer& ) = delete;
+        ~input_buffer();
+
+        string_view content() const;
+
+        /*
+         * Hand the pages before consumed back to the operating system. A
+         * no-op unless the input is memory mapped.
+         */
+        void release( const char* consumed );
+
+    private:
+        std::string buffer;
+        std::shared_ptr< const std::string > shared;
+        char* mapping = nullptr;
+        size_t mapping_size = 0;
+        char* released = nullptr;
+        string_view cleaned;
+};
+
+/*
+ * Clean the input in place. The cleaner needs one writable byte past the end
+ * of the input, and terminates the last line.
+ */
+void clean_string( std::string& input ) {
+    const auto size = input.size();
+    input.push_back( '\n' );
+
+    auto* begin = &input[ 0 ];
+    input.resize( std::distance( begin, Cleaner::clean( begin, begin + size ) ) );
 }
 
-template< typename Itr >
-inline Itr trim_right( Itr begin, Itr end ) {
+input_buffer::input_buffer( std::string&& input ) :
+    buffer( std::move( input ) )
+{
+    clean_string( this->buffer );
+    this->cleaned = string_view( this->buffer );
+}
+
+input_buffer::input_buffer( std::shared_ptr< const std::string > input ) :
+    shared( std::move( input ) ),
+    cleaned( *this->shared )
+{}
 
-    std::reverse_iterator< Itr > rbegin( end );
-    std::reverse_iterator< Itr > rend( begin );
+#if !defined(WIN32)
 
-    return std::find_if_not( rbegin, rend, RawConsts::is_separator() ).base();
+inline size_t page_size() {
+    static const size_t size = ::sysconf( _SC_PAGESIZE );
+    return size;
 }
 
-inline string_view trim( string_view str ) {
-    auto fst = trim_left( str.begin(), str.end() );
-    auto lst = trim_right( fst, str.end() );
-    return { fst, lst };
+inline char* page_down( const char* ptr ) {
+    const auto addr = reinterpret_cast< std::uintptr_t >( ptr );
+    return reinterpret_cast< char* >( addr - addr % page_size() );
 }
 
-inline string_view strip_slash( string_view view ) {
-    using itr = string_view::const_iterator;
-    const auto term = []( itr begin, itr end ) {
-        return std::find( begin, end, '/' );
-    };
+inline char* page_up( const char* ptr ) {
+    return page_down( ptr + page_size() - 1 );
+}
+
+input_buffer::input_buffer( char* ptr, size_t size ) :
+    mapping( ptr ),
+    mapping_size( size ),
+    released( ptr )
+{
+    ::madvise( ptr, size, MADV_SEQUENTIAL );
+    auto* end = Cleaner::clean( ptr, ptr + size );
+    this->cleaned = string_view( ptr, end );
+
+    /* the tail that was stripped away by cleaning is never read again */
+    auto* tail = page_up( end );
+    auto* mapping_end = page_up( ptr + size );
+    if( tail < mapping_end )
+        ::madvise( tail, mapping_end - tail, MADV_DONTNEED );
+}
+
+input_buffer::~input_buffer() {
+    if( this->mapping )
+        ::munmap( this->mapping, this->mapping_size );
+}
 
-    auto begin = view.begin();
-    auto end = view.end();
-    auto slash = find_terminator( begin, end, term );
+void input_buffer::release( const char* consumed ) {
+    if( !this->mapping ) return;
 
-    /* we want to preserve terminating slashes */
-    if( slash != end ) ++slash;
+    auto* upto = page_down( consumed );
+    if( upto <= this->released ) return;
 
-    return { begin, slash };
+    ::madvise( this->released, upto - this->released, MADV_DONTNEED );
+    this->released = upto;
 }
 
-inline bool getline( string_view& input, string_view& line ) {
-    if( input.empty() ) return false;
+/*
+ * Map and clean the file, or return nullptr if that is not possible in which
+ * case the caller should fall back to reading it. The stamp, if asked for, is
+ * of the bytes that are mapped.
+ */
+std::shared_ptr< input_buffer > map_file( const boost::filesystem::path& path,
+                                          IncludeGraph::Stamp* stamp = nullptr ) {
+    const int fd = ::open( path.string().c_str(), O_RDONLY );
+    if( fd < 0 ) return {};
 
-    auto end = std::find( input.begin(), input.end(), '\n' );
+    struct stat st;
+    size_t size = 0;
+    void* ptr = MAP_FAILED;
 
-    line = string_view( input.begin(), end );
-    input = string_view( end + 1, input.end() );
-    return true;
+    /*
+     * The cleaner needs one writable byte past the end of the input. The
+     * mapping only has it when the file does not end on a page boundary, in
+     * which case the zero-filled remainder of the last page is used.
+     */
+    if( ::fstat( fd, &st ) == 0 && S_ISREG( st.st_mode ) ) {
+        size = st.st_size;
+        if( size > 0 && size % page_size() != 0 )
+            ptr = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    }
 
-    /* we know that we always append a newline onto the input string, so we can
-     * safely assume that end+1 will either be end-of-input (i.e. empty range)
-     * or the start of the next line
+    ::close( fd );
+    if( ptr == MAP_FAILED ) return {};
+
+    if( stamp ) {
+        stamp->valid = true;
+        stamp->size = size;
+        stamp->mtime = st.st_mtime;
+        stamp->digest = DeckCache::hash( static_cast< const char* >( ptr ), size );
+    }
+
+    return std::make_shared< input_buffer >( static_cast< char* >( ptr ), size );
+}
+
+#else
+
+input_buffer::~input_buffer() = default;
+
+void input_buffer::release( const char* ) {}
+
+std::shared_ptr< input_buffer > map_file( const boost::filesystem::path&, IncludeGraph::Stamp* = nullptr ) {
+    return {};
+}
+
+#endif
+
+string_view input_buffer::content() const {
+    return this->cleaned;
+}
+
+/*
+ * Read and clean the file into a string, or return nullptr if it cannot be
+ * opened.
+ */
+bool read_raw( const boost::filesystem::path& path, std::string& input ) {
+    const auto closer = []( std::FILE* f ) { std::fclose( f ); };
+    std::unique_ptr< std::FILE, decltype( closer ) > ufp(
+            std::fopen( path.string().c_str(), "rb" ),
+            closer
+            );
+
+    if( !ufp ) return false;
+
+    /*
+     * read the input file C-style. This is done for performance
+     * reasons, as streams are slow. Reserve room for the newline the
+     * cleaner appends so that it does not reallocate.
      */
+
+    auto* fp = ufp.get();
+    std::fseek( fp, 0, SEEK_END );
+    const auto size = std::ftell( fp );
+    input.reserve( size + 1 );
+    input.resize( size );
+    std::rewind( fp );
+    const auto readc = std::fread( &input[ 0 ], 1, input.size(), fp );
+
+    if( std::ferror( fp ) || readc != input.size() )
+        throw std::runtime_error( "Error when reading input file '"
+                                + path.string() + "'" );
+
+    return true;
+}
+
+/* the time is read first, so that a concurrent write is seen as a change */
+std::shared_ptr< input_buffer > read_file( const boost::filesystem::path& path,
+                                           IncludeGraph::Stamp* stamp = nullptr ) {
+    boost::system::error_code ec;
+    const int64_t mtime = stamp ? boost::filesystem::last_write_time( path, ec ) : 0;
+
+    std::string input;
+    if( !read_raw( path, input ) ) return {};
+
+    if( stamp && !ec ) {
+        stamp->valid = true;
+        stamp->size = input.size();
+        stamp->mtime = mtime;
+        stamp->digest = DeckCache::hash( input.data(), input.size() );
+    }
+
+    return std::make_shared< input_buffer >( std::move( input ) );
+}
+
+/*
+ * Substitute PATHS aliases and make the INCLUDE path absolute. backslash is
+ * set if any backslashes were replaced.
+ */
+boost::filesystem::path resolve_include( std::string path,
+                                         const std::map< std::string, std::string >& aliases,
+                                         const boost::filesystem::path& rootPath,
+                                         bool& backslash ) {
+    static const std::string pathKeywordPrefix("$");
+    static const std::string validPathNameCharacters("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_");
+
+    size_t positionOfPathName = path.find(pathKeywordPrefix);
+
+    if ( positionOfPathName != std::string::npos) {
+        std::string stringStartingAtPathName = path.substr(positionOfPathName+1);
+        size_t cutOffPosition = stringStartingAtPathName.find_first_not_of(validPathNameCharacters);
+        std::string stringToFind = stringStartingAtPathName.substr(0, cutOffPosition);
+        std::string stringToReplace = aliases.at( stringToFind );
+        boost::replace_all(path, pathKeywordPrefix + stringToFind, stringToReplace);
+    }
+
+    // Check if there are any backslashes in the path...
+    backslash = path.find('\\') != std::string::npos;
+    if( backslash )
+        std::replace(path.begin(), path.end(), '\\', '/');
+
+    boost::filesystem::path includeFilePath(path);
+
+    if (includeFilePath.is_relative())
+        return rootPath / includeFilePath;
+
+    return includeFilePath;
+}
+
+/*
+ * Reads (maps) and cleans INCLUDE files on background threads, so that by the
+ * time the parser gets to an INCLUDE the file is usually ready. Files are
+ * prefetched in the order they are found, and at most a few of them are kept
+ * ready ahead of the parser to bound the memory used.
+ *
+ * The prefetcher never reports anything: a file that could not be read, or
+ * was never requested, is loaded by the parser as usual, which also takes care
+ * of the error handling.
+ */
+class include_prefetcher {
+    public:
+        /* stamps: record the stamps of the files, see ParserState::stamps */
+        include_prefetcher( size_t threads, bool stamps );
+        include_prefetcher( const include_prefetcher& ) = delete;
+        include_prefetcher& operator=( const include_prefetcher& ) = delete;
+        ~include_prefetcher();
+
+        /*
+         * Request the file, and return true if it was not requested already,
+         * in which case the caller is to take or discard it.
+         */
+        bool prefetch( const boost::filesystem::path& );
+
+        /*
+         * Take the prefetched file, waiting for it if it is being read.
+         * Returns false if the file was not requested, not started yet, or
+         * could not be read.
+         */
+        bool take( const boost::filesystem::path&,
+                   std::shared_ptr< input_buffer >&,
+                   boost::filesystem::path& canonical,
+                   IncludeGraph::Stamp& stamp );
+
+        /*
+         * Drop the files that will not be taken after all, e.g. the includes
+         * of a file that has been closed, so that they neither hold their
+         * buffers nor count against the files kept ready.
+         */
+        void discard( const std::vector< std::string >& paths );
+
+    private:
+        struct entry {
+            boost::filesystem::path canonical;
+            std::shared_ptr< input_buffer > buffer;
+            IncludeGraph::Stamp stamp;
+            bool started = false;
+            bool done = false;
+            bool discarded = false;
+        };
+
+        void work();
+
+        size_t threads;
+        bool stamps;
+        size_t ready = 0;
+        bool stop = false;
+        std::mutex lock;
+        std::condition_variable cond;
+        std::deque< std::string > queue;
+        std::map< std::string, entry > files;
+        std::vector< std::thread > workers;
+};
+
+include_prefetcher::include_prefetcher( size_t thr, bool stamp ) :
+    threads( thr ),
+    stamps( stamp )
+{}
+
+include_prefetcher::~include_prefetcher() {
+    {
+        std::lock_guard< std::mutex > guard( this->lock );
+        this->stop = true;
+        this->queue.clear();
+    }
+
+    this->cond.notify_all();
+    for( auto& worker : this->workers )
+        worker.join();
+}
+
+bool include_prefetcher::prefetch( const boost::filesystem::path& path ) {
+    {
+        std::lock_guard< std::mutex > guard( this->lock );
+        const auto inserted = this->files.emplace( path.string(), entry() );
+        if( !inserted.second ) {
+            /* requested again while it is still being read */
+            auto& file = inserted.first->second;
+            const bool discarded = file.discarded;
+            file.discarded = false;
+            return discarded;
+        }
+
+        this->queue.push_back( path.string() );
+
+        /* the threads are started on the first INCLUDE */
+        if( this->workers.size() < this->threads )
+            this->workers.emplace_back( &include_prefetcher::work, this );
+    }
+
+    this->cond.notify_all();
+    return true;
+}
+
+bool include_prefetcher::take( const boost::filesystem::path& path,
+                               std::shared_ptr< input_buffer >& buffer,
+                               boost::filesystem::path& canonical,
+                               IncludeGraph::Stamp& stamp ) {
+    std::unique_lock< std::mutex > guard( this->lock );
+
+    const auto itr = this->files.find( path.string() );
+    if( itr == this->files.end() ) return false;
+
+    if( !itr->second.started ) {
+        this->queue.erase( std::find( this->queue.begin(), this->queue.end(), itr->first ) );
+        this->files.erase( itr );
+        return false;
+    }
+
+    itr->second.discarded = false;
+    this->cond.wait( guard, [itr] { return itr->second.done; } );
+
+    buffer = std::move( itr->second.buffer );
+    canonical = std::move( itr->second.canonical );
+    stamp = itr->second.stamp;
+    this->files.erase( itr );
+
+    --this->ready;
+    this->cond.notify_all();
+    return bool( buffer );
+}
+
+void include_prefetcher::discard( const std::vector< std::string >& paths ) {
+    {
+        std::lock_guard< std::mutex > guard( this->lock );
+        for( const auto& path : paths ) {
+            const auto itr = this->files.find( path );
+            if( itr == this->files.end() ) continue;
+
+            auto& file = itr->second;
+            if( !file.started ) {
+                this->queue.erase( std::find( this->queue.begin(), this->queue.end(), itr->first ) );
+                this->files.erase( itr );
+            } else if( file.done ) {
+                this->files.erase( itr );
+                --this->ready;
+            } else {
+                /* dropped by the worker once it is read */
+                file.discarded = true;
+            }
+        }
+    }
+
+    this->cond.notify_all();
+}
+
+void include_prefetcher::work() {
+    const auto bound = 2 * this->threads;
+
+    std::unique_lock< std::mutex > guard( this->lock );
+    while( true ) {
+        this->cond.wait( guard, [this,bound] {
+            return this->stop
+                || ( !this->queue.empty() && this->ready < bound );
+        } );
+
+        if( this->stop ) return;
+
+        const auto key = std::move( this->queue.front() );
+        this->queue.pop_front();
+
+        auto& file = this->files.at( key );
+        file.started = true;
+        ++this->ready;
+
+        guard.unlock();
+
+        boost::filesystem::path canonical;
+        std::shared_ptr< input_buffer > buffer;
+        IncludeGraph::Stamp stamp;
+        auto* wanted = this->stamps ? &stamp : nullptr;
+        try {
+            canonical = boost::filesystem::canonical( key );
+            buffer = map_file( canonical, wanted );
+            if( !buffer ) buffer = read_file( canonical, wanted );
+        } catch( ... ) {
+            buffer.reset();
+        }
+
+        guard.lock();
+        if( file.discarded ) {
+            this->files.erase( key );
+            --this->ready;
+            this->cond.notify_all();
+            continue;
+        }
+
+        file.canonical = std::move( canonical );
+        file.buffer = std::move( buffer );
+        file.stamp = stamp;
+        file.done = true;
+        this->cond.notify_all();
+    }
 }
 
 /*
- * Read the input file and remove everything that isn't interesting data,
- * including stripping comments, removing leading/trailing whitespaces and
- * everything after (terminating) slashes. Manually copying into the string for
- * performance.
+ * The threads that decode the queued keywords. They are started on the first
+ * batch and kept for the whole parse, and the parse thread works on every
+ * batch along with them.
  */
-inline std::string clean( const std::string& str ) {
-    std::string dst;
-    dst.resize( str.size() );
+class decode_pool {
+    public:
+        explicit decode_pool( size_t threads );
+        decode_pool( const decode_pool& ) = delete;
+        decode_pool& operator=( const decode_pool& ) = delete;
+        ~decode_pool();
 
-    string_view input( str ), line;
-    auto dsti = dst.begin();
-    while( getline( input, line ) ) {
-        line = trim( strip_slash( strip_comments( line ) ) );
+        /*
+         * Run work on the calling thread and on up to helpers threads of the
+         * pool, and return when all of them are done.
+         */
+        void run( size_t helpers, const std::function< void() >& work );
 
-        std::copy( line.begin(), line.end(), dsti );
-        dsti += std::distance( line.begin(), line.end() );
-        *dsti++ = '\n';
+    private:
+        void loop();
+
+        size_t threads;
+        size_t generation = 0;
+        size_t wanted = 0;
+        size_t active = 0;
+        bool stop = false;
+        const std::function< void() >* job = nullptr;
+        std::mutex lock;
+        std::condition_variable start;
+        std::condition_variable finished;
+        std::vector< std::thread > workers;
+};
+
+decode_pool::decode_pool( size_t thr ) :
+    threads( thr )
+{}
+
+decode_pool::~decode_pool() {
+    {
+        std::lock_guard< std::mutex > guard( this->lock );
+        this->stop = true;
     }
 
-    dst.resize( std::distance( dst.begin(), dsti ) );
-    return dst;
+    this->start.notify_all();
+    for( auto& worker : this->workers )
+        worker.join();
+}
+
+void decode_pool::run( size_t helpers, const std::function< void() >& work ) {
+    helpers = std::min( helpers, this->threads );
+
+    {
+        std::lock_guard< std::mutex > guard( this->lock );
+        while( this->workers.size() < helpers )
+            this->workers.emplace_back( &decode_pool::loop, this );
+
+        this->job = &work;
+        this->wanted = helpers;
+        ++this->generation;
+    }
+
+    this->start.notify_all();
+    work();
+
+    std::unique_lock< std::mutex > guard( this->lock );
+    this->finished.wait( guard, [this] { return this->wanted == 0 && this->active == 0; } );
+    this->job = nullptr;
+}
+
+/* every thread works on a batch at most once, and only if it is still wanted */
+void decode_pool::loop() {
+    size_t seen = 0;
+
+    std::unique_lock< std::mutex > guard( this->lock );
+    while( true ) {
+        this->start.wait( guard, [this,&seen] {
+            return this->stop
+                || ( this->generation != seen && this->wanted > 0 );
+        } );
+
+        if( this->stop ) return;
+
+        seen = this->generation;
+        --this->wanted;
+        ++this->active;
+        const auto* work = this->job;
+
+        guard.unlock();
+        ( *work )();
+        guard.lock();
+
+        --this->active;
+        this->finished.notify_all();
+    }
 }
 
 const std::string emptystr = "";
 
+/*
+ * A keyword found by the sequential pass, waiting to be decoded on the
+ * thread pool. Messages issued by the sequential pass after the keyword was
+ * queued are kept with it, so the message order is the same as when parsing
+ * sequentially.
+ */
+struct pending_keyword {
+    pending_keyword( std::shared_ptr< RawKeyword > raw, const ParserKeyword* pkw, size_t hint ) :
+        rawKeyword( std::move( raw ) ),
+        parserKeyword( pkw ),
+        dataSizeHint( hint ),
+        keyword( rawKeyword->getKeywordName() )
+    {}
+
+    explicit pending_keyword( DeckKeyword&& kw ) :
+        keyword( std::move( kw ) )
+    {}
+
+    void decode( const ParseContext&, const std::shared_ptr< SymbolTable >& );
+
+    std::shared_ptr< RawKeyword > rawKeyword;
+    const ParserKeyword* parserKeyword = nullptr;
+    size_t dataSizeHint = 0;
+    DeckKeyword keyword;
+    MessageContainer messages;
+    MessageContainer trailing;
+    std::exception_ptr error;
+};
+
+void pending_keyword::decode( const ParseContext& parseContext,
+                              const std::shared_ptr< SymbolTable >& symbols ) {
+    if( !this->parserKeyword ) return;
+
+    try {
+        this->keyword = this->parserKeyword->parse( parseContext,
+                                                    this->messages,
+                                                    this->rawKeyword,
+                                                    this->dataSizeHint,
+                                                    symbols );
+    } catch( ... ) {
+        this->error = std::current_exception();
+    }
+
+    this->rawKeyword.reset();
+}
+
+/*
+ * The size of a raw keyword is measured in characters rather than tokens, as
+ * the records of data keywords are never split into tokens.
+ */
+size_t raw_size( const RawKeyword& rawKeyword ) {
+    size_t size = 1;
+    for( const auto& record : rawKeyword )
+        size += record.getRecordView().size();
+
+    return size;
+}
+
 struct file {
-    file( boost::filesystem::path p, const std::string& in ) :
-        input( in ), path( p )
+    file( boost::filesystem::path p, SourceNames::id file_id, std::shared_ptr< input_buffer > in ) :
+        input( in->content() ), path( p ),
+        id( file_id ),
+        buffer( std::move( in ) )
     {}
 
     string_view input;
     size_t lineNR = 0;
     boost::filesystem::path path;
+    SourceNames::id id;
+    std::shared_ptr< input_buffer > buffer;
+    /* the includes of the file that were handed to the prefetcher */
+    std::vector< std::string > prefetched;
 };
 
 class InputStack : public std::stack< file, std::vector< file > > {
     public:
-        void push( std::string&& input, boost::filesystem::path p = "" );
+        void push( std::shared_ptr< input_buffer > input, boost::filesystem::path p, SourceNames::id );
+        void pop();
+
+        /*
+         * Free the storage of the input that has been consumed. Must only be
+         * called when no raw keyword refers to it anymore.
+         */
+        void release();
 
     private:
-        std::list< std::string > string_storage;
+        std::vector< std::shared_ptr< input_buffer > > retired;
         using base = std::stack< file, std::vector< file > >;
 };
 
-void InputStack::push( std::string&& input, boost::filesystem::path p ) {
-    this->string_storage.push_back( std::move( input ) );
-    this->emplace( p, this->string_storage.back() );
+void InputStack::push( std::shared_ptr< input_buffer > input, boost::filesystem::path p, SourceNames::id id ) {
+    this->emplace( p, id, std::move( input ) );
+}
+
+void InputStack::pop() {
+    /*
+     * The keyword being assembled can span the end of an included file, so
+     * the storage is kept alive until the next release().
+     */
+    this->retired.push_back( std::move( this->top().buffer ) );
+    base::pop();
+}
+
+void InputStack::release() {
+    this->retired.clear();
+    for( auto& f : this->c )
+        f.buffer->release( f.input.begin() );
+}
+
+/* the names of the keywords that give the number of records of other keywords */
+std::set< std::string > data_keywords( const Parser& parser ) {
+    std::set< std::string > names;
+    for( const auto& name : parser.getAllDeckNames() ) {
+        if( !parser.isRecognizedKeyword( name ) ) continue;
+
+        if( parser.getParserKeywordFromDeckName( name )->isDataKeyword() )
+            names.insert( name );
+    }
+
+    return names;
+}
+
+std::set< std::string > sizing_keywords( const Parser& parser ) {
+    std::set< std::string > names;
+    for( const auto& name : parser.getAllDeckNames() ) {
+        if( !parser.isRecognizedKeyword( name ) ) continue;
+
+        const auto* parserKeyword = parser.getParserKeywordFromDeckName( name );
+        if( parserKeyword->getSizeType() == OTHER_KEYWORD_IN_DECK )
+            names.insert( parserKeyword->getKeywordSize().keyword );
+    }
+
+    return names;
 }
 
+/*
+ * An included file whose keywords are collected for the include cache. The
+ * keywords and messages of the file are the ones added to the deck while it is
+ * on top of the input stack.
+ */
+struct include_capture {
+    std::shared_ptr< const IncludeCache::File > file;
+    size_t depth;
+    size_t first_keyword;
+    size_t first_message;
+    bool cacheable;
+    std::vector< IncludeCache::SizeDependency > sizes;
+};
+
 class ParserState {
     public:
         ParserState( const ParseContext& );
-        ParserState( const ParseContext&, boost::filesystem::path );
 
         void loadString( const std::string& );
         void loadFile( const boost::filesystem::path& );
+        void loadInclude( const boost::filesystem::path& );
         void openRootFile( const boost::filesystem::path& );
 
-        void handleRandomText(const string_view& ) const;
-        boost::filesystem::path getIncludeFilePath( std::string ) const;
+        /*
+         * Parse a file of a deck again, as it was included. The number of
+         * records of the keywords is given by the keywords before the file
+         * in the deck, unless the file itself has them.
+         */
+        void reopenFile( const Deck&, const IncludeGraph::File&, const boost::filesystem::path& root );
+
+        /* close the files left open by an END keyword */
+        void closeFiles();
+
+        /* read and clean INCLUDE files ahead of the parser */
+        void enablePrefetch( size_t threads, std::set< std::string > dataNames );
+        void stopPrefetch();
+
+        /*
+         * Share the cleaned input and the decoded keywords of the files with
+         * other parsers. The context is a hash of the ParseContext and the
+         * keyword definitions of the parser.
+         */
+        void enableIncludeCache( std::shared_ptr< IncludeCache >, uint64_t context );
+
+        /*
+         * Hand the keywords out through the output queue rather than adding
+         * them to the deck. The last keyword with each of the names that
+         * give the number of records of other keywords is kept aside.
+         */
+        void enableStreaming( std::set< std::string > sizingNames );
+
+        /*
+         * Leave the records of the keywords the filter does not let through,
+         * unless they give the number of records of other keywords.
+         */
+        void enableFilter( std::shared_ptr< const KeywordFilter >, std::set< std::string > sizingNames );
+
+        void handleRandomText(const string_view& );
+        boost::filesystem::path getIncludeFilePath( std::string );
         void addPathAlias( const std::string& alias, const std::string& path );
 
         const boost::filesystem::path& current_path() const;
+        SourceNames::id current_file() const;
         size_t line() const;
 
         bool done() const;
         string_view getline();
         void closeFile();
+        void releaseInput();
+
+        /*
+         * The message container for messages issued while finding the
+         * keywords. These end up in the deck, after the messages from decoding
+         * the keywords that have been queued so far.
+         */
+        MessageContainer& messages();
+
+        void addKeyword( DeckKeyword&& );
+        void addKeyword( std::shared_ptr< RawKeyword >, const ParserKeyword* );
+
+        /*
+         * Pick up the grid dimensions from DIMENS or SPECGRID, which are used
+         * to size the data of the grid property keywords ahead of decoding.
+         */
+        void readGridDims( const RawKeyword& );
+        void readGridDims( const DeckKeyword& );
+        size_t dataSizeHint( const std::string& keyword ) const;
+
+        /*
+         * Decode the queued keywords and add them to the deck. Rethrows the
+         * first error, in deck order, raised while decoding.
+         */
+        void flush();
+
+        /*
+         * Decode the queued keywords only if one of them is named name, so
+         * that a keyword sized by it finds it in the deck.
+         */
+        void flush( const std::string& name );
+
+        /*
+         * The last keyword with this name, which gives the number of records
+         * of another keyword, or nullptr.
+         */
+        const DeckKeyword* sizingKeyword( const std::string& name ) const;
+
+        /*
+         * The size of a keyword given by another keyword, which was found in
+         * the deck or not. Keywords from the include cache are only reused
+         * with the same sizes, and the keywords of the include graph are
+         * parsed again when the sizing keyword changes.
+         */
+        void addSizeDependency( const KeywordSize&, const DeckKeyword* sizing, int size );
 
     private:
+        void addDecoded( DeckKeyword&& );
+        bool addPlaceholder( const RawKeyword&, const ParserKeyword& );
+        void pushFile( std::shared_ptr< input_buffer >, const boost::filesystem::path& );
+        void popFile();
+
+        /* record the keywords and messages of a file in the include graph */
+        void beginFile( const std::string& path );
+        void endFile();
+        void markFile( size_t file, bool last );
+        std::vector< std::string > prefetchIncludes( string_view );
+
+        /* content: the cleaned input is needed, not just the keywords */
+        std::shared_ptr< const IncludeCache::File > cachedFile( const boost::filesystem::path& canonical,
+                                                                bool content );
+        bool spliceCachedKeywords( const IncludeCache::File& );
+        void finishCapture();
+        void invalidateCaptures();
+
         InputStack input_stack;
+        std::vector< pending_keyword > pending;
+        size_t pending_size = 0;
+        std::unique_ptr< decode_pool > pool;
+
+        /*
+         * A start or end of a file among the queued keywords, which is
+         * recorded in the include graph when they are decoded: it came after
+         * the keyword at index after, and after the first trailing messages
+         * of that keyword.
+         */
+        struct file_mark {
+            size_t file;
+            bool last;
+            size_t after;
+            size_t trailing;
+        };
+        std::vector< file_mark > marks;
 
         std::map< std::string, std::string > pathMap;
         boost::filesystem::path rootPath;
 
+        size_t nx = 0, ny = 0, nz = 0;
+
+        std::unique_ptr< include_prefetcher > prefetcher;
+        /* the data keywords, whose records are skipped by the prefetch scan */
+        std::set< std::string > dataNames;
+
+        std::shared_ptr< IncludeCache > includeCache;
+        uint64_t includeContext = 0;
+        std::vector< include_capture > captures;
+
+        /* the files of the include graph that are being parsed */
+        std::vector< size_t > openFiles;
+
+        /* when parsing a file again, the deck it is in */
+        const Deck* base = nullptr;
+        size_t baseSize = 0;
+
+        std::set< std::string > sizingNames;
+        std::map< std::string, DeckKeyword > sizing;
+
+        std::shared_ptr< const KeywordFilter > filter;
+        std::string section;
+
     public:
         std::shared_ptr< RawKeyword > rawKeyword;
         string_view nextKeyword = emptystr;
         Deck deck;
+        bool streaming = false;
+        std::deque< DeckKeyword > output;
         const ParseContext& parseContext;
         bool unknown_keyword = false;
+        size_t threads = 1;
+        /*
+         * Record the stamps of the files in the include graph, for the
+         * manifest of the deck cache and the index of an IndexedDeck.
+         */
+        bool stamps = false;
+        size_t prefetchHits = 0;
+        size_t prefetchMisses = 0;
 };
 
 
@@ -240,6 +1020,10 @@ const boost::filesystem::path& ParserState::current_path() const {
     return this->input_stack.top().path;
 }
 
+SourceNames::id ParserState::current_file() const {
+    return this->input_stack.top().id;
+}
+
 size_t ParserState::line() const {
     return this->input_stack.top().lineNR;
 }
@@ -248,7 +1032,7 @@ bool ParserState::done() const {
 
     while( !this->input_stack.empty() &&
             this->input_stack.top().input.empty() )
-        const_cast< ParserState* >( this )->input_stack.pop();
+        const_cast< ParserState* >( this )->popFile();
 
     return this->input_stack.empty();
 }
@@ -263,23 +1047,421 @@ string_view ParserState::getline() {
 }
 
 void ParserState::closeFile() {
+    this->popFile();
+}
+
+void ParserState::popFile() {
+    if( !this->captures.empty()
+     && this->captures.back().depth == this->input_stack.size() )
+        this->finishCapture();
+
+    this->endFile();
+    if( this->prefetcher )
+        this->prefetcher->discard( this->input_stack.top().prefetched );
+
     this->input_stack.pop();
 }
 
+void ParserState::beginFile( const std::string& path ) {
+    auto& graph = this->deck.getIncludeGraph();
+
+    IncludeGraph::File file;
+    file.path = path;
+    file.parent = this->openFiles.empty() ? IncludeGraph::npos : this->openFiles.back();
+    file.aliases = this->pathMap;
+
+    this->openFiles.push_back( graph.add( std::move( file ) ) );
+    this->markFile( this->openFiles.back(), false );
+}
+
+void ParserState::endFile() {
+    auto& file = this->deck.getIncludeGraph()[ this->openFiles.back() ];
+    file.spans = ( this->rawKeyword && !this->rawKeyword->isFinished() )
+              || !this->nextKeyword.empty();
+
+    this->markFile( this->openFiles.back(), true );
+    this->openFiles.pop_back();
+}
+
+/*
+ * The keywords still queued are not decoded at the start and end of a file,
+ * as that would make the batches as small as the files, so the ends of the
+ * file within the queue are filled in by flush().
+ */
+void ParserState::markFile( size_t index, bool last ) {
+    if( !this->pending.empty() ) {
+        this->marks.push_back( { index,
+                                 last,
+                                 this->pending.size() - 1,
+                                 this->pending.back().trailing.size() } );
+        return;
+    }
+
+    auto& file = this->deck.getIncludeGraph()[ index ];
+    auto& keyword = last ? file.lastKeyword : file.firstKeyword;
+    auto& message = last ? file.lastMessage : file.firstMessage;
+    keyword = this->deck.size();
+    message = this->deck.getMessageContainer().size();
+}
+
+void ParserState::closeFiles() {
+    this->deck.getIncludeGraph().setEnded( !this->openFiles.empty() );
+
+    while( !this->openFiles.empty() )
+        this->endFile();
+}
+
+void ParserState::releaseInput() {
+    /* queued raw keywords still refer to the input */
+    if( !this->pending.empty() ) return;
+
+    this->input_stack.release();
+}
+
+MessageContainer& ParserState::messages() {
+    if( this->pending.empty() )
+        return this->deck.getMessageContainer();
+
+    return this->pending.back().trailing;
+}
+
+void ParserState::addDecoded( DeckKeyword&& keyword ) {
+    if( !this->streaming ) {
+        this->deck.addKeyword( std::move( keyword ) );
+        return;
+    }
+
+    if( this->sizingNames.count( keyword.name() ) ) {
+        this->sizing.erase( keyword.name() );
+        this->sizing.emplace( keyword.name(), keyword );
+    }
+
+    this->output.push_back( std::move( keyword ) );
+}
+
+void ParserState::addKeyword( DeckKeyword&& keyword ) {
+    if( this->threads <= 1 ) {
+        this->addDecoded( std::move( keyword ) );
+        return;
+    }
+
+    this->pending.emplace_back( std::move( keyword ) );
+}
+
+void ParserState::addKeyword( std::shared_ptr< RawKeyword > raw, const ParserKeyword* parserKeyword ) {
+    if( KeywordFilter::isSection( raw->getKeywordName() ) )
+        this->section = raw->getKeywordName();
+
+    if( this->filter && this->addPlaceholder( *raw, *parserKeyword ) )
+        return;
+
+    const auto hint = parserKeyword->isDataKeyword()
+                    ? this->dataSizeHint( raw->getKeywordName() )
+                    : 0;
+
+    if( this->threads <= 1 ) {
+        this->addDecoded( parserKeyword->parse( this->parseContext,
+                                                this->deck.getMessageContainer(),
+                                                raw,
+                                                hint,
+                                                this->deck.getSymbols() ) );
+        return;
+    }
+
+    /*
+     * The queued raw keywords keep the input they refer to alive, so decode
+     * in batches to bound the memory use.
+     */
+    const size_t max_pending_size = 1 << 25;
+    const size_t max_pending_keywords = 1 << 12;
+
+    this->pending_size += raw_size( *raw );
+    this->pending.emplace_back( std::move( raw ), parserKeyword, hint );
+
+    if( this->pending_size >= max_pending_size
+     || this->pending.size() >= max_pending_keywords )
+        this->flush();
+}
+
+/*
+ * The placeholder has the extent of the records in the input of the file, so
+ * they must all be in the file on top of the input stack, and the last one
+ * must end with a slash and a newline. Otherwise the keyword is decoded.
+ */
+bool ParserState::addPlaceholder( const RawKeyword& raw, const ParserKeyword& parserKeyword ) {
+    const auto& name = raw.getKeywordName();
+    if( this->filter->decode( name, this->section ) ) return false;
+    if( this->sizingNames.count( name ) ) return false;
+    if( raw.size() == 0 || raw.getFileId() == 0 ) return false;
+    if( this->input_stack.empty() ) return false;
+
+    const auto content = this->input_stack.top().buffer->content();
+    const auto* first = raw.begin()->getRecordView().begin();
+    const auto* last = std::prev( raw.end() )->getRecordView().end();
+
+    if( first < content.begin() || last + 1 >= content.end() ) return false;
+    if( last[ 0 ] != '/' || last[ 1 ] != '\n' ) return false;
+
+    DeckKeyword keyword( name );
+    keyword.setLocation( raw.getSourceNames(), raw.getFileId(), raw.getLineNR() );
+    keyword.setDataKeyword( parserKeyword.isDataKeyword() );
+    keyword.setPlaceholder( first - content.begin(), last + 2 - first, raw.size() );
+    this->addKeyword( std::move( keyword ) );
+    return true;
+}
+
+void ParserState::readGridDims( const RawKeyword& raw ) {
+    if( raw.size() == 0 ) return;
+
+    const auto& record = raw.getFirstRecord();
+    if( record.size() < 3 ) return;
+
+    /* a malformed record is reported when the keyword itself is decoded */
+    try {
+        const auto x = readValueToken< int >( record.getItem( 0 ) );
+        const auto y = readValueToken< int >( record.getItem( 1 ) );
+        const auto z = readValueToken< int >( record.getItem( 2 ) );
+        if( x <= 0 || y <= 0 || z <= 0 ) return;
+
+        this->nx = x;
+        this->ny = y;
+        this->nz = z;
+    } catch( const std::exception& ) {}
+}
+
+void ParserState::readGridDims( const DeckKeyword& keyword ) {
+    if( keyword.size() == 0 ) return;
+
+    const auto& record = keyword.getRecord( 0 );
+    if( record.size() < 3 ) return;
+
+    try {
+        const auto x = record.getItem( 0 ).get< int >( 0 );
+        const auto y = record.getItem( 1 ).get< int >( 0 );
+        const auto z = record.getItem( 2 ).get< int >( 0 );
+        if( x <= 0 || y <= 0 || z <= 0 ) return;
+
+        this->nx = x;
+        this->ny = y;
+        this->nz = z;
+    } catch( const std::exception& ) {}
+}
+
+size_t ParserState::dataSizeHint( const std::string& keyword ) const {
+    if( keyword == "ZCORN" ) return 8 * this->nx * this->ny * this->nz;
+    if( keyword == "COORD" ) return 6 * ( this->nx + 1 ) * ( this->ny + 1 );
+
+    return this->nx * this->ny * this->nz;
+}
+
+void ParserState::flush() {
+    if( this->pending.empty() ) return;
+
+    auto batch = std::move( this->pending );
+    this->pending.clear();
+    this->pending_size = 0;
+
+    const auto boundaries = std::move( this->marks );
+    this->marks.clear();
+
+    /*
+     * Start with the largest keywords so that a huge data keyword at the end
+     * of the batch does not leave the other threads idle.
+     */
+    std::vector< std::pair< size_t, size_t > > order;
+    for( size_t i = 0; i < batch.size(); ++i ) {
+        if( batch[ i ].parserKeyword )
+            order.emplace_back( raw_size( *batch[ i ].rawKeyword ), i );
+    }
+    std::sort( order.rbegin(), order.rend() );
+
+    std::atomic< size_t > next( 0 );
+    const auto work = [&]() {
+        for( size_t i = next++; i < order.size(); i = next++ )
+            batch[ order[ i ].second ].decode( this->parseContext,
+                                               this->deck.getSymbols() );
+    };
+
+    const auto nworkers = std::min( this->threads, order.size() );
+    if( nworkers > 1 ) {
+        if( !this->pool )
+            this->pool.reset( new decode_pool( this->threads - 1 ) );
+
+        this->pool->run( nworkers - 1, work );
+    } else {
+        work();
+    }
+
+    auto& graph = this->deck.getIncludeGraph();
+    auto& messages = this->deck.getMessageContainer();
+    auto mark = boundaries.begin();
+    for( size_t i = 0; i < batch.size(); ++i ) {
+        auto& kw = batch[ i ];
+        messages.appendMessages( kw.messages );
+        if( kw.error ) std::rethrow_exception( kw.error );
+
+        this->addDecoded( std::move( kw.keyword ) );
+
+        for( ; mark != boundaries.end() && mark->after == i; ++mark ) {
+            auto& file = graph[ mark->file ];
+            auto& keyword = mark->last ? file.lastKeyword : file.firstKeyword;
+            auto& message = mark->last ? file.lastMessage : file.firstMessage;
+            keyword = this->deck.size();
+            message = messages.size() + mark->trailing;
+        }
+
+        messages.appendMessages( kw.trailing );
+    }
+}
+
+void ParserState::flush( const std::string& name ) {
+    for( const auto& kw : this->pending ) {
+        if( kw.keyword.name() != name ) continue;
+
+        this->flush();
+        return;
+    }
+}
+
+const DeckKeyword* ParserState::sizingKeyword( const std::string& name ) const {
+    if( this->streaming ) {
+        const auto keyword = this->sizing.find( name );
+        return keyword == this->sizing.end() ? nullptr : &keyword->second;
+    }
+
+    if( this->deck.hasKeyword( name ) )
+        return &this->deck.getKeyword( name );
+
+    if( !this->base ) return nullptr;
+
+    for( auto index = this->base->count( name ); index > 0; --index ) {
+        const auto& keyword = this->base->getKeyword( name, index - 1 );
+        if( size_t( &keyword - &*this->base->begin() ) < this->baseSize )
+            return &keyword;
+    }
+
+    return nullptr;
+}
+
+void ParserState::addSizeDependency( const KeywordSize& keywordSize, const DeckKeyword* source, int size ) {
+    if( !this->openFiles.empty() )
+        this->deck.getIncludeGraph()[ this->openFiles.back() ].sizedBy.insert( keywordSize.keyword );
+
+    /* the deck of a file that is parsed again comes before every capture */
+    const bool parsed = source && this->deck.hasKeyword( keywordSize.keyword );
+    const size_t index = parsed ? source - &*this->deck.begin() : 0;
+
+    for( auto& capture : this->captures ) {
+        /* sized by a keyword in the file itself */
+        if( parsed && index >= capture.first_keyword ) continue;
+
+        capture.sizes.push_back( { keywordSize.keyword,
+                                   keywordSize.item,
+                                   keywordSize.shift,
+                                   source != nullptr,
+                                   size } );
+    }
+}
+
+/*
+ * The keywords of a file can be reused when the file has ended cleanly: no
+ * keyword spans the end of it, and the next keyword has not been peeked at.
+ */
+void ParserState::finishCapture() {
+    auto capture = std::move( this->captures.back() );
+    this->captures.pop_back();
+
+    if( !capture.cacheable ) return;
+    if( this->rawKeyword && !this->rawKeyword->isFinished() ) return;
+    if( !this->nextKeyword.empty() ) return;
+
+    this->flush();
+
+    auto keywords = std::make_shared< IncludeCache::Keywords >();
+    keywords->context = this->includeContext;
+    keywords->sizes = std::move( capture.sizes );
+    keywords->unknown = this->unknown_keyword;
+
+    keywords->keywords.assign( this->deck.begin() + capture.first_keyword, this->deck.end() );
+
+    const auto& messages = this->deck.getMessageContainer();
+    keywords->messages.assign( std::next( messages.begin(), capture.first_message ), messages.end() );
+
+    this->includeCache->addKeywords( capture.file, std::move( keywords ) );
+}
+
+/* the include cache hashes the files it reads anyway */
+IncludeGraph::Stamp cached_stamp( const IncludeCache::File& file ) {
+    IncludeGraph::Stamp stamp;
+    stamp.valid = true;
+    stamp.size = file.size;
+    stamp.mtime = file.mtime;
+    stamp.digest = file.digest;
+    return stamp;
+}
+
+std::shared_ptr< const IncludeCache::File >
+ParserState::cachedFile( const boost::filesystem::path& canonical, bool content ) {
+    auto file = this->includeCache->find( canonical.string() );
+    if( file && ( file->content || !content ) ) return file;
+
+    /* the time is read first, so that a concurrent write is seen as a change */
+    boost::system::error_code ec;
+    const int64_t mtime = boost::filesystem::last_write_time( canonical, ec );
+    if( ec ) return {};
+
+    std::string input;
+    if( !read_raw( canonical, input ) ) return {};
+
+    const auto size = input.size();
+    const auto digest = DeckCache::hash( input.data(), input.size() );
+    clean_string( input );
+
+    return this->includeCache->insert( canonical.string(), size, mtime, digest, std::move( input ) );
+}
+
+bool ParserState::spliceCachedKeywords( const IncludeCache::File& file ) {
+    const auto keywords = IncludeCache::keywords( file, this->includeContext );
+    if( !keywords ) return false;
+
+    this->flush();
+
+    for( const auto& dependency : keywords->sizes ) {
+        const auto* source = this->sizingKeyword( dependency.keyword );
+        if( bool( source ) != dependency.found ) return false;
+        if( !source ) continue;
+
+        const auto& record = source->getRecord( 0 );
+        const auto size = record.getItem( dependency.item ).get< int >( 0 ) + dependency.shift;
+        if( size != dependency.size ) return false;
+    }
+
+    auto& graphFile = this->deck.getIncludeGraph()[ this->openFiles.back() ];
+    for( const auto& dependency : keywords->sizes )
+        graphFile.sizedBy.insert( dependency.keyword );
+
+    for( const auto& keyword : keywords->keywords ) {
+        if( keyword.name() == "DIMENS" || keyword.name() == "SPECGRID" )
+            this->readGridDims( keyword );
+
+        this->deck.addKeyword( keyword );
+    }
+
+    auto& messages = this->deck.getMessageContainer();
+    for( const auto& message : keywords->messages )
+        messages.add( message );
+
+    this->unknown_keyword = keywords->unknown;
+    return true;
+}
+
 ParserState::ParserState(const ParseContext& __parseContext) :
     parseContext( __parseContext )
 {}
 
-ParserState::ParserState( const ParseContext& context,
-                          boost::filesystem::path p ) :
-    rootPath( boost::filesystem::canonical( p ).parent_path() ),
-    parseContext( context )
-{
-    openRootFile( p );
-}
-
 void ParserState::loadString(const std::string& input) {
-    this->input_stack.push( clean( input + "\n" ) );
+    this->beginFile( "" );
+    this->pushFile( std::make_shared< input_buffer >( std::string( input ) ), "" );
 }
 
 void ParserState::loadFile(const boost::filesystem::path& inputFile) {
@@ -288,42 +1470,213 @@ void ParserState::loadFile(const boost::filesystem::path& inputFile) {
     try {
         inputFileCanonical = boost::filesystem::canonical(inputFile);
     } catch (boost::filesystem::filesystem_error fs_error) {
+        this->beginFile( inputFile.string() );
         std::string msg = "Could not open file: " + inputFile.string();
-        parseContext.handleError( ParseContext::PARSE_MISSING_INCLUDE , deck.getMessageContainer() , msg);
+        parseContext.handleError( ParseContext::PARSE_MISSING_INCLUDE , this->messages() , msg);
+        this->endFile();
         return;
     }
 
-    const auto closer = []( std::FILE* f ) { std::fclose( f ); };
-    std::unique_ptr< std::FILE, decltype( closer ) > ufp(
-            std::fopen( inputFileCanonical.string().c_str(), "rb" ),
-            closer
-            );
+    this->beginFile( inputFileCanonical.string() );
+
+    std::shared_ptr< input_buffer > buffer;
+    auto& stamp = this->deck.getIncludeGraph()[ this->openFiles.back() ].stamp;
+    if( this->includeCache ) {
+        const auto cached = this->cachedFile( inputFileCanonical, true );
+        if( cached ) {
+            buffer = std::make_shared< input_buffer >( cached->content );
+            stamp = cached_stamp( *cached );
+        }
+    } else {
+        auto* wanted = this->stamps ? &stamp : nullptr;
+        buffer = map_file( inputFileCanonical, wanted );
+        if( !buffer ) buffer = read_file( inputFileCanonical, wanted );
+    }
+
+    // make sure the file we'd like to parse is readable
+    if( !buffer ) {
+        std::string msg = "Could not read from file: " + inputFile.string();
+        parseContext.handleError( ParseContext::PARSE_MISSING_INCLUDE , this->messages() , msg);
+        this->endFile();
+        return;
+    }
+
+    this->pushFile( std::move( buffer ), inputFileCanonical );
+}
+
+void ParserState::loadInclude( const boost::filesystem::path& includeFile ) {
+    /* the files this one is included from cannot be reused without it */
+    this->invalidateCaptures();
+
+    if( this->includeCache ) {
+        boost::system::error_code ec;
+        const auto canonical = boost::filesystem::canonical( includeFile, ec );
+        auto file = ec ? nullptr : this->cachedFile( canonical, false );
+
+        /* let loadFile report the file */
+        if( !file ) {
+            this->loadFile( includeFile );
+            return;
+        }
+
+        this->beginFile( canonical.string() );
+        this->deck.getIncludeGraph()[ this->openFiles.back() ].stamp = cached_stamp( *file );
+        if( this->spliceCachedKeywords( *file ) ) {
+            this->endFile();
+            return;
+        }
+
+        /* the keywords cannot be reused, so the dropped input is read again */
+        if( !file->content ) {
+            file = this->cachedFile( canonical, true );
+            if( !file ) {
+                std::string msg = "Could not read from file: " + includeFile.string();
+                parseContext.handleError( ParseContext::PARSE_MISSING_INCLUDE , this->messages() , msg);
+                this->endFile();
+                return;
+            }
+
+            this->deck.getIncludeGraph()[ this->openFiles.back() ].stamp = cached_stamp( *file );
+        }
+
+        this->flush();
+        this->captures.push_back( { file,
+                                    this->input_stack.size() + 1,
+                                    this->deck.size(),
+                                    this->deck.getMessageContainer().size(),
+                                    true,
+                                    {} } );
+
+        this->pushFile( std::make_shared< input_buffer >( file->content ), canonical );
+        return;
+    }
+
+    if( this->prefetcher ) {
+        std::shared_ptr< input_buffer > buffer;
+        boost::filesystem::path canonical;
+        IncludeGraph::Stamp stamp;
+
+        if( this->prefetcher->take( includeFile, buffer, canonical, stamp ) ) {
+            this->prefetchHits++;
+            this->beginFile( canonical.string() );
+            this->deck.getIncludeGraph()[ this->openFiles.back() ].stamp = stamp;
+            this->pushFile( std::move( buffer ), canonical );
+            return;
+        }
+
+        this->prefetchMisses++;
+    }
+
+    this->loadFile( includeFile );
+}
+
+void ParserState::pushFile( std::shared_ptr< input_buffer > buffer,
+                            const boost::filesystem::path& path ) {
+    const auto content = buffer->content();
+    const auto id = this->deck.getSourceNames()->intern( path.string() );
+    this->input_stack.push( std::move( buffer ), path, id );
+
+    if( this->prefetcher )
+        this->input_stack.top().prefetched = this->prefetchIncludes( content );
+}
+
+void ParserState::enablePrefetch( size_t count, std::set< std::string > names ) {
+    if( count == 0 ) return;
+
+    this->prefetcher.reset( new include_prefetcher( count, this->stamps ) );
+    this->dataNames = std::move( names );
+}
+
+/* nothing more is included, so the files still being prefetched are dropped */
+void ParserState::stopPrefetch() {
+    this->prefetcher.reset();
+}
+
+void ParserState::enableIncludeCache( std::shared_ptr< IncludeCache > cache, uint64_t context ) {
+    this->includeCache = std::move( cache );
+    this->includeContext = context;
+}
+
+void ParserState::enableStreaming( std::set< std::string > names ) {
+    this->streaming = true;
+    this->threads = 1;
+    this->sizingNames = std::move( names );
+}
+
+void ParserState::enableFilter( std::shared_ptr< const KeywordFilter > keywordFilter,
+                                std::set< std::string > names ) {
+    this->filter = std::move( keywordFilter );
+    this->sizingNames = std::move( names );
+}
+
+void ParserState::invalidateCaptures() {
+    for( auto& capture : this->captures )
+        capture.cacheable = false;
+}
+
+/*
+ * A quick look through the input for INCLUDE (and PATHS) keywords, so that
+ * reading the included files can start before the parser gets there. This
+ * only needs to be right most of the time: a file that was not prefetched is
+ * read when the parser reaches it, and nothing is reported from here.
+ */
+/*
+ * The records of the data keywords are skipped in one go, by looking for the
+ * slash that ends them, rather than line by line.
+ */
+std::vector< std::string > ParserState::prefetchIncludes( string_view input ) {
+    std::vector< std::string > prefetched;
+    auto aliases = this->pathMap;
+    bool include = false;
+    bool paths = false;
+    RawKeyword::DeckName name;
+
+    string_view line;
+    while( Opm::getline( input, line ) ) {
+        if( line.empty() ) continue;
+
+        if( paths && line == "/" ) {
+            paths = false;
+            continue;
+        }
+
+        if( include || paths ) {
+            if( line.back() == '/' )
+                line = string_view( line.begin(), line.end() - 1 );
+
+            try {
+                RawRecord record( line );
+                if( include && record.size() > 0 ) {
+                    bool backslash;
+                    const auto path = readValueToken< std::string >( record.getItem( 0 ) );
+                    const auto resolved = resolve_include( path, aliases, this->rootPath, backslash );
+                    if( this->prefetcher->prefetch( resolved ) )
+                        prefetched.push_back( resolved.string() );
+                }
+
+                if( paths && record.size() > 1 )
+                    aliases.emplace( readValueToken< std::string >( record.getItem( 0 ) ),
+                                     readValueToken< std::string >( record.getItem( 1 ) ) );
+            } catch( const std::exception& ) {}
 
-    // make sure the file we'd like to parse is readable
-    if( !ufp ) {
-        std::string msg = "Could not read from file: " + inputFile.string();
-        parseContext.handleError( ParseContext::PARSE_MISSING_INCLUDE , deck.getMessageContainer() , msg);
-        return;
-    }
+            include = false;
+            continue;
+        }
 
-    /*
-     * read the input file C-style. This is done for performance
-     * reasons, as streams are slow
-     */
+        if( RawKeyword::classifyLine( line, name ) != Raw::LineType::KEYWORD ) continue;
 
-    auto* fp = ufp.get();
-    std::string buffer;
-    std::fseek( fp, 0, SEEK_END );
-    buffer.resize( std::ftell( fp ) + 1 );
-    std::rewind( fp );
-    const auto readc = std::fread( &buffer[ 0 ], 1, buffer.size() - 1, fp );
-    buffer.back() = '\n';
+        const auto keyword = name.view();
+        include = keyword == RawConsts::include;
+        paths = keyword == RawConsts::paths;
+        if( include || paths || !this->dataNames.count( keyword.string() ) ) continue;
 
-    if( std::ferror( fp ) || readc != buffer.size() - 1 )
-        throw std::runtime_error( "Error when reading input file '"
-                                + inputFileCanonical.string() + "'" );
+        const auto* slash = static_cast< const char* >( std::memchr( input.begin(), '/', input.size() ) );
+        if( !slash ) break;
+
+        input = string_view( slash + 1, input.end() );
+    }
 
-    this->input_stack.push( clean( buffer ), inputFileCanonical );
+    return prefetched;
 }
 
 /*
@@ -332,7 +1685,7 @@ void ParserState::loadFile(const boost::filesystem::path& inputFile) {
  * of the data section of any keyword.
  */
 
-void ParserState::handleRandomText(const string_view& keywordString ) const {
+void ParserState::handleRandomText(const string_view& keywordString ) {
     std::string errorKey;
     std::stringstream msg;
     std::string trimmedCopy = keywordString.string();
@@ -349,46 +1702,52 @@ void ParserState::handleRandomText(const string_view& keywordString ) const {
             << this->current_path()
             << ":" << this->line();
     }
-    parseContext.handleError( errorKey , deck.getMessageContainer() , msg.str() );
+    parseContext.handleError( errorKey , this->messages() , msg.str() );
 }
 
 void ParserState::openRootFile( const boost::filesystem::path& inputFile) {
-    this->loadFile( inputFile );
-    this->deck.setDataFile( inputFile.string() );
     const boost::filesystem::path& inputFileCanonical = boost::filesystem::canonical(inputFile);
     rootPath = inputFileCanonical.parent_path();
+    this->loadFile( inputFile );
+    this->deck.setDataFile( inputFile.string() );
 }
 
-boost::filesystem::path ParserState::getIncludeFilePath( std::string path ) const {
-    static const std::string pathKeywordPrefix("$");
-    static const std::string validPathNameCharacters("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_");
+void ParserState::reopenFile( const Deck& parsed,
+                              const IncludeGraph::File& file,
+                              const boost::filesystem::path& root ) {
+    this->base = &parsed;
+    this->baseSize = file.firstKeyword;
+    this->pathMap = file.aliases;
+    this->rootPath = root;
 
-    size_t positionOfPathName = path.find(pathKeywordPrefix);
+    const auto* dims = this->sizingKeyword( "DIMENS" );
+    if( dims ) this->readGridDims( *dims );
 
-    if ( positionOfPathName != std::string::npos) {
-        std::string stringStartingAtPathName = path.substr(positionOfPathName+1);
-        size_t cutOffPosition = stringStartingAtPathName.find_first_not_of(validPathNameCharacters);
-        std::string stringToFind = stringStartingAtPathName.substr(0, cutOffPosition);
-        std::string stringToReplace = this->pathMap.at( stringToFind );
-        boost::replace_all(path, pathKeywordPrefix + stringToFind, stringToReplace);
-    }
+    for( auto index = this->baseSize; index > 0; --index ) {
+        const auto& name = parsed.getKeyword( index - 1 ).name();
+        if( !KeywordFilter::isSection( name ) ) continue;
 
-    // Check if there are any backslashes in the path...
-    if (path.find('\\') != std::string::npos) {
-        // ... if so, replace with slashes and create a warning.
-        std::replace(path.begin(), path.end(), '\\', '/');
-        deck.getMessageContainer().warning("Replaced one or more backslash with a slash in an INCLUDE path.");
+        this->section = name;
+        break;
     }
 
-    boost::filesystem::path includeFilePath(path);
+    this->loadFile( file.path );
+}
 
-    if (includeFilePath.is_relative())
-        return this->rootPath / includeFilePath;
+boost::filesystem::path ParserState::getIncludeFilePath( std::string path ) {
+    bool backslash = false;
+    auto includeFilePath = resolve_include( path, this->pathMap, this->rootPath, backslash );
+
+    if( backslash )
+        this->messages().warning("Replaced one or more backslash with a slash in an INCLUDE path.");
 
     return includeFilePath;
 }
 
 void ParserState::addPathAlias( const std::string& alias, const std::string& path ) {
+    /* the alias outlives the file it is defined in */
+    this->invalidateCaptures();
+    this->deck.getIncludeGraph()[ this->openFiles.back() ].paths = true;
     this->pathMap.emplace( alias, path );
 }
 
@@ -398,7 +1757,7 @@ std::shared_ptr< RawKeyword > createRawKeyword( const string_view& kw, ParserSta
     if( !parser.isRecognizedKeyword( keywordString ) ) {
         if( ParserKeyword::validDeckName( keywordString ) ) {
             std::string msg = "Keyword " + keywordString + " not recognized.";
-            auto& msgContainer = parserState.deck.getMessageContainer();
+            auto& msgContainer = parserState.messages();
             parserState.parseContext.handleError( ParseContext::PARSE_UNKNOWN_KEYWORD, msgContainer, msg );
             parserState.unknown_keyword = true;
             return {};
@@ -421,27 +1780,33 @@ std::shared_ptr< RawKeyword > createRawKeyword( const string_view& kw, ParserSta
                                 : Raw::UNKNOWN;
 
         return std::make_shared< RawKeyword >( keywordString, rawSizeType,
-                                                parserState.current_path().string(),
+                                                parserState.deck.getSourceNames(),
+                                                parserState.current_file(),
                                                 parserState.line() );
     }
 
     if( parserKeyword->hasFixedSize() ) {
         return std::make_shared< RawKeyword >( keywordString,
-                                                parserState.current_path().string(),
+                                                parserState.deck.getSourceNames(),
+                                                parserState.current_file(),
                                                 parserState.line(),
                                                 parserKeyword->getFixedSize(),
                                                 parserKeyword->isTableCollection() );
     }
 
+    /* the size is given by a keyword that may still be waiting to be decoded */
     const auto& keyword_size = parserKeyword->getKeywordSize();
-    const auto& deck = parserState.deck;
+    parserState.flush( keyword_size.keyword );
 
-    if( deck.hasKeyword(keyword_size.keyword ) ) {
-        const auto& sizeDefinitionKeyword = deck.getKeyword(keyword_size.keyword);
-        const auto& record = sizeDefinitionKeyword.getRecord(0);
+    const auto* sizeDefinitionKeyword = parserState.sizingKeyword( keyword_size.keyword );
+
+    if( sizeDefinitionKeyword ) {
+        const auto& record = sizeDefinitionKeyword->getRecord(0);
         const auto targetSize = record.getItem( keyword_size.item ).get< int >( 0 ) + keyword_size.shift;
+        parserState.addSizeDependency( keyword_size, sizeDefinitionKeyword, targetSize );
         return std::make_shared< RawKeyword >( keywordString,
-                                                parserState.current_path().string(),
+                                                parserState.deck.getSourceNames(),
+                                                parserState.current_file(),
                                                 parserState.line(),
                                                 targetSize,
                                                 parserKeyword->isTableCollection() );
@@ -449,7 +1814,7 @@ std::shared_ptr< RawKeyword > createRawKeyword( const string_view& kw, ParserSta
 
     std::string msg = "Expected the kewyord: " +keyword_size.keyword 
                     + " to infer the number of records in: " + keywordString;
-    auto& msgContainer = parserState.deck.getMessageContainer();
+    auto& msgContainer = parserState.messages();
     parserState.parseContext.handleError(ParseContext::PARSE_MISSING_DIMS_KEYWORD , msgContainer, msg );
 
     const auto* keyword = parser.getKeyword( keyword_size.keyword );
@@ -457,8 +1822,10 @@ std::shared_ptr< RawKeyword > createRawKeyword( const string_view& kw, ParserSta
     const auto& int_item = record.get( keyword_size.item);
 
     const auto targetSize = int_item.getDefault< int >( ) + keyword_size.shift;
+    parserState.addSizeDependency( keyword_size, nullptr, targetSize );
     return std::make_shared< RawKeyword >( keywordString,
-                                            parserState.current_path().string(),
+                                            parserState.deck.getSourceNames(),
+                                            parserState.current_file(),
                                             parserState.line(),
                                             targetSize,
                                             parserKeyword->isTableCollection() );
@@ -479,11 +1846,11 @@ bool tryParseKeyword( ParserState& parserState, const Parser& parser ) {
         if( line.empty() && !parserState.rawKeyword ) continue;
         if( line.empty() && !parserState.rawKeyword->is_title() ) continue;
 
-        std::string keywordString;
+        RawKeyword::DeckName deckName;
 
         if( parserState.rawKeyword == NULL ) {
-            if( RawKeyword::isKeywordPrefix( line, keywordString ) ) {
-                parserState.rawKeyword = createRawKeyword( keywordString, parserState, parser );
+            if( RawKeyword::classifyLine( line, deckName ) == Raw::LineType::KEYWORD ) {
+                parserState.rawKeyword = createRawKeyword( deckName.view(), parserState, parser );
             } else {
                 /* We are looking at some random gibberish?! */
                 if (!parserState.unknown_keyword)
@@ -491,7 +1858,8 @@ bool tryParseKeyword( ParserState& parserState, const Parser& parser ) {
             }
         } else {
             if (parserState.rawKeyword->getSizeType() == Raw::UNKNOWN) {
-                if( parser.isRecognizedKeyword( line ) ) {
+                if( RawKeyword::classifyLine( line, deckName ) == Raw::LineType::KEYWORD
+                    && parser.isRecognizedKeyword( line ) ) {
                     parserState.rawKeyword->finalizeUnknownSize();
                     parserState.nextKeyword = line;
                     return true;
@@ -517,18 +1885,35 @@ bool tryParseKeyword( ParserState& parserState, const Parser& parser ) {
     return false;
 }
 
-bool parseState( ParserState& parserState, const Parser& parser ) {
+/*
+ * Parse keywords until the end of the input or an END keyword, and return
+ * true. A streaming parse returns false as soon as a keyword is ready, and
+ * is picked up again by the next call.
+ */
+bool parseKeywords( ParserState& parserState, const Parser& parser ) {
 
     while( !parserState.done() ) {
 
+        if( !parserState.output.empty() )
+            return false;
+
         parserState.rawKeyword.reset();
 
+        /*
+         * The previous keyword is in the deck, so unless the next keyword has
+         * been peeked at nothing refers to the consumed input anymore.
+         */
+        if( parserState.nextKeyword.empty() )
+            parserState.releaseInput();
+
         const bool streamOK = tryParseKeyword( parserState, parser );
         if( !parserState.rawKeyword && !streamOK )
             continue;
 
-        if (parserState.rawKeyword->getKeywordName() == Opm::RawConsts::end)
+        if (parserState.rawKeyword->getKeywordName() == Opm::RawConsts::end) {
+            parserState.stopPrefetch();
             return true;
+        }
 
         if (parserState.rawKeyword->getKeywordName() == Opm::RawConsts::endinclude) {
             parserState.closeFile();
@@ -550,21 +1935,26 @@ bool parseState( ParserState& parserState, const Parser& parser ) {
             std::string includeFileAsString = readValueToken<std::string>(firstRecord.getItem(0));
             boost::filesystem::path includeFile = parserState.getIncludeFilePath( includeFileAsString );
 
-            parserState.loadFile( includeFile );
+            parserState.loadInclude( includeFile );
             continue;
         }
 
         if( parser.isRecognizedKeyword( parserState.rawKeyword->getKeywordName() ) ) {
             const auto& kwname = parserState.rawKeyword->getKeywordName();
             const auto* parserKeyword = parser.getParserKeywordFromDeckName( kwname );
-            parserState.deck.addKeyword( parserKeyword->parse( parserState.parseContext, parserState.deck.getMessageContainer(), parserState.rawKeyword ) );
+
+            if( kwname == "DIMENS" || kwname == "SPECGRID" )
+                parserState.readGridDims( *parserState.rawKeyword );
+
+            parserState.addKeyword( parserState.rawKeyword, parserKeyword );
         } else {
             DeckKeyword deckKeyword( parserState.rawKeyword->getKeywordName(), false );
             const std::string msg = "The keyword " + parserState.rawKeyword->getKeywordName() + " is not recognized";
-            deckKeyword.setLocation( parserState.rawKeyword->getFilename(),
+            deckKeyword.setLocation( parserState.rawKeyword->getSourceNames(),
+                    parserState.rawKeyword->getFileId(),
                     parserState.rawKeyword->getLineNR());
-            parserState.deck.addKeyword( std::move( deckKeyword ) );
-            parserState.deck.getMessageContainer().warning(
+            parserState.addKeyword( std::move( deckKeyword ) );
+            parserState.messages().warning(
                 parserState.current_path().string(), msg, parserState.line() );
         }
     }
@@ -572,22 +1962,193 @@ bool parseState( ParserState& parserState, const Parser& parser ) {
     return true;
 }
 
+bool parseState( ParserState& parserState, const Parser& parser ) {
+    try {
+        parseKeywords( parserState, parser );
+    } catch( ... ) {
+        /*
+         * A keyword still waiting to be decoded comes before the one that
+         * failed, and an error in it takes precedence.
+         */
+        parserState.flush();
+        throw;
+    }
+
+    parserState.flush();
+    parserState.closeFiles();
+    return true;
+}
+
+/* the path of a file as in the include graph */
+std::string graph_path( const std::string& path ) {
+    boost::system::error_code ec;
+    const auto canonical = boost::filesystem::canonical( path, ec );
+    return ec ? path : canonical.string();
+}
+
+bool has_paths( const IncludeGraph& graph, size_t first, size_t last ) {
+    for( auto file = first; file < last; ++file )
+        if( graph[ file ].paths ) return true;
+
+    return false;
+}
+
+const DeckKeyword* last_keyword( const Deck& deck, size_t first, size_t last, const std::string& name ) {
+    for( auto index = last; index > first; --index ) {
+        const auto& keyword = deck.getKeyword( index - 1 );
+        if( keyword.name() == name ) return &keyword;
+    }
+
+    return nullptr;
+}
+
+/*
+ * The names of the keywords whose last occurrence in [first, last) of deck is
+ * not the same as in updated. Only these can change the number of records of
+ * the keywords after them.
+ */
+std::set< std::string > changed_keywords( const Deck& deck, size_t first, size_t last, const Deck& updated ) {
+    std::set< std::string > names;
+    for( auto index = first; index < last; ++index )
+        names.insert( deck.getKeyword( index ).name() );
+
+    for( const auto& keyword : updated )
+        names.insert( keyword.name() );
+
+    std::set< std::string > changed;
+    for( const auto& name : names ) {
+        const auto* before = last_keyword( deck, first, last, name );
+        const auto* after = last_keyword( updated, 0, updated.size(), name );
+
+        if( !before || !after || !before->equal( *after ) )
+            changed.insert( name );
+    }
+
+    return changed;
+}
+
+bool intersects( const std::set< std::string >& lhs, const std::set< std::string >& rhs ) {
+    for( const auto& name : lhs )
+        if( rhs.count( name ) ) return true;
+
+    return false;
+}
+
+/* the items without a dimension are left as they are by convertToSI */
+void convert_to_si( DeckKeyword& keyword ) {
+    for( size_t r = 0; r < keyword.size(); ++r ) {
+        auto& record = keyword.getRecord( r );
+        for( size_t i = 0; i < record.size(); ++i ) {
+            auto& item = record.getItem( i );
+            if( item.getType() == type_tag::fdouble )
+                item.convertToSI();
+        }
+    }
+}
+
 }
 
 
-    /* stripComments only exists so that the unit tests can verify it.
-     * strip_comment is the actual (internal) implementation
+    /* stripComments only exists so that the unit tests can verify it, and
+     * serves as the reference for the comment handling in Cleaner::clean
+     * which is the actual (internal) implementation.
      */
     std::string Parser::stripComments( const std::string& str ) {
         return { str.begin(),
                  find_terminator( str.begin(), str.end(), find_comment() ) };
     }
 
-    Parser::Parser(bool addDefault) {
+    Parser::Parser(bool addDefault) :
+        m_defaultDeckKeywords( defaultDeckNames().slots(), nullptr )
+    {
         if (addDefault)
             addDefaultKeywords();
     }
 
+    void Parser::setParseThreads( size_t threads ) {
+        if( threads == 0 )
+            threads = std::max( 1U, std::thread::hardware_concurrency() );
+
+        this->m_parseThreads = threads;
+    }
+
+    size_t Parser::getParseThreads() const {
+        return this->m_parseThreads;
+    }
+
+    void Parser::setIncludePrefetchThreads( size_t threads ) {
+        this->m_prefetchThreads = threads;
+    }
+
+    size_t Parser::getIncludePrefetchThreads() const {
+        return this->m_prefetchThreads;
+    }
+
+    void Parser::setIncludePrefetchHook( PrefetchHook hook ) {
+        this->m_prefetchHook = std::move( hook );
+    }
+
+    void Parser::setDeckCacheDirectory( const std::string& directory ) {
+        this->m_deckCacheDirectory = directory;
+        if( !directory.empty() )
+            this->hashKeywords();
+    }
+
+    const std::string& Parser::getDeckCacheDirectory() const {
+        return this->m_deckCacheDirectory;
+    }
+
+    void Parser::setIncludeCache( std::shared_ptr< IncludeCache > cache ) {
+        this->m_includeCache = std::move( cache );
+        if( this->m_includeCache )
+            this->hashKeywords();
+    }
+
+    std::shared_ptr< IncludeCache > Parser::getIncludeCache() const {
+        return this->m_includeCache;
+    }
+
+    void Parser::setKeywordFilter( std::shared_ptr< const KeywordFilter > filter ) {
+        this->m_keywordFilter = std::move( filter );
+    }
+
+    std::shared_ptr< const KeywordFilter > Parser::getKeywordFilter() const {
+        return this->m_keywordFilter;
+    }
+
+    void Parser::setSIConversion( bool convert ) {
+        this->m_siConversion = convert;
+        if( !this->m_deckCacheDirectory.empty() || this->m_includeCache )
+            this->hashKeywords();
+    }
+
+    bool Parser::getSIConversion() const {
+        return this->m_siConversion;
+    }
+
+    /*
+     * The keywords are hashed through the code genkw would generate for them,
+     * which covers everything read from their definitions.
+     */
+    uint64_t Parser::getKeywordHash() const {
+        uint64_t hash = 0;
+        for( const auto& keyword : this->keyword_storage ) {
+            const auto code = keyword->createCode();
+            hash = DeckCache::hash( code.data(), code.size(), hash );
+        }
+
+        if( this->m_siConversion ) {
+            const std::string si = "SI";
+            hash = DeckCache::hash( si.data(), si.size(), hash );
+        }
+
+        return hash;
+    }
+
+    void Parser::hashKeywords() {
+        this->m_keywordHash = this->getKeywordHash();
+    }
+
 
     /*
      About INCLUDE: Observe that the ECLIPSE parser is slightly unlogical
@@ -642,7 +2203,58 @@ bool parseState( ParserState& parserState, const Parser& parser ) {
     }
 
     Deck Parser::parseFile(const std::string &dataFileName, const ParseContext& parseContext) const {
-        ParserState parserState( parseContext, dataFileName );
+        const bool cached = !this->m_deckCacheDirectory.empty() && !this->m_keywordFilter;
+
+        if( cached ) {
+            const DeckCache cache( this->m_deckCacheDirectory, this->m_keywordHash );
+            Deck deck;
+            if( cache.load( dataFileName, parseContext, deck ) ) {
+                deck.setDataFile( dataFileName );
+
+                if( this->m_prefetchHook )
+                    this->m_prefetchHook( 0, 0 );
+
+                return deck;
+            }
+        }
+
+        ParserState parserState( parseContext );
+        parserState.threads = this->m_parseThreads;
+        /* the placeholders of a filtered deck are checked against the stamps */
+        parserState.stamps = cached || this->m_keywordFilter;
+        if( this->m_keywordFilter )
+            parserState.enableFilter( this->m_keywordFilter, sizing_keywords( *this ) );
+
+        if( this->m_includeCache && !this->m_keywordFilter )
+            parserState.enableIncludeCache( this->m_includeCache,
+                                            DeckCache::hash( parseContext, this->m_keywordHash ) );
+        else
+            parserState.enablePrefetch( this->m_prefetchThreads, data_keywords( *this ) );
+        parserState.openRootFile( dataFileName );
+        parseState( parserState, *this );
+        applyUnitsToDeck( parserState.deck );
+
+        if( this->m_prefetchHook )
+            this->m_prefetchHook( parserState.prefetchHits, parserState.prefetchMisses );
+
+        if( cached ) {
+            const DeckCache cache( this->m_deckCacheDirectory, this->m_keywordHash );
+            cache.store( dataFileName,
+                         parseContext,
+                         parserState.deck.getIncludeGraph(),
+                         parserState.deck );
+        }
+
+        return std::move( parserState.deck );
+    }
+
+    Deck Parser::indexFile( const std::string& dataFileName, const ParseContext& parseContext ) const {
+        ParserState parserState( parseContext );
+        parserState.stamps = true;
+        parserState.enableFilter( std::make_shared< KeywordFilter >( KeywordFilter::allow( {} ) ),
+                                  sizing_keywords( *this ) );
+        parserState.enablePrefetch( this->m_prefetchThreads, data_keywords( *this ) );
+        parserState.openRootFile( dataFileName );
         parseState( parserState, *this );
         applyUnitsToDeck( parserState.deck );
 
@@ -651,24 +2263,419 @@ bool parseState( ParserState& parserState, const Parser& parser ) {
 
     Deck Parser::parseString(const std::string &data, const ParseContext& parseContext) const {
         ParserState parserState( parseContext );
+        parserState.threads = this->m_parseThreads;
+        if( this->m_keywordFilter )
+            parserState.enableFilter( this->m_keywordFilter, sizing_keywords( *this ) );
+
+        if( this->m_includeCache && !this->m_keywordFilter )
+            parserState.enableIncludeCache( this->m_includeCache,
+                                            DeckCache::hash( parseContext, this->m_keywordHash ) );
+        else
+            parserState.enablePrefetch( this->m_prefetchThreads, data_keywords( *this ) );
         parserState.loadString( data );
 
         parseState( parserState, *this );
         applyUnitsToDeck( parserState.deck );
 
+        if( this->m_prefetchHook )
+            this->m_prefetchHook( parserState.prefetchHits, parserState.prefetchMisses );
+
         return std::move( parserState.deck );
     }
 
+    /*
+     * The files are parsed again in the order they were opened. A file is
+     * parsed in the context of the deck before it, so the number of records
+     * of its keywords can be given by the keywords before it. When this
+     * changes keywords that size keywords further down, the files of those
+     * are parsed again too.
+     *
+     * The files that cannot be parsed on their own, such as the data file,
+     * or one whose last keyword continues in the file that includes it, and
+     * changes with effects that are not tracked, such as to the PATHS
+     * aliases or the unit system, make for parsing the whole deck again.
+     */
+    size_t Parser::updateDeck( Deck& deck,
+                               const std::vector< std::string >& changedFiles,
+                               const ParseContext& parseContext ) const {
+        auto& graph = deck.getIncludeGraph();
+        if( graph.empty() || graph.ended() )
+            return this->reparseDeck( deck, parseContext );
+
+        std::set< std::string > changed;
+        for( const auto& file : changedFiles )
+            changed.insert( graph_path( file ) );
+
+        /* a file that did not exist was recorded with the path it was included by */
+        std::set< size_t > pending;
+        for( size_t i = 0; i < graph.size(); ++i ) {
+            if( changed.count( graph[ i ].path ) || changed.count( graph_path( graph[ i ].path ) ) )
+                pending.insert( i );
+        }
+
+        const auto root = boost::filesystem::path( graph[ 0 ].path ).parent_path();
+        size_t parsed = 0;
+
+        while( !pending.empty() ) {
+            auto index = *pending.begin();
+            pending.erase( pending.begin() );
+
+            while( graph[ index ].spans && graph[ index ].parent != IncludeGraph::npos )
+                index = graph[ index ].parent;
+
+            if( graph[ index ].parent == IncludeGraph::npos )
+                return this->reparseDeck( deck, parseContext );
+
+            const auto file = graph[ index ];
+            const auto last = graph.last( index );
+
+            ParserState state( parseContext );
+            state.threads = this->m_parseThreads;
+            if( this->m_keywordFilter )
+                state.enableFilter( this->m_keywordFilter, sizing_keywords( *this ) );
+
+            if( this->m_includeCache && !this->m_keywordFilter )
+                state.enableIncludeCache( this->m_includeCache,
+                                          DeckCache::hash( parseContext, this->m_keywordHash ) );
+
+            state.reopenFile( deck, file, root );
+            parseState( state, *this );
+
+            const auto& files = state.deck.getIncludeGraph();
+            if( files.ended()
+             || has_paths( graph, index, last )
+             || has_paths( files, 0, files.size() ) )
+                return this->reparseDeck( deck, parseContext );
+
+            this->applyUnitsToKeywords( deck, state.deck );
+
+            const auto keywords = changed_keywords( deck, file.firstKeyword, file.lastKeyword, state.deck );
+            for( const auto& units : { "FIELD", "METRIC", "LAB", "PVT-M" } ) {
+                if( keywords.count( units ) )
+                    return this->reparseDeck( deck, parseContext );
+            }
+
+            deck.replaceKeywords( file.firstKeyword,
+                                  file.lastKeyword,
+                                  { std::make_move_iterator( state.deck.begin() ),
+                                    std::make_move_iterator( state.deck.end() ) } );
+
+            auto& messages = deck.getMessageContainer();
+            MessageContainer updated;
+            auto message = messages.begin();
+            for( size_t i = 0; i < file.firstMessage; ++i, ++message )
+                updated.add( *message );
+
+            updated.appendMessages( state.deck.getMessageContainer() );
+            std::advance( message, file.lastMessage - file.firstMessage );
+            for( ; message != messages.end(); ++message )
+                updated.add( *message );
+
+            messages = std::move( updated );
+
+            graph.replace( index, files );
+            parsed += files.size();
+
+            /* the files in the one parsed again are gone */
+            const auto newLast = index + files.size();
+            std::set< size_t > next;
+            for( const auto i : pending ) {
+                if( i < index ) next.insert( i );
+                if( i >= last ) next.insert( i - last + newLast );
+            }
+
+            for( size_t i = 0; i < graph.size(); ++i ) {
+                if( i >= index && i < newLast ) continue;
+                if( i < index && !graph.includes( i, index ) ) continue;
+                if( !intersects( graph[ i ].sizedBy, keywords ) ) continue;
+
+                if( graph[ i ].parent == IncludeGraph::npos )
+                    return this->reparseDeck( deck, parseContext );
+
+                next.insert( i );
+            }
+
+            pending = std::move( next );
+        }
+
+        return parsed;
+    }
+
+    size_t Parser::reparseDeck( Deck& deck, const ParseContext& parseContext ) const {
+        const auto dataFile = deck.getDataFile();
+        if( dataFile.empty() )
+            throw std::invalid_argument( "Only a deck parsed from a file can be parsed again" );
+
+        auto parsed = this->parseFile( dataFile, parseContext );
+
+        deck.replaceKeywords( 0,
+                              deck.size(),
+                              { std::make_move_iterator( parsed.begin() ),
+                                std::make_move_iterator( parsed.end() ) } );
+
+        deck.getMessageContainer() = parsed.getMessageContainer();
+        deck.getDefaultUnitSystem() = parsed.getDefaultUnitSystem();
+        deck.getActiveUnitSystem() = parsed.getActiveUnitSystem();
+        deck.getIncludeGraph() = parsed.getIncludeGraph();
+
+        return deck.getIncludeGraph().size();
+    }
+
+    /*
+     * The records are found again as when the file was parsed, from the
+     * lines of the extent of the placeholder.
+     */
+    /*
+     * The files are read rather than mapped, as the pages of a private
+     * mapping that the cleaner did not write to may still change with the
+     * file.
+     */
+    struct DecodeCache::Impl {
+        string_view content( const std::string& path,
+                             const IncludeGraph& graph,
+                             const std::string& changed );
+
+        struct file {
+            std::shared_ptr< input_buffer > buffer;
+            /* the stamp of the bytes that were read */
+            IncludeGraph::Stamp stamp;
+        };
+
+        std::map< std::string, file > files;
+    };
+
+    string_view DecodeCache::Impl::content( const std::string& path,
+                                            const IncludeGraph& graph,
+                                            const std::string& changed ) {
+        IncludeGraph::Stamp parsed;
+        for( const auto& f : graph ) {
+            if( f.path == path ) parsed = f.stamp;
+        }
+
+        auto& cached = this->files[ path ];
+        if( cached.buffer && cached.stamp.valid ) {
+            /* touched or changed since it was read, so it is read again */
+            boost::system::error_code ec;
+            const auto size = boost::filesystem::file_size( path, ec );
+            const int64_t mtime = ec ? 0 : boost::filesystem::last_write_time( path, ec );
+            if( ec || size != cached.stamp.size || mtime != cached.stamp.mtime )
+                cached.buffer.reset();
+        }
+
+        if( cached.buffer ) return cached.buffer->content();
+
+        cached.stamp = IncludeGraph::Stamp();
+        cached.buffer = read_file( path, &cached.stamp );
+        if( !cached.buffer ) {
+            this->files.erase( path );
+            throw std::invalid_argument( "Cannot read the file " + path );
+        }
+
+        if( parsed.valid && ( !cached.stamp.valid
+                           || cached.stamp.size != parsed.size
+                           || cached.stamp.digest != parsed.digest ) ) {
+            this->files.erase( path );
+            throw std::invalid_argument( changed );
+        }
+
+        return cached.buffer->content();
+    }
+
+    DecodeCache::DecodeCache() :
+        impl( new Impl() )
+    {}
+
+    DecodeCache::~DecodeCache() = default;
+
+    size_t DecodeCache::size() const {
+        return this->impl->files.size();
+    }
+
+    void DecodeCache::clear() {
+        this->impl->files.clear();
+    }
+
+    DeckKeyword Parser::decodeKeyword( const Deck& deck,
+                                       const DeckKeyword& placeholder,
+                                       const ParseContext& parseContext,
+                                       DecodeCache* cache ) const {
+        if( !placeholder.isPlaceholder() ) return placeholder;
+
+        DecodeCache once;
+        if( !cache ) cache = &once;
+
+        const auto& name = placeholder.name();
+        const auto& path = placeholder.getFileName();
+        const auto changed = "The file " + path + " has changed since the keyword " + name + " was parsed";
+
+        const auto content = cache->impl->content( path, deck.getIncludeGraph(), changed );
+        const auto offset = placeholder.getInputOffset();
+        const auto length = placeholder.getInputLength();
+
+        if( offset + length > content.size() )
+            throw std::invalid_argument( changed );
+
+        auto rawKeyword = std::make_shared< RawKeyword >( name,
+                                                          placeholder.getSourceNames(),
+                                                          placeholder.getFileId(),
+                                                          placeholder.getLineNumber(),
+                                                          placeholder.getSkippedRecords() );
+
+        string_view input( content.begin() + offset, content.begin() + offset + length );
+        string_view line;
+        while( !rawKeyword->isFinished() && Opm::getline( input, line ) ) {
+            if( !line.empty() ) rawKeyword->addRawRecordString( line );
+        }
+
+        if( !rawKeyword->isFinished() || !input.empty() )
+            throw std::invalid_argument( changed );
+
+        const auto* parserKeyword = this->getParserKeywordFromDeckName( name );
+        auto keyword = parserKeyword->parse( parseContext, deck.getMessageContainer(), rawKeyword,
+                                             0, deck.getSymbols() );
+        if( !parserKeyword->hasDimension() ) return keyword;
+
+        Deck units;
+        units.getDefaultUnitSystem() = deck.getDefaultUnitSystem();
+        units.getActiveUnitSystem() = deck.getActiveUnitSystem();
+        parserKeyword->applyUnitsToDeck( units, keyword );
+        if( this->m_siConversion )
+            convert_to_si( keyword );
+
+        return keyword;
+    }
+
+    /*
+     * The reader drives the ParserState of the parser, so it lives here
+     * rather than in a file of its own.
+     */
+    struct DeckReader::Impl {
+        Impl( const Parser& p, const ParseContext& context ) :
+            parser( p ),
+            parseContext( context ),
+            state( this->parseContext )
+        {}
+
+        void applyUnits( DeckKeyword& );
+
+        const Parser& parser;
+        const ParseContext parseContext;
+        ParserState state;
+        bool finished = false;
+        bool read = false;
+        int units = 0;
+    };
+
+    /*
+     * The unit system keywords are preferred as in Parser::applyUnitsToDeck,
+     * but only apply to the keywords that come after them.
+     */
+    void DeckReader::Impl::applyUnits( DeckKeyword& keyword ) {
+        const auto& name = keyword.name();
+        auto& active = this->state.deck.getActiveUnitSystem();
+
+        if( name == "LAB" && this->units < 1 ) {
+            active = UnitSystem::newLAB();
+            this->units = 1;
+        }
+        if( name == "FIELD" && this->units < 2 ) {
+            active = UnitSystem::newFIELD();
+            this->units = 2;
+        }
+        if( name == "METRIC" && this->units < 3 ) {
+            active = UnitSystem::newMETRIC();
+            this->units = 3;
+        }
+
+        if( !this->parser.isRecognizedKeyword( name ) ) return;
+
+        const auto* parserKeyword = this->parser.getParserKeywordFromDeckName( name );
+        if( !parserKeyword->hasDimension() ) return;
+
+        parserKeyword->applyUnitsToDeck( this->state.deck, keyword );
+        if( this->parser.getSIConversion() )
+            convert_to_si( keyword );
+    }
+
+    DeckReader::DeckReader( const Parser& parser,
+                            const std::string& dataFile,
+                            const ParseContext& parseContext ) :
+        impl( new Impl( parser, parseContext ) )
+    {
+        auto& state = this->impl->state;
+        if( parser.getKeywordFilter() )
+            state.enableFilter( parser.getKeywordFilter(), sizing_keywords( parser ) );
+
+        state.enableStreaming( sizing_keywords( parser ) );
+        state.enablePrefetch( parser.getIncludePrefetchThreads(), data_keywords( parser ) );
+        state.openRootFile( dataFile );
+    }
+
+    DeckReader::~DeckReader() = default;
+
+    const DeckKeyword* DeckReader::next() {
+        auto& state = this->impl->state;
+
+        if( this->impl->read ) {
+            state.output.pop_front();
+            this->impl->read = false;
+        }
+
+        while( state.output.empty() && !this->impl->finished ) {
+            if( !parseKeywords( state, this->impl->parser ) ) continue;
+
+            state.flush();
+            state.closeFiles();
+            this->impl->finished = true;
+        }
+
+        if( state.output.empty() ) return nullptr;
+
+        this->impl->applyUnits( state.output.front() );
+        this->impl->read = true;
+        return &state.output.front();
+    }
+
+    const MessageContainer& DeckReader::getMessageContainer() const {
+        return this->impl->state.deck.getMessageContainer();
+    }
+
+    const UnitSystem& DeckReader::getDefaultUnitSystem() const {
+        return this->impl->state.deck.getDefaultUnitSystem();
+    }
+
+    const UnitSystem& DeckReader::getActiveUnitSystem() const {
+        return this->impl->state.deck.getActiveUnitSystem();
+    }
+
     size_t Parser::size() const {
-        return m_deckParserKeywords.size();
+        const auto added = std::count_if( m_defaultDeckKeywords.begin(),
+                                          m_defaultDeckKeywords.end(),
+                                          []( const ParserKeyword* kw ) { return kw != nullptr; } );
+
+        return added + m_deckParserKeywords.size();
     }
 
     const ParserKeyword* Parser::matchingKeyword(const string_view& name) const {
-        for (auto iter = m_wildCardKeywords.begin(); iter != m_wildCardKeywords.end(); ++iter) {
-            if (iter->second->matches(name))
-                return iter->second;
-        }
-        return nullptr;
+        return m_wildCardPrefixes.match( name );
+    }
+
+    /*
+     * The keyword with exactly this deck name. The deck names of the default
+     * keywords are found by one hash and compare, also when the keyword has
+     * been replaced or the parser was created without the default keywords,
+     * so the map is only searched for the deck names that are not default.
+     */
+    const ParserKeyword* Parser::deckKeyword(const string_view& name) const {
+        const auto slot = defaultDeckNames().find( name );
+        if( slot != DeckNameHash::npos )
+            return m_defaultDeckKeywords[ slot ];
+
+        const auto candidate = m_deckParserKeywords.find( name );
+        if( candidate == m_deckParserKeywords.end() )
+            return nullptr;
+
+        return candidate->second;
     }
 
     bool Parser::hasWildCardKeyword(const std::string& internalKeywordName) const {
@@ -679,7 +2686,7 @@ bool parseState( ParserState& parserState, const Parser& parser ) {
         if( !ParserKeyword::validDeckName( name ) )
             return false;
 
-        if( m_deckParserKeywords.count( name ) )
+        if( deckKeyword( name ) )
             return true;
 
         return bool( matchingKeyword( name ) );
@@ -708,17 +2715,30 @@ void Parser::addParserKeyword( std::unique_ptr< const ParserKeyword >&& parserKe
 
     this->keyword_storage.push_back( std::move( parserKeyword ) );
 
+    const auto& defaultNames = defaultDeckNames();
     for (auto nameIt = ptr->deckNamesBegin();
             nameIt != ptr->deckNamesEnd();
             ++nameIt)
     {
-        m_deckParserKeywords[ *nameIt ] = ptr;
+        const auto slot = defaultNames.find( *nameIt );
+        if( slot != DeckNameHash::npos )
+            m_defaultDeckKeywords[ slot ] = ptr;
+        else
+            m_deckParserKeywords[ *nameIt ] = ptr;
     }
 
     if (ptr->hasMatchRegex()) {
         m_wildCardKeywords[ name ] = ptr;
+
+        /* a keyword can replace a wildcard keyword of the same name */
+        m_wildCardPrefixes.clear();
+        for( const auto& wildcard : m_wildCardKeywords )
+            m_wildCardPrefixes.add( wildcard.second->getMatchRegex(), wildcard.second );
     }
 
+    /* the decks and files cached with the old keywords must not be used */
+    if( !m_deckCacheDirectory.empty() || m_includeCache )
+        this->hashKeywords();
 }
 
 
@@ -727,8 +2747,7 @@ void Parser::addParserKeyword(const Json::JsonObject& jsonKeyword) {
 }
 
 bool Parser::hasKeyword( const std::string& name ) const {
-    return this->m_deckParserKeywords.find( string_view( name ) )
-        != this->m_deckParserKeywords.end();
+    return this->deckKeyword( string_view( name ) ) != nullptr;
 }
 
 const ParserKeyword* Parser::getKeyword( const std::string& name ) const {
@@ -736,9 +2755,9 @@ const ParserKeyword* Parser::getKeyword( const std::string& name ) const {
 }
 
 const ParserKeyword* Parser::getParserKeywordFromDeckName(const string_view& name ) const {
-    auto candidate = m_deckParserKeywords.find( name );
+    const auto* candidate = deckKeyword( name );
 
-    if( candidate != m_deckParserKeywords.end() ) return candidate->second;
+    if( candidate ) return candidate;
 
     const auto* wildCardKeyword = matchingKeyword( name );
 
@@ -750,9 +2769,15 @@ const ParserKeyword* Parser::getParserKeywordFromDeckName(const string_view& nam
 
 std::vector<std::string> Parser::getAllDeckNames () const {
     std::vector<std::string> keywords;
+    const auto& defaultKeys = defaultDeckNames().keys();
+    for (size_t slot = 0; slot < m_defaultDeckKeywords.size(); slot++) {
+        if (m_defaultDeckKeywords[slot])
+            keywords.push_back(DeckNameHash::unpack(defaultKeys[slot]));
+    }
     for (auto iterator = m_deckParserKeywords.begin(); iterator != m_deckParserKeywords.end(); iterator++) {
         keywords.push_back(iterator->first.string());
     }
+    std::sort(keywords.begin(), keywords.end());
     for (auto iterator = m_wildCardKeywords.begin(); iterator != m_wildCardKeywords.end(); iterator++) {
         keywords.push_back(iterator->first.string());
     }
@@ -816,7 +2841,11 @@ std::vector<std::string> Parser::getAllDeckNames () const {
         if( deck.hasKeyword( "METRIC" ) )
             deck.getActiveUnitSystem() = UnitSystem::newMETRIC();
 
-        for( auto& deckKeyword : deck ) {
+        this->applyUnitsToKeywords( deck, deck );
+    }
+
+    void Parser::applyUnitsToKeywords( Deck& deck, Deck& keywords ) const {
+        for( auto& deckKeyword : keywords ) {
 
             if( !isRecognizedKeyword( deckKeyword.name() ) ) continue;
 
@@ -824,6 +2853,8 @@ std::vector<std::string> Parser::getAllDeckNames () const {
             if( !parserKeyword->hasDimension() ) continue;
 
             parserKeyword->applyUnitsToDeck(deck , deckKeyword);
+            if( this->m_siConversion )
+                convert_to_si( deckKeyword );
         }
     }
 
@@ -17,6 +17,7 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <ostream>
 #include <sstream>
 
@@ -355,36 +356,73 @@ std::string ParserItem::createCode() const {
 namespace {
 
 template< typename T >
-DeckItem scan_item( const ParserItem& p, RawRecord& record ) {
-    DeckItem item( p.name(), T(), record.size() );
+void scan_token( const ParserItem& p, const string_view& token, DeckItem& item ) {
+    string_view countString;
+    string_view valueString;
 
-    if( p.sizeType() == ParserItem::item_size::ALL ) {
-        while( record.size() > 0 ) {
-            auto token = record.pop_front();
+    if( !isStarToken( token, countString, valueString ) ) {
+        item.push_back( readValueToken< T >( token ) );
+        return;
+    }
 
-            std::string countString;
-            std::string valueString;
+    StarToken st(token, countString, valueString);
 
-            if( !isStarToken( token, countString, valueString ) ) {
-                item.push_back( readValueToken< T >( token ) );
-                continue;
-            }
+    if( st.hasValue() ) {
+        item.push_back( readValueToken< T >( st.valueString() ), st.count() );
+        return;
+    }
+
+    item.push_backDefault( p.getDefault< T >(), st.count() );
+}
 
-            StarToken st(token, countString, valueString);
+/* the string values are interned in the symbol table of the deck */
+template< typename T >
+DeckItem new_item( const ParserItem& p, size_t size_hint, const std::shared_ptr< SymbolTable >& ) {
+    return DeckItem( p.name(), T(), size_hint );
+}
 
-            if( st.hasValue() ) {
-                item.push_back( readValueToken< T >( st.valueString() ), st.count() );
-                continue;
-            }
+template<>
+DeckItem new_item< std::string >( const ParserItem& p, size_t size_hint,
+                                  const std::shared_ptr< SymbolTable >& symbols ) {
+    return DeckItem( p.name(), std::string(), size_hint, symbols );
+}
 
-            auto value = p.getDefault< T >();
-            for (size_t i=0; i < st.count(); i++)
-                item.push_backDefault( value );
-        }
+template< typename T >
+DeckItem scan_all( const ParserItem& p, RawRecord& record, size_t size_hint,
+                   const std::shared_ptr< SymbolTable >& symbols ) {
+    string_view input;
+    if( !record.popRecordString( input ) ) {
+        auto item = new_item< T >( p, record.size(), symbols );
+        while( record.size() > 0 )
+            scan_token< T >( p, record.pop_front(), item );
 
         return item;
     }
 
+    /*
+     * Nothing has been read from the record, so the values are read straight
+     * from the record string instead of going through its tokens. Without
+     * repetitions there is at most one value per two characters, which bounds
+     * the reservation if the hint is larger than the keyword.
+     */
+    auto item = new_item< T >( p, std::min( size_hint, input.size() / 2 + 1 ), symbols );
+    auto current = input.begin();
+    while( current != input.end() ) {
+        const auto token = RawRecord::nextToken( current, input.end() );
+        if( !token.empty() ) scan_token< T >( p, token, item );
+    }
+
+    return item;
+}
+
+template< typename T >
+DeckItem scan_item( const ParserItem& p, RawRecord& record, size_t size_hint,
+                    const std::shared_ptr< SymbolTable >& symbols ) {
+    if( p.sizeType() == ParserItem::item_size::ALL )
+        return scan_all< T >( p, record, size_hint, symbols );
+
+    auto item = new_item< T >( p, 1, symbols );
+
     if( record.size() == 0 ) {
         // if the record was ended prematurely,
         if( p.hasDefault() ) {
@@ -402,8 +440,8 @@ DeckItem scan_item( const ParserItem& p, RawRecord& record ) {
     // The '*' should be interpreted as a repetition indicator, but it must
     // be preceeded by an integer...
     auto token = record.pop_front();
-    std::string countString;
-    std::string valueString;
+    string_view countString;
+    string_view valueString;
     if( !isStarToken(token, countString, valueString) ) {
         item.push_back( readValueToken<T>( token ) );
         return item;
@@ -418,16 +456,15 @@ DeckItem scan_item( const ParserItem& p, RawRecord& record ) {
     else
         item.push_backDummyDefault();
 
-    const auto value_start = token.size() - valueString.size();
     // replace the first occurence of "N*FOO" by a sequence of N-1 times
     // "FOO". this is slightly hacky, but it makes it work if the
     // number of defaults pass item boundaries...
     // We can safely make a string_view of one_star because it
-    // has static storage
+    // has static storage, and the value is a view into the token
     static const char* one_star = "1*";
     string_view rep = !st.hasValue()
                     ? string_view{ one_star }
-                    : string_view{ token.begin() + value_start, token.end() };
+                    : st.valueString();
     record.prepend( st.count() - 1, rep );
 
     return item;
@@ -437,27 +474,34 @@ DeckItem scan_item( const ParserItem& p, RawRecord& record ) {
 
 
 /// Scans the records data according to the ParserItems definition.
-/// returns a DeckItem object.
+/// returns a DeckItem object. The size hint is the expected number of
+/// values of an item of size ALL.
 /// NOTE: data are popped from the records deque!
-DeckItem ParserItem::scan( RawRecord& record ) const {
+DeckItem ParserItem::scan( RawRecord& record, size_t size_hint,
+                           const std::shared_ptr< SymbolTable >& symbols ) const {
     switch( this->type ) {
         case type_tag::integer:
-            return scan_item< int >( *this, record );
+            return scan_item< int >( *this, record, size_hint, symbols );
         case type_tag::fdouble:
-            return scan_item< double >( *this, record );
+            return scan_item< double >( *this, record, size_hint, symbols );
         case type_tag::string:
-            return scan_item< std::string >( *this, record );
+            return scan_item< std::string >( *this, record, size_hint, symbols );
         default:
             throw std::logic_error( "Fatal error; should not be reachable" );
     }
 }
 
-std::ostream& ParserItem::inlineClass( std::ostream& stream, const std::string& indent ) const {
+/*
+ * The index is the position of the item in its record, which is where
+ * DeckRecord::getItem< Item >() looks for it first.
+ */
+std::ostream& ParserItem::inlineClass( std::ostream& stream, const std::string& indent, size_t index ) const {
     std::string local_indent = indent + "    ";
 
     stream << indent << "class " << this->className() << " {" << std::endl
            << indent << "public:" << std::endl
-           << local_indent << "static const std::string itemName;" << std::endl;
+           << local_indent << "static const std::string itemName;" << std::endl
+           << local_indent << "static constexpr size_t itemIndex = " << index << ";" << std::endl;
 
     if( this->hasDefault() ) {
         stream << local_indent << "static const "
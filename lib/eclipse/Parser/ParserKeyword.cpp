@@ -477,12 +477,14 @@ void set_dimensions( ParserItem& item,
 
     DeckKeyword ParserKeyword::parse(const ParseContext& parseContext,
                                      MessageContainer& msgContainer,
-                                     std::shared_ptr< RawKeyword > rawKeyword) const {
+                                     std::shared_ptr< RawKeyword > rawKeyword,
+                                     size_t dataSizeHint,
+                                     const std::shared_ptr< SymbolTable >& symbols) const {
         if( !rawKeyword->isFinished() )
             throw std::invalid_argument("Tried to create a deck keyword from an incomplete raw keyword " + rawKeyword->getKeywordName());
 
         DeckKeyword keyword( rawKeyword->getKeywordName() );
-        keyword.setLocation( rawKeyword->getFilename(), rawKeyword->getLineNR() );
+        keyword.setLocation( rawKeyword->getSourceNames(), rawKeyword->getFileId(), rawKeyword->getLineNR() );
         keyword.setDataKeyword( isDataKeyword() );
 
         size_t record_nr = 0;
@@ -490,7 +492,7 @@ void set_dimensions( ParserItem& item,
             if( m_records.size() == 0 && rawRecord.size() > 0 )
                 throw std::invalid_argument("Missing item information " + rawKeyword->getKeywordName());
 
-            keyword.addRecord( getRecord( record_nr ).parse( parseContext, msgContainer, rawRecord ) );
+            keyword.addRecord( getRecord( record_nr ).parse( parseContext, msgContainer, rawRecord, dataSizeHint, symbols ) );
             record_nr++;
         }
 
@@ -538,6 +540,10 @@ void set_dimensions( ParserItem& item,
         return !m_matchRegexString.empty();
     }
 
+    const std::string& ParserKeyword::getMatchRegex() const {
+        return m_matchRegexString;
+    }
+
     void ParserKeyword::setMatchRegex(const std::string& deckNameRegexp) {
         try {
             m_matchRegex = boost::regex(deckNameRegexp);
@@ -576,9 +582,10 @@ void set_dimensions( ParserItem& item,
             ss << local_indent << "static const std::string keywordName;" << std::endl;
             if (m_records.size() > 0 ) {
                 for( const auto& record : *this ) {
+                    size_t index = 0;
                     for( const auto& item : record ) {
                         ss << std::endl;
-                        item.inlineClass(ss , local_indent );
+                        item.inlineClass(ss , local_indent, index++ );
                     }
                 }
             }
@@ -124,11 +124,18 @@ namespace {
         return *itr;
     }
 
-    DeckRecord ParserRecord::parse(const ParseContext& parseContext , MessageContainer& msgContainer, RawRecord& rawRecord ) const {
+    /*
+      The data size hint is the expected number of values in the record of a
+      data keyword, e.g. the number of cells for PORO, and is ignored for other
+      records.
+    */
+    DeckRecord ParserRecord::parse(const ParseContext& parseContext , MessageContainer& msgContainer, RawRecord& rawRecord, size_t dataSizeHint,
+                                   const std::shared_ptr< SymbolTable >& symbols ) const {
         std::vector< DeckItem > items;
-        items.reserve( this->size() + 20 );
+        items.reserve( this->size() );
+        const size_t sizeHint = m_dataRecord ? dataSizeHint : 0;
         for( const auto& parserItem : *this )
-            items.emplace_back( parserItem.scan( rawRecord ) );
+            items.emplace_back( parserItem.scan( rawRecord, sizeHint, symbols ) );
 
         if (rawRecord.size() > 0) {
             std::string msg = "The RawRecord for keyword \""  + rawRecord.getKeywordName() + "\" in file\"" + rawRecord.getFileName() + "\" contained " +
@@ -0,0 +1,234 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+#include <opm/parser/eclipse/RawDeck/Cleaner.hpp>
+#include <opm/parser/eclipse/RawDeck/RawConsts.hpp>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define OPM_CLEANER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Opm {
+namespace Cleaner {
+
+namespace {
+
+/*
+ * The characters the cleaner has to look at: newline, the comment marker,
+ * slash and quotes. Like everywhere else in the raw parser only the 7 lowest
+ * bits of a character decide if it is a quote.
+ */
+inline bool is_special( char ch ) {
+    return ch == '\n' || ch == '-' || ch == '/' || RawConsts::is_quote()( ch );
+}
+
+const char* find_special_scalar( const char* begin, const char* end ) {
+    return std::find_if( begin, end, is_special );
+}
+
+#ifdef OPM_CLEANER_X86
+
+__attribute__(( target( "sse4.2" ) ))
+const char* find_special_sse42( const char* begin, const char* end ) {
+    const auto set = _mm_setr_epi8( '\n', '-', '/', '\'', '"',
+                                    char( '\'' | 0x80 ), char( '"' | 0x80 ),
+                                    0, 0, 0, 0, 0, 0, 0, 0, 0 );
+    const int mode = _SIDD_UBYTE_OPS
+                   | _SIDD_CMP_EQUAL_ANY
+                   | _SIDD_LEAST_SIGNIFICANT;
+
+    for( ; end - begin >= 16; begin += 16 ) {
+        const auto block = _mm_loadu_si128( (const __m128i*) begin );
+        const int i = _mm_cmpestri( set, 7, block, 16, mode );
+        if( i < 16 ) return begin + i;
+    }
+
+    return find_special_scalar( begin, end );
+}
+
+__attribute__(( target( "avx2" ) ))
+inline unsigned int special_mask_avx2( const char* ptr ) {
+    const auto block = _mm256_loadu_si256( (const __m256i*) ptr );
+    const auto ascii = _mm256_and_si256( block, _mm256_set1_epi8( 0x7f ) );
+
+    const auto nl = _mm256_cmpeq_epi8( block, _mm256_set1_epi8( '\n' ) );
+    const auto dash = _mm256_cmpeq_epi8( block, _mm256_set1_epi8( '-' ) );
+    const auto slash = _mm256_cmpeq_epi8( block, _mm256_set1_epi8( '/' ) );
+    const auto sq = _mm256_cmpeq_epi8( ascii, _mm256_set1_epi8( '\'' ) );
+    const auto dq = _mm256_cmpeq_epi8( ascii, _mm256_set1_epi8( '"' ) );
+
+    const auto any = _mm256_or_si256( _mm256_or_si256( nl, dash ),
+                                      _mm256_or_si256( slash,
+                                                       _mm256_or_si256( sq, dq ) ) );
+    return _mm256_movemask_epi8( any );
+}
+
+__attribute__(( target( "avx2" ) ))
+const char* find_special_avx2( const char* begin, const char* end ) {
+    /*
+     * Data lines are long runs of digits and spaces, so look at 64 bytes per
+     * iteration and only narrow down when something was found.
+     */
+    for( ; end - begin >= 64; begin += 64 ) {
+        const auto lo = special_mask_avx2( begin );
+        const auto hi = special_mask_avx2( begin + 32 );
+        if( lo ) return begin + __builtin_ctz( lo );
+        if( hi ) return begin + 32 + __builtin_ctz( hi );
+    }
+
+    if( end - begin >= 32 ) {
+        const auto mask = special_mask_avx2( begin );
+        if( mask ) return begin + __builtin_ctz( mask );
+        begin += 32;
+    }
+
+    return find_special_scalar( begin, end );
+}
+
+#endif
+
+using find_special = const char* (*)( const char*, const char* );
+
+find_special finder( ISA isa ) {
+    if( !supported( isa ) )
+        throw std::invalid_argument( "Cleaner: instruction set not supported" );
+
+#ifdef OPM_CLEANER_X86
+    switch( isa ) {
+        case ISA::avx2:  return find_special_avx2;
+        case ISA::sse42: return find_special_sse42;
+        default: break;
+    }
+#endif
+
+    return find_special_scalar;
+}
+
+/*
+ * Find where the interesting part of the line starting at begin ends, and
+ * where the line itself ends. The line is cut at the first comment marker or
+ * after the first slash that isn't quoted. A line with a quote that is not
+ * closed before the end of the line is kept as it is.
+ */
+inline void find_cut( const char* begin, const char* end, find_special find,
+                      const char*& cut, const char*& eol ) {
+
+    auto* ptr = find( begin, end );
+
+    while( ptr != end && *ptr != '\n' ) {
+        const auto ch = *ptr;
+
+        if( ch == '/' ) {
+            cut = ptr + 1;
+            break;
+        }
+
+        if( ch == '-' ) {
+            if( ptr + 1 != end && *( ptr + 1 ) == '-' ) {
+                cut = ptr;
+                break;
+            }
+
+            ptr = find( ptr + 1, end );
+            continue;
+        }
+
+        /* skip the quoted string, ignoring anything else inside it */
+        ptr = find( ptr + 1, end );
+        while( ptr != end && *ptr != '\n' && *ptr != ch )
+            ptr = find( ptr + 1, end );
+
+        if( ptr == end || *ptr == '\n' ) break;
+
+        ptr = find( ptr + 1, end );
+    }
+
+    if( ptr == end || *ptr == '\n' ) {
+        cut = eol = ptr;
+        return;
+    }
+
+    eol = static_cast< const char* >( std::memchr( cut, '\n', end - cut ) );
+    if( !eol ) eol = end;
+}
+
+char* clean_lines( char* begin, char* end, find_special find ) {
+    auto* dst = begin;
+    const char* src = begin;
+
+    while( true ) {
+        const char* cut = end;
+        const char* eol;
+        find_cut( src, end, find, cut, eol );
+
+        const auto* first = std::find_if_not( src, cut, RawConsts::is_separator() );
+        const auto* last = std::find_if_not( std::reverse_iterator< const char* >( cut ),
+                                             std::reverse_iterator< const char* >( first ),
+                                             RawConsts::is_separator() ).base();
+
+        const auto size = std::distance( first, last );
+        if( first != dst )
+            std::memmove( dst, first, size );
+
+        dst += size;
+        if( dst != eol || eol == end ) *dst = '\n';
+        ++dst;
+
+        if( eol == end ) return dst;
+        src = eol + 1;
+    }
+}
+
+}
+
+bool supported( ISA isa ) {
+    switch( isa ) {
+        case ISA::scalar: return true;
+#ifdef OPM_CLEANER_X86
+        case ISA::sse42:  return __builtin_cpu_supports( "sse4.2" );
+        case ISA::avx2:   return __builtin_cpu_supports( "avx2" );
+#endif
+        default: return false;
+    }
+}
+
+ISA best() {
+    static const ISA isa = supported( ISA::avx2 )  ? ISA::avx2
+                         : supported( ISA::sse42 ) ? ISA::sse42
+                         : ISA::scalar;
+    return isa;
+}
+
+char* clean( char* begin, char* end ) {
+    static const auto find = finder( best() );
+    return clean_lines( begin, end, find );
+}
+
+char* clean( char* begin, char* end, ISA isa ) {
+    return clean_lines( begin, end, finder( isa ) );
+}
+
+}
+}
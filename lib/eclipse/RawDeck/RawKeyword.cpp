@@ -16,6 +16,7 @@
   You should have received a copy of the GNU General Public License
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include <stdexcept>
 #include <boost/algorithm/string.hpp>
 
@@ -29,18 +30,71 @@ namespace Opm {
 
     static const std::string emptystr = "";
 
+namespace {
+
+    /*
+     * Character classes for classifying lines, indexed by the character as
+     * unsigned. Characters outside of ASCII are in no class.
+     */
+    enum : unsigned char {
+        name_start = 1 << 0, // a letter
+        name_char  = 1 << 1, // a letter, a digit, '-', '_' or '+'
+        data_start = 1 << 2, // a digit, a sign, '.', a quote or '*'
+    };
+
+    struct char_classes {
+        unsigned char flags[ 256 ] = {};
+
+        char_classes() {
+            for( int c = 'A'; c <= 'Z'; ++c ) flags[ c ] |= name_start | name_char;
+            for( int c = 'a'; c <= 'z'; ++c ) flags[ c ] |= name_start | name_char;
+            for( int c = '0'; c <= '9'; ++c ) flags[ c ] |= name_char | data_start;
+
+            for( unsigned char c : { '-', '_', '+' } ) flags[ c ] |= name_char;
+            for( unsigned char c : { '-', '+', '.', '*' } ) flags[ c ] |= data_start;
+            flags[ static_cast< unsigned char >( RawConsts::quote ) ] |= data_start;
+        }
+
+        bool is( char c, unsigned char cls ) const {
+            return this->flags[ static_cast< unsigned char >( c ) ] & cls;
+        }
+    };
+
+    const char_classes classes;
+
+}
+
+    /* a keyword made on its own has a table of names of its own */
     RawKeyword::RawKeyword(const string_view& name, Raw::KeywordSizeEnum sizeType , const std::string& filename, size_t lineNR) :
         m_partialRecordString( emptystr )
     {
         if (sizeType == Raw::SLASH_TERMINATED || sizeType == Raw::UNKNOWN) {
-            commonInit(name.string(),filename,lineNR);
+            auto names = std::make_shared< SourceNames >();
+            const auto file = names->intern( filename );
+            commonInit(name.string(),std::move( names ),file,lineNR);
+            m_sizeType = sizeType;
+        } else
+            throw std::invalid_argument("Error - invalid sizetype on input");
+    }
+
+    RawKeyword::RawKeyword(const string_view& name , const std::string& filename, size_t lineNR , size_t inputSize, bool isTableCollection ) :
+        RawKeyword( name, std::make_shared< SourceNames >(), 0, lineNR, inputSize, isTableCollection )
+    {
+        m_file = m_names->intern( filename );
+    }
+
+    RawKeyword::RawKeyword(const string_view& name, Raw::KeywordSizeEnum sizeType , std::shared_ptr< SourceNames > names, SourceNames::id file, size_t lineNR) :
+        m_partialRecordString( emptystr )
+    {
+        if (sizeType == Raw::SLASH_TERMINATED || sizeType == Raw::UNKNOWN) {
+            commonInit(name.string(),std::move( names ),file,lineNR);
             m_sizeType = sizeType;
         } else
             throw std::invalid_argument("Error - invalid sizetype on input");
     }
 
-    RawKeyword::RawKeyword(const string_view& name , const std::string& filename, size_t lineNR , size_t inputSize, bool isTableCollection ) {
-        commonInit(name.string(),filename,lineNR);
+    RawKeyword::RawKeyword(const string_view& name , std::shared_ptr< SourceNames > names, SourceNames::id file, size_t lineNR , size_t inputSize, bool isTableCollection ) {
+        commonInit(name.string(),std::move( names ),file,lineNR);
         if (isTableCollection) {
             m_sizeType = Raw::TABLE_COLLECTION;
             m_numTables = inputSize;
@@ -55,9 +109,11 @@ namespace Opm {
     }
 
 
-    void RawKeyword::commonInit(const std::string& name , const std::string& filename, size_t lineNR) {
+    void RawKeyword::commonInit(const std::string& name , std::shared_ptr< SourceNames > names, SourceNames::id file, size_t lineNR) {
         setKeywordName( name );
-        m_filename = filename;
+        m_names = std::move( names );
+        m_file = file;
+        m_keyword = m_names->intern( m_name );
         m_lineNR = lineNR;
 
         this->m_is_title = name == "TITLE";
@@ -107,7 +163,7 @@ namespace Opm {
                                ? "untitled"
                                : m_partialRecordString;
 
-            m_records.emplace_back( recstr, m_filename, m_name );
+            m_records.emplace_back( recstr, m_names, m_file, m_keyword );
             m_partialRecordString = emptystr;
             m_isFinished = true;
             return;
@@ -119,7 +175,7 @@ namespace Opm {
                 ? string_view{ m_partialRecordString.begin(), m_partialRecordString.end() - 1 }
                 : m_partialRecordString;
 
-            m_records.emplace_back( recstr, m_filename, m_name );
+            m_records.emplace_back( recstr, m_names, m_file, m_keyword );
             m_partialRecordString = emptystr;
 
             if( m_sizeType == Raw::FIXED && m_records.size() == m_fixedSize )
@@ -131,13 +187,47 @@ namespace Opm {
         return *m_records.begin();
     }
 
-    bool RawKeyword::isKeywordPrefix(const string_view& line, std::string& keyword ) {
+    Raw::LineType RawKeyword::classifyLine( const string_view& line, DeckName& deckName ) {
+        deckName.size = 0;
+
+        if( line.empty() ) return Raw::LineType::DATA;
+
+        // numbers, quoted strings and defaults can never be keywords
+        if( classes.is( line[ 0 ], data_start ) ) return Raw::LineType::DATA;
+
+        if( line[ 0 ] == RawConsts::slash ) {
+            const auto rest = std::find_if_not( line.begin() + 1, line.end(), RawConsts::is_separator() );
+            return rest == line.end() ? Raw::LineType::TERMINATOR : Raw::LineType::GARBAGE;
+        }
+
+        if( !classes.is( line[ 0 ], name_start ) ) return Raw::LineType::GARBAGE;
+
+        // a longer name is cut after nine characters, like getDeckName does,
+        // so that it is reported as an unknown keyword and not random text
+        const auto name_end = std::find_if( line.begin(), line.end(), RawConsts::is_separator() );
+        const size_t size = std::min< size_t >( name_end - line.begin(),
+                                                RawConsts::maxKeywordLength + 1 );
+
         // make the keyword string ALL_UPPERCASE because Eclipse seems
         // to be case-insensitive (although this is one of its
         // undocumented features...)
-        keyword = uppercase( ParserKeyword::getDeckName( line ).string() );
+        for( size_t i = 0; i < size; ++i ) {
+            const char c = line[ i ];
+            if( !classes.is( c, name_char ) ) return Raw::LineType::GARBAGE;
+            deckName.chars[ i ] = ( c >= 'a' && c <= 'z' ) ? c - 'a' + 'A' : c;
+        }
 
-        return isValidKeyword( keyword );
+        deckName.size = size;
+        return Raw::LineType::KEYWORD;
+    }
+
+    bool RawKeyword::isKeywordPrefix(const string_view& line, std::string& keyword ) {
+        DeckName deckName;
+        if( classifyLine( line, deckName ) != Raw::LineType::KEYWORD )
+            return false;
+
+        keyword = deckName.view().string();
+        return true;
     }
 
     bool RawKeyword::isValidKeyword(const std::string& keywordCandidate) {
@@ -173,7 +263,15 @@ namespace Opm {
     }
 
     const std::string& RawKeyword::getFilename() const {
-        return m_filename;
+        return m_names->name( m_file );
+    }
+
+    SourceNames::id RawKeyword::getFileId() const {
+        return m_file;
+    }
+
+    const std::shared_ptr< SourceNames >& RawKeyword::getSourceNames() const {
+        return m_names;
     }
 
     size_t RawKeyword::getLineNR() const {
@@ -21,7 +21,6 @@
 #include <iostream>
 #include <stdexcept>
 #include <vector>
-#include <deque>
 
 #include <opm/parser/eclipse/RawDeck/RawRecord.hpp>
 #include <opm/parser/eclipse/RawDeck/RawConsts.hpp>
@@ -35,30 +34,6 @@ namespace Opm {
 
 namespace {
 
-std::deque< string_view > splitSingleRecordString( const string_view& record ) {
-    auto first_nonspace = []( string_view::const_iterator begin,
-                              string_view::const_iterator end ) {
-        return std::find_if_not( begin, end, RawConsts::is_separator() );
-    };
-
-    std::deque< string_view > dst;
-    auto current = record.begin();
-    while( (current = first_nonspace( current, record.end() )) != record.end() )
-    {
-        if( *current == RawConsts::quote ) {
-            auto quote_end = std::find( current + 1, record.end(), RawConsts::quote ) + 1;
-            dst.push_back( { current, quote_end } );
-            current = quote_end;
-        } else {
-            auto token_end = std::find_if( current, record.end(), RawConsts::is_separator() );
-            dst.push_back( { current, token_end } );
-            current = token_end;
-        }
-    }
-
-    return dst;
-}
-
 /*
     * It is assumed that after a record is terminated, there is no quote marks
     * in the subsequent comment. This is in accordance with the Eclipse user
@@ -76,13 +51,31 @@ inline bool even_quotes( const T& str ) {
 
 }
 
+    /* a record made on its own has a table of names of its own */
+    RawRecord::RawRecord(const string_view& singleRecordString,
+                         const std::string& fileName,
+                         const std::string& keywordName) :
+        RawRecord( singleRecordString, std::make_shared< SourceNames >(), fileName, keywordName )
+    {}
+
     RawRecord::RawRecord(const string_view& singleRecordString,
+                         std::shared_ptr< SourceNames > names,
                          const std::string& fileName,
                          const std::string& keywordName) :
+        RawRecord( singleRecordString,
+                   names,
+                   names->intern( fileName ),
+                   names->intern( keywordName ) )
+    {}
+
+    RawRecord::RawRecord(const string_view& singleRecordString,
+                         std::shared_ptr< const SourceNames > names,
+                         SourceNames::id file,
+                         SourceNames::id keyword) :
         m_sanitizedRecordString( singleRecordString ),
-        m_recordItems( splitSingleRecordString( m_sanitizedRecordString ) ),
-        m_fileName(fileName),
-        m_keywordName(keywordName)
+        m_names( std::move( names ) ),
+        m_file( file ),
+        m_keyword( keyword )
     {
 
         if( !even_quotes( singleRecordString ) )
@@ -93,24 +86,68 @@ inline bool even_quotes( const T& str ) {
     }
 
     const std::string& RawRecord::getFileName() const {
-        return m_fileName;
+        return m_names->name( m_file );
     }
 
     const std::string& RawRecord::getKeywordName() const {
-        return m_keywordName;
+        return m_names->name( m_keyword );
+    }
+
+    void RawRecord::push_front( string_view tok ) {
+        this->prepend( 1, tok );
     }
 
     void RawRecord::prepend( size_t count, string_view tok ) {
-        this->m_recordItems.insert( this->m_recordItems.begin(), count, tok );
+        if( count == 0 ) return;
+
+        this->m_repeats.push_back( { tok, count } );
+        this->m_size += count;
+    }
+
+    void RawRecord::splitRecordString() const {
+        /*
+         * The tokens are collected in a buffer that is reused by all records
+         * split on this thread, and then copied to a vector of the exact size.
+         * A record then costs a single allocation, regardless of its length.
+         * The buffer is not kept around after a very large record.
+         */
+        static const size_t max_kept_tokens = 1 << 16;
+        static thread_local std::vector< string_view > buffer;
+        buffer.clear();
+
+        auto current = this->m_sanitizedRecordString.begin();
+        const auto end = this->m_sanitizedRecordString.end();
+        while( current != end ) {
+            const auto token = nextToken( current, end );
+            if( !token.empty() ) buffer.push_back( token );
+        }
+
+        this->m_recordItems.assign( buffer.begin(), buffer.end() );
+        if( buffer.capacity() > max_kept_tokens )
+            std::vector< string_view >().swap( buffer );
+
+        this->m_size += this->m_recordItems.size();
+        this->m_tokenized = true;
+    }
+
+    /*
+     * Hand the whole record string over to a reader that tokenizes it itself,
+     * and leave the record empty. This only succeeds if no tokens have been
+     * read from, or added to, the record yet.
+     */
+    bool RawRecord::popRecordString( string_view& record ) {
+        if( this->m_tokenized || !this->m_repeats.empty() )
+            return false;
+
+        record = this->m_sanitizedRecordString;
+        this->m_tokenized = true;
+        return true;
     }
 
     void RawRecord::dump() const {
         std::cout << "RecordDump: ";
-        for (size_t i = 0; i < m_recordItems.size(); i++) {
-            std::cout
-                << this->m_recordItems[i] << "/"
-                << getItem( i ) << " ";
-        }
+        for (size_t i = 0; i < this->size(); i++)
+            std::cout << getItem( i ) << " ";
         std::cout << std::endl;
     }
 
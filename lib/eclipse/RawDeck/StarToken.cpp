@@ -23,9 +23,11 @@
 #include <string>
 #include <stdexcept>
 #include <cstdlib>
+#include <limits>
 
 #include <boost/spirit/include/qi.hpp>
 
+#include <opm/parser/eclipse/RawDeck/FastNumber.hpp>
 #include <opm/parser/eclipse/RawDeck/StarToken.hpp>
 #include <opm/parser/eclipse/Utility/Stringview.hpp>
 
@@ -34,8 +36,8 @@ namespace qi = boost::spirit::qi;
 namespace Opm {
 
     bool isStarToken(const string_view& token,
-                           std::string& countString,
-                           std::string& valueString) {
+                           string_view& countString,
+                           string_view& valueString) {
         // find first character which is not a digit
         size_t pos = 0;
         for (; pos < token.length(); ++pos)
@@ -56,22 +58,20 @@ namespace Opm {
         // StarToken<T>. (Because Eclipse does not seem to
         // accept these and we would stay as closely to the spec as
         // possible.)
-        else if (pos == 0) {
-            countString = "";
-            valueString = token.substr(pos + 1);
-            return true;
-        }
-
+        //
         // if a star is prefixed by an unsigned integer N, then this should be
-        // interpreted as "repeat value after star N times"
-        countString = token.substr(0, pos);
-        valueString = token.substr(pos + 1);
+        // interpreted as "repeat value after star N times". a lone star gives
+        // an empty count.
+        countString = string_view( token.begin(), pos );
+        valueString = string_view( token.begin() + pos + 1, token.end() );
         return true;
     }
 
     template<>
     int readValueToken< int >( string_view view ) {
         int n = 0;
+        if( FastNumber::parse( view.begin(), view.end(), n ) ) return n;
+
         auto cursor = view.begin();
         const bool ok = qi::parse( cursor, view.end(), qi::int_, n );
 
@@ -97,6 +97,9 @@ namespace Opm {
     template<>
     double readValueToken< double >( string_view view ) {
         double n = 0;
+        if( FastNumber::parse( view.begin(), view.end(), n ) ) return n;
+
+        /* the few tokens the fast parser does not handle, and errors */
         qi::real_parser< double, fortran_double< double > > double_;
         auto cursor = view.begin();
         const auto ok = qi::parse( cursor, view.end(), double_, n );
@@ -119,8 +122,8 @@ namespace Opm {
     void StarToken::init_( const string_view& token ) {
         // special-case the interpretation of a lone star as "1*" but do not
         // allow constructs like "*123"...
-        if (m_countString == "") {
-            if (m_valueString != "")
+        if (m_countString.empty()) {
+            if (!m_valueString.empty())
                 // TODO: decorate the deck with a warning instead?
                 throw std::invalid_argument("Not specifying a count also implies not specifying a value. Token: \'" + token + "\'.");
 
@@ -129,7 +132,16 @@ namespace Opm {
             m_count = 1;
         }
         else {
-            m_count = std::stoi( m_countString );
+            // isStarToken only accepts digits in the count, so the only thing
+            // that can go wrong is overflow, reported like std::stoi does.
+            long long count = 0;
+            for (char digit : m_countString) {
+                count = 10 * count + (digit - '0');
+                if (count > std::numeric_limits< int >::max())
+                    throw std::out_of_range("Repetition count out of range. Token: \'" + token + "\'.");
+            }
+
+            m_count = count;
 
             if (m_count == 0)
                 // TODO: decorate the deck with a warning instead?
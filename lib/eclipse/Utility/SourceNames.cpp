@@ -0,0 +1,53 @@
+/*
+  Copyright 2016 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdexcept>
+
+#include <opm/parser/eclipse/Utility/SourceNames.hpp>
+
+namespace Opm {
+
+SourceNames::id SourceNames::intern( const std::string& name ) {
+    if( name.empty() ) return 0;
+
+    std::lock_guard< std::mutex > guard( this->lock );
+    const auto found = this->ids.find( name );
+    if( found != this->ids.end() ) return found->second;
+
+    const auto interned = id( this->names.size() );
+    this->ids.emplace( name, interned );
+    this->names.push_back( name );
+    return interned;
+}
+
+const std::string& SourceNames::name( id x ) const {
+    std::lock_guard< std::mutex > guard( this->lock );
+
+    if( x >= this->names.size() )
+        throw std::out_of_range( "No source name with id " + std::to_string( x ) );
+
+    return this->names[ x ];
+}
+
+size_t SourceNames::size() const {
+    std::lock_guard< std::mutex > guard( this->lock );
+    return this->names.size();
+}
+
+}
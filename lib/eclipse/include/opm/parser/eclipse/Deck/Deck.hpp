@@ -25,10 +25,13 @@
 #include <ostream>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 #include <boost/filesystem.hpp>
 
 #include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/IncludeGraph.hpp>
+#include <opm/parser/eclipse/Deck/SymbolTable.hpp>
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 #include <opm/parser/eclipse/Parser/MessageContainer.hpp>
 
@@ -95,20 +98,33 @@ namespace Opm {
 
 
         protected:
-            void add( const DeckKeyword*, const_iterator, const_iterator );
-
-            const std::vector< size_t >& offsets( const std::string& ) const;
-
-            DeckView( const_iterator first, const_iterator last );
-            explicit DeckView( std::pair< const_iterator, const_iterator > );
+            /*
+             * The positions of the keywords of a deck by name, in
+             * increasing order. The deck owns the index, and a view of it
+             * is a window [offset, offset + size()) of the positions, so
+             * views such as a Section are made without indexing anything.
+             */
+            using KeywordIndex = std::unordered_map< std::string, std::vector< size_t > >;
+            using positions = std::pair< std::vector< size_t >::const_iterator,
+                                         std::vector< size_t >::const_iterator >;
+
+            DeckView( const KeywordIndex&, const_iterator first, const_iterator last );
+            /* the keywords [first, last) of the view */
+            DeckView( const DeckView&, size_t first, size_t last );
 
             void reinit( const_iterator, const_iterator );
 
+            positions find( const std::string& ) const;
+            /* the first keyword with this name at or after from, or size() */
+            size_t position( const std::string& keyword, size_t from ) const;
+
         private:
             const_iterator first;
             const_iterator last;
-            std::map< std::string, std::vector< size_t > > keywordMap;
+            const KeywordIndex* m_index;
+            size_t offset = 0;
 
+            friend class Section;
     };
 
     class Deck : private DeckView {
@@ -131,10 +147,19 @@ namespace Opm {
             Deck( std::initializer_list< std::string > );
 
             Deck( const Deck& );
+            /* a parsed deck is moved out of the parser, not copied */
+            Deck( Deck&& );
 
             void addKeyword( DeckKeyword&& keyword );
             void addKeyword( const DeckKeyword& keyword );
 
+            /*
+             * Replace the keywords [first, last) by keywords. Iterators,
+             * references to keywords and sections of the deck are not valid
+             * afterwards.
+             */
+            void replaceKeywords( size_t first, size_t last, std::vector< DeckKeyword >&& keywords );
+
             DeckKeyword& getKeyword( size_t );
             MessageContainer& getMessageContainer() const;
 
@@ -146,19 +171,44 @@ namespace Opm {
             const std::string getDataFile() const;
             void setDataFile(const std::string& dataFile);
 
+            /* the files the deck was parsed from, empty if it was not parsed */
+            const IncludeGraph& getIncludeGraph() const;
+            IncludeGraph& getIncludeGraph();
+
+            /*
+             * The string values of the items parsed into the deck. A copy of
+             * the deck shares the table with it.
+             */
+            const std::shared_ptr< SymbolTable >& getSymbols() const;
+
+            /*
+             * The names of the files and keywords the deck was parsed from.
+             * A copy of the deck shares the table with it.
+             */
+            const std::shared_ptr< SourceNames >& getSourceNames() const;
+
             iterator begin();
             iterator end();
             void write( DeckOutput& output ) const ;
             friend std::ostream& operator<<(std::ostream& os, const Deck& deck);
+
         private:
+            friend class Section;
+
             Deck( std::vector< DeckKeyword >&& );
 
+            void reindex();
+
             std::vector< DeckKeyword > keywordList;
+            KeywordIndex keywordIndex;
             mutable MessageContainer m_messageContainer;
             UnitSystem defaultUnits;
             UnitSystem activeUnits;
 
             std::string m_dataFile;
+            IncludeGraph m_includeGraph;
+            std::shared_ptr< SymbolTable > m_symbols;
+            std::shared_ptr< SourceNames > m_sourceNames;
     };
 }
 #endif  /* DECK_HPP */
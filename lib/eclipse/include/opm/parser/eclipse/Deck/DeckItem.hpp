@@ -20,7 +20,10 @@
 #ifndef DECKITEM_HPP
 #define DECKITEM_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <ostream>
@@ -30,15 +33,28 @@
 
 namespace Opm {
     class DeckOutput;
+    class SymbolTable;
 
     class DeckItem {
     public:
-        DeckItem() = default;
+        DeckItem();
         explicit DeckItem( const std::string& );
 
         DeckItem( const std::string&, int, size_t size_hint = 8 );
         DeckItem( const std::string&, double, size_t size_hint = 8 );
-        DeckItem( const std::string&, std::string, size_t size_hint = 8 );
+
+        /*
+         * The string values are kept in the symbol table of the deck, or in
+         * a table of the item's own when it is not given one.
+         */
+        DeckItem( const std::string&, std::string, size_t size_hint = 8,
+                  std::shared_ptr< SymbolTable > symbols = {} );
+
+        DeckItem( const DeckItem& );
+        DeckItem( DeckItem&& ) noexcept;
+        DeckItem& operator=( const DeckItem& );
+        DeckItem& operator=( DeckItem&& ) noexcept;
+        ~DeckItem();
 
         const std::string& name() const;
 
@@ -62,9 +78,39 @@ namespace Opm {
         double getSIDouble( size_t ) const;
         std::string getTrimmedString( size_t ) const;
 
+        /*
+         * The values of N*value are kept as one value repeated N times, a
+         * run. getData< T >() and getSIDoubleData() expand the runs into a
+         * copy on the first call, and leave the values themselves as they
+         * are, so references from get< T >() stay valid and several threads
+         * may read the same item. Pushing to the item drops the copy.
+         */
         template< typename T > const std::vector< T >& getData() const;
         const std::vector< double >& getSIDoubleData() const;
 
+        /*
+         * The values as runs, without expanding them. Every value that was
+         * not given with N*value is a run of its own, and the values of a
+         * run are either all defaulted or all given in the deck. Run i
+         * holds the values [ runEnd( i - 1 ), runEnd( i ) ).
+         */
+        size_t runCount() const;
+        size_t runEnd( size_t run ) const;
+        template< typename T > const T& runValue( size_t run ) const;
+
+        /*
+         * Convert the values to SI in place, once the dimensions are pushed,
+         * instead of keeping a converted copy. The double values, from get<
+         * double >() and getData< double >() too, are in SI afterwards, and
+         * getSIDouble() is then a plain read, which is safe to call from
+         * several threads. getRawDouble() converts back with the dimensions,
+         * which the item keeps. Items with a context dependent unit are left
+         * as they are.
+         */
+        void convertToSI();
+        bool isSIConverted() const;
+        double getRawDouble( size_t ) const;
+
         void push_back( int );
         void push_back( double );
         void push_back( std::string );
@@ -74,6 +120,9 @@ namespace Opm {
         void push_backDefault( int );
         void push_backDefault( double );
         void push_backDefault( std::string );
+        void push_backDefault( int, size_t );
+        void push_backDefault( double, size_t );
+        void push_backDefault( std::string, size_t );
         // trying to access the data of a "dummy default item" will raise an exception
         void push_backDummyDefault();
 
@@ -107,24 +156,76 @@ namespace Opm {
         bool operator!=(const DeckItem& other) const;
 
     private:
-        std::vector< double > dval;
-        std::vector< int > ival;
-        std::vector< std::string > sval;
+        /*
+         * Decks have millions of items with a value or two, so an item only
+         * has storage for the values of its type. The defaulted values are
+         * kept as runs of [begin, end), which is empty when every value is
+         * given in the deck, and the name and dimensions are shared by all
+         * the items that have them.
+         *
+         * A value repeated with N*value is stored once. Once the item has
+         * such a run, run_ends has the end of the run of every stored
+         * value, and is empty otherwise.
+         *
+         * The strings are mostly the names of wells and groups, repeated
+         * in record after record, so they are stored as symbols in the
+         * symbol table of the deck, and two values in the same table are
+         * equal when their symbols are. getData< std::string >() spells them
+         * out in the expanded copy.
+         */
+        union {
+            std::vector< int > ival;
+            std::vector< double > dval;
+            std::vector< const std::string* > sval;
+        };
 
         type_tag type = type_tag::unknown;
-
-        std::string item_name;
-        std::vector< bool > defaulted;
-        std::vector< Dimension > dimensions;
-        mutable std::vector< double > SIdata;
-
-        template< typename T > std::vector< T >& value_ref();
-        template< typename T > const std::vector< T >& value_ref() const;
+        bool si_converted = false;
+
+        const std::string* item_name;
+        std::shared_ptr< SymbolTable > symbols;
+        std::vector< std::pair< uint32_t, uint32_t > > default_runs;
+        std::vector< uint32_t > run_ends;
+        std::vector< const Dimension* > dimensions;
+
+        struct expansion;
+        mutable std::atomic< expansion* > expanded{ nullptr };
+
+        void init( type_tag, size_t hint );
+        void init( const DeckItem& );
+        void init( DeckItem&& );
+        void clear();
+        void push_defaulted( size_t index, size_t count );
+        size_t value_count() const;
+        size_t value_index( size_t index ) const;
+        template< typename T > void expand();
+        template< typename T > void spell( std::vector< T >& ) const;
+        expansion& expanded_values() const;
+        void drop_expansion();
+
+        static const std::string* shared( const std::string& name );
+        static const Dimension* shared( const Dimension& );
+
+        template< typename T > struct storage { using type = T; };
+        template< typename T > using stored = typename storage< T >::type;
+        template< typename T > stored< T > store( T );
+
+        template< typename T > std::vector< stored< T > >& value_ref();
+        template< typename T > const std::vector< stored< T > >& value_ref() const;
         template< typename T > void push( T );
         template< typename T > void push( T, size_t );
-        template< typename T > void push_default( T );
-        template< typename T > void write_vector(DeckOutput& writer, const std::vector<T>& data) const;
+        template< typename T > void push_default( T, size_t );
+        template< typename T > void write_vector(DeckOutput& writer) const;
+
+        friend class DeckCache;
+        friend class DeckRecord;
     };
+
+    template<> struct DeckItem::storage< std::string > {
+        using type = const std::string*;
+    };
+
+    template<> const std::vector< std::string >& DeckItem::getData< std::string >() const;
 }
 #endif  /* DECKITEM_HPP */
 
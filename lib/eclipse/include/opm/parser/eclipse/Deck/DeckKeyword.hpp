@@ -25,6 +25,7 @@
 #include <memory>
 
 #include <opm/parser/eclipse/Deck/DeckRecord.hpp>
+#include <opm/parser/eclipse/Utility/SourceNames.hpp>
 
 namespace Opm {
     class ParserKeyword;
@@ -40,7 +41,11 @@ namespace Opm {
         const std::string& name() const;
         void setFixedSize();
         void setLocation(const std::string& fileName, int lineNumber);
+        void setLocation(const std::shared_ptr< SourceNames >& names, SourceNames::id file, int lineNumber);
         const std::string& getFileName() const;
+        SourceNames::id getFileId() const;
+        /* the table the file name is kept in, null if the keyword has no location */
+        const std::shared_ptr< SourceNames >& getSourceNames() const;
         int getLineNumber() const;
 
         size_t size() const;
@@ -52,6 +57,16 @@ namespace Opm {
         bool isKnown() const;
         bool isDataKeyword() const;
 
+        /// A keyword whose records were skipped by the keyword filter of
+        /// the parser. It has no records; Parser::decodeKeyword reads them
+        /// from the bytes [offset, offset + length) of the cleaned input of
+        /// its file.
+        bool isPlaceholder() const;
+        void setPlaceholder(size_t offset, size_t length, size_t records);
+        size_t getInputOffset() const;
+        size_t getInputLength() const;
+        size_t getSkippedRecords() const;
+
         const std::vector<int>& getIntData() const;
         const std::vector<double>& getRawDoubleData() const;
         const std::vector<double>& getSIDoubleData() const;
@@ -79,13 +94,21 @@ namespace Opm {
         friend std::ostream& operator<<(std::ostream& os, const DeckKeyword& keyword);
     private:
         std::string m_keywordName;
-        std::string m_fileName;
+        std::shared_ptr< SourceNames > m_names;
+        SourceNames::id m_file = 0;
         int m_lineNumber;
 
         std::vector< DeckRecord > m_recordList;
         bool m_knownKeyword;
         bool m_isDataKeyword;
         bool m_slashTerminated;
+
+        bool m_placeholder = false;
+        size_t m_inputOffset = 0;
+        size_t m_inputLength = 0;
+        size_t m_skippedRecords = 0;
+
+        friend class DeckCache;
     };
 }
 
@@ -49,13 +49,25 @@ namespace Opm {
 
         bool hasItem(const std::string& name) const;
 
+        /*
+         * The item is looked for at the index genkw gave it, and by name
+         * in the records where it is somewhere else, such as the records
+         * of keywords with records of different kinds.
+         */
         template <class Item>
         DeckItem& getItem() {
-            return getItem( Item::itemName );
+            return const_cast< DeckItem& >( static_cast< const DeckRecord& >( *this ).getItem< Item >() );
         }
 
         template <class Item>
         const DeckItem& getItem() const {
+            /* the names of the items are shared, so they are compared by address */
+            static const std::string* const name = DeckItem::shared( Item::itemName );
+
+            if( Item::itemIndex < this->m_items.size()
+             && &this->m_items[ Item::itemIndex ].name() == name )
+                return this->m_items[ Item::itemIndex ];
+
             return getItem( Item::itemName );
         }
 
@@ -0,0 +1,119 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_INCLUDE_GRAPH_HPP
+#define OPM_INCLUDE_GRAPH_HPP
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+    /*
+     * The files a deck was parsed from, in the order they were opened, with
+     * the keywords and messages of the deck that came from each of them. The
+     * keywords of a file include the ones of the files it includes, so the
+     * ranges nest like the INCLUDE keywords.
+     */
+    class IncludeGraph {
+    public:
+        static const size_t npos;
+
+        /*
+         * The size, modification time and content hash of a file, taken from
+         * the bytes that were parsed when it was read.
+         */
+        struct Stamp {
+            bool valid = false;
+            uint64_t size = 0;
+            int64_t mtime = 0;
+            uint64_t digest = 0;
+        };
+
+        struct File {
+            /* the canonical path, or the path as given if it does not exist */
+            std::string path;
+            /* the file with the INCLUDE keyword, npos for the root file */
+            size_t parent = npos;
+
+            /* the keywords [firstKeyword, lastKeyword) of the deck */
+            size_t firstKeyword = 0;
+            size_t lastKeyword = 0;
+            /* the messages [firstMessage, lastMessage) of the deck */
+            size_t firstMessage = 0;
+            size_t lastMessage = 0;
+
+            /* the PATHS aliases when the file was included */
+            std::map< std::string, std::string > aliases;
+            /* the keywords giving the number of records of keywords in the file */
+            std::set< std::string > sizedBy;
+            /* the file has a PATHS keyword */
+            bool paths = false;
+            /* a keyword continues past the end of the file */
+            bool spans = false;
+            /* only recorded when the deck is to be cached or indexed */
+            Stamp stamp;
+        };
+
+        using const_iterator = std::vector< File >::const_iterator;
+
+        size_t size() const;
+        bool empty() const;
+        const File& operator[]( size_t ) const;
+        File& operator[]( size_t );
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        /* add a file, and return its index */
+        size_t add( File );
+
+        /* true if file is included from ancestor, directly or not */
+        bool includes( size_t ancestor, size_t file ) const;
+
+        /* one past the last of the files included from the file */
+        size_t last( size_t file ) const;
+
+        /*
+         * Replace the file, and the files it includes, with the files of
+         * graph, whose root file is the new version of the file. The keywords
+         * and messages of graph are numbered from zero, as when parsing the
+         * file on its own.
+         */
+        void replace( size_t file, const IncludeGraph& graph );
+
+        /* the path of every file, in the order they were opened */
+        std::vector< std::string > paths() const;
+
+        /*
+         * The parse stopped at an END keyword, so files may not have been
+         * read to the end.
+         */
+        bool ended() const;
+        void setEnded( bool );
+
+    private:
+        std::vector< File > files;
+        bool m_ended = false;
+    };
+}
+
+#endif
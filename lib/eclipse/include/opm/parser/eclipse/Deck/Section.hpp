@@ -53,6 +53,8 @@ class Section : public DeckView {
                                          bool ensureKeywordSectionAffiliation = false);
 
     private:
+        static DeckView find_section( const Deck&, const std::string& );
+
         std::string section_name;
         const UnitSystem& units;
 
@@ -0,0 +1,60 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_SYMBOL_TABLE_HPP
+#define OPM_SYMBOL_TABLE_HPP
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace Opm {
+
+    /*
+     * The string values of the items of a deck, each kept once. Items store
+     * a pointer to the symbol of a value instead of the value, and share the
+     * table with the deck, so the symbols live as long as the deck or any
+     * item that was taken out of it.
+     *
+     * Symbols can be looked up from several threads at once. The table is
+     * split in stripes by the hash of the string, each with a lock of its
+     * own, so that the parse threads seldom wait for each other.
+     */
+    class SymbolTable {
+        public:
+            /* the symbol of value, which is added if it is not there yet */
+            const std::string* intern( const std::string& value );
+
+            /* the number of symbols */
+            size_t size() const;
+
+        private:
+            struct stripe {
+                mutable std::mutex lock;
+                std::unordered_set< std::string > symbols;
+            };
+
+            static const size_t stripes = 16;
+            std::array< stripe, stripes > table;
+    };
+}
+
+#endif
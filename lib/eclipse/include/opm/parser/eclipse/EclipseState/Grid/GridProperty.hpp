@@ -179,6 +179,7 @@ public:
 private:
     const DeckItem& getDeckItem( const DeckKeyword& );
     void setDataPoint(size_t sourceIdx, size_t targetIdx, const DeckItem& deckItem);
+    void setDataPoints(size_t run, size_t begin, size_t end, const DeckItem& deckItem);
 
     size_t m_nx, m_ny, m_nz;
     SupportedKeywordInfo m_kwInfo;
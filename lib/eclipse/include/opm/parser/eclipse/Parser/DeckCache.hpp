@@ -0,0 +1,135 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_DECK_CACHE_HPP
+#define OPM_DECK_CACHE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+    class Deck;
+    class DeckItem;
+    class DeckKeyword;
+    class Dimension;
+    class IncludeGraph;
+    class MessageContainer;
+    class ParseContext;
+    class SymbolTable;
+    class UnitSystem;
+
+    /*
+     * A directory of parsed decks in a compact binary form, so that a deck
+     * that has not changed since it was last parsed is read back instead of
+     * parsed again.
+     *
+     * An entry is named by a hash of the root file's path, the ParseContext
+     * and the keyword definitions of the parser, and holds a manifest of the
+     * root file and every file it included, with their sizes, modification
+     * times and content hashes, and the include graph of the deck. The entry is only used when every file in the
+     * manifest is unchanged; a file whose size or time differs is hashed
+     * again, so touching a file does not invalidate the entry.
+     *
+     * Failing to read or write an entry is never an error: the deck is then
+     * parsed from text as if there was no cache.
+     */
+    class DeckCache {
+    public:
+        DeckCache( const std::string& directory, uint64_t keywordHash );
+
+        /*
+         * Read the entry of the root file into deck, which should be empty.
+         * False if there is no entry, or if it is stale or cannot be read, in
+         * which case deck may have been partially filled and is to be thrown
+         * away.
+         */
+        bool load( const std::string& rootFile, const ParseContext&, Deck& deck ) const;
+
+        /*
+         * Write the entry of the deck parsed from rootFile, which read the
+         * files of the graph. The manifest is made from the stamps of the
+         * files, so that a file changed while it was parsed makes the entry
+         * stale; a file without a stamp is looked at when the entry is
+         * written. Files that could not be opened are listed as well, so that
+         * creating them makes the entry stale.
+         */
+        void store( const std::string& rootFile,
+                    const ParseContext&,
+                    const IncludeGraph& files,
+                    const Deck& deck ) const;
+
+        /*
+         * Read and write the entry at path rather than in the directory, such
+         * as the index file next to the root file that IndexedDeck keeps.
+         */
+        bool loadEntry( const std::string& path,
+                        const std::string& rootFile,
+                        const ParseContext&,
+                        Deck& deck ) const;
+        void storeEntry( const std::string& path,
+                         const std::string& rootFile,
+                         const ParseContext&,
+                         const IncludeGraph& files,
+                         const Deck& deck ) const;
+
+        /* the path of the entry of rootFile */
+        std::string entryPath( const std::string& rootFile, const ParseContext& ) const;
+
+        /* a fast, non-cryptographic hash */
+        static uint64_t hash( const char* data, size_t size, uint64_t seed = 0 );
+        /* the hash of the settings of the parse context */
+        static uint64_t hash( const ParseContext&, uint64_t seed = 0 );
+
+    private:
+        class reader;
+        class writer;
+
+        /*
+         * The entry is written with the raw storage of the deck, which these
+         * have friend access to.
+         */
+        static bool readEntry( const std::string& rootFile,
+                               uint64_t context,
+                               const char* begin,
+                               const char* end,
+                               Deck& );
+        static bool readManifest( reader& );
+        static void readMessages( reader&, MessageContainer& );
+        static void readGraph( reader&, IncludeGraph& );
+        static UnitSystem readUnits( reader& );
+        static Dimension readDimension( reader& );
+        static DeckKeyword readKeyword( reader&, const Deck& );
+        static DeckItem readItem( reader&, const std::shared_ptr< SymbolTable >& );
+
+        static void writeMessages( writer&, const MessageContainer& );
+        static void writeGraph( writer&, const IncludeGraph& );
+        static void writeUnits( writer&, const UnitSystem& );
+        static void writeDimension( writer&, const Dimension& );
+        static void writeKeyword( writer&, const DeckKeyword& );
+        static void writeItem( writer&, const DeckItem& );
+
+        std::string directory;
+        uint64_t keywordHash;
+    };
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_DECK_NAME_INDEX_HPP
+#define OPM_DECK_NAME_INDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <opm/parser/eclipse/Utility/Stringview.hpp>
+
+namespace Opm {
+
+    class ParserKeyword;
+
+    /*
+     * A perfect hash over a fixed set of deck names. Deck names are at most
+     * eight characters, so a name is packed into a 64-bit word and a lookup
+     * is a hash of that word and a single compare.
+     *
+     * The hash is "hash and displace": the name picks a bucket, and the
+     * bucket's displacement picks the slot. The displacements are searched
+     * for by build(), which genkw runs over the names of the default
+     * keywords, and the resulting tables are compiled into the library.
+     */
+    class DeckNameHash {
+    public:
+        static const size_t npos = size_t( -1 );
+
+        DeckNameHash() = default;
+        DeckNameHash( std::vector< uint32_t > displacements,
+                      std::vector< uint64_t > keys );
+
+        static DeckNameHash build( const std::vector< std::string >& names );
+
+        /* false if the name is empty or longer than eight characters */
+        static inline bool pack( const string_view& name, uint64_t& key );
+        static std::string unpack( uint64_t key );
+
+        /* the slot of name, or npos if name is not in the set */
+        inline size_t find( const string_view& name ) const;
+
+        size_t slots() const;
+        const std::vector< uint32_t >& displacements() const;
+        const std::vector< uint64_t >& keys() const;
+
+    private:
+        static inline uint64_t mix( uint64_t );
+        inline size_t bucket( uint64_t key ) const;
+        inline size_t slot( uint64_t key, uint32_t displacement ) const;
+
+        std::vector< uint32_t > m_displacements;
+        std::vector< uint64_t > m_keys;
+    };
+
+    /*
+     * Index of the keywords whose deck names are given by a regular
+     * expression. The literal prefixes of the expression's alternatives, e.g.
+     * "WU" and "WTPR" for "WU.+|WTPR.+", are put in a trie, and only the
+     * keywords with a prefix of the deck name are matched against the
+     * expression. A keyword without a literal prefix, say "(A|B).+", is
+     * matched against every name.
+     */
+    class DeckNamePrefixes {
+    public:
+        DeckNamePrefixes();
+
+        void add( const std::string& regex, const ParserKeyword* );
+        void clear();
+
+        /*
+         * The keyword with the least name whose regular expression matches
+         * the deck name, or nullptr.
+         */
+        const ParserKeyword* match( const string_view& name ) const;
+
+        static std::vector< std::string > literalPrefixes( const std::string& regex );
+
+    private:
+        struct node {
+            std::vector< std::pair< char, size_t > > next;
+            std::vector< const ParserKeyword* > keywords;
+        };
+
+        std::vector< node > nodes;
+    };
+
+    bool DeckNameHash::pack( const string_view& name, uint64_t& key ) {
+        if( name.empty() || name.size() > 8 ) return false;
+
+        key = 0;
+        for( size_t i = 0; i < name.size(); ++i )
+            key |= uint64_t( static_cast< unsigned char >( name[ i ] ) ) << ( 8 * i );
+
+        return true;
+    }
+
+    uint64_t DeckNameHash::mix( uint64_t x ) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    size_t DeckNameHash::bucket( uint64_t key ) const {
+        return mix( key ) & ( this->m_displacements.size() - 1 );
+    }
+
+    size_t DeckNameHash::slot( uint64_t key, uint32_t displacement ) const {
+        return mix( key ^ ( uint64_t( displacement ) * 0x9e3779b97f4a7c15ULL ) )
+             & ( this->m_keys.size() - 1 );
+    }
+
+    size_t DeckNameHash::find( const string_view& name ) const {
+        uint64_t key;
+        if( this->m_keys.empty() || !pack( name, key ) ) return npos;
+
+        const auto pos = this->slot( key, this->m_displacements[ this->bucket( key ) ] );
+        return this->m_keys[ pos ] == key ? pos : npos;
+    }
+}
+
+#endif
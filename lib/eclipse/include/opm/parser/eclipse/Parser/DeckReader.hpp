@@ -0,0 +1,72 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_DECK_READER_HPP
+#define OPM_DECK_READER_HPP
+
+#include <memory>
+#include <string>
+
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+
+namespace Opm {
+
+    class DeckKeyword;
+    class MessageContainer;
+    class Parser;
+    class UnitSystem;
+
+    /*
+     * Read the keywords of a deck one at a time, for tools that walk the
+     * keywords once and have no use for the whole Deck. Only the keyword that
+     * was read last is kept, along with the keywords that give the number of
+     * records of other keywords, such as TABDIMS, so the memory use is bounded
+     * by the largest keyword and the input of the open files.
+     *
+     * The keywords are the ones Parser::parseFile would put in the deck, with
+     * the units of the unit system keywords read so far. Keywords are decoded
+     * as they are read, so the parse threads of the parser are not used, and
+     * neither is the include cache. The parser must outlive the reader.
+     */
+    class DeckReader {
+        public:
+            DeckReader( const Parser&,
+                        const std::string& dataFile,
+                        const ParseContext& = ParseContext() );
+            ~DeckReader();
+
+            /*
+             * The next keyword of the deck, or nullptr after the last one or
+             * an END keyword. The keyword is valid until the next call.
+             */
+            const DeckKeyword* next();
+
+            /* the messages issued so far */
+            const MessageContainer& getMessageContainer() const;
+
+            const UnitSystem& getDefaultUnitSystem() const;
+            const UnitSystem& getActiveUnitSystem() const;
+
+        private:
+            struct Impl;
+            std::unique_ptr< Impl > impl;
+    };
+}
+
+#endif
@@ -0,0 +1,55 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef OPM_DECODE_CACHE_HPP
+#define OPM_DECODE_CACHE_HPP
+
+#include <memory>
+
+namespace Opm {
+
+    /*
+     * The cleaned input of the files that placeholders are decoded from by
+     * Parser::decodeKeyword, so that decoding many keywords of a file reads
+     * and cleans it once.
+     *
+     * A file is checked against the stamp it has in the include graph of the
+     * deck when it is read, and its size and time are looked at again every
+     * time a keyword is decoded from it, so a keyword is never decoded from a
+     * file that has changed since the deck was parsed. The cache is not safe
+     * to use from more than one thread at a time.
+     */
+    class DecodeCache {
+        public:
+            DecodeCache();
+            ~DecodeCache();
+
+            /* the number of files kept */
+            size_t size() const;
+            void clear();
+
+        private:
+            friend class Parser;
+            struct Impl;
+            std::unique_ptr< Impl > impl;
+    };
+}
+
+#endif
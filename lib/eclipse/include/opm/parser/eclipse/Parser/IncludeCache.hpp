@@ -0,0 +1,154 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_INCLUDE_CACHE_HPP
+#define OPM_INCLUDE_CACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Parser/MessageContainer.hpp>
+
+namespace Opm {
+
+    /*
+     * Input files shared by many decks, typically the realisations of an
+     * ensemble which only differ in a few of their INCLUDE files. A file is
+     * kept by its canonical path, with its size, modification time and content
+     * hash, and holds the cleaned input and the keywords decoded from it.
+     *
+     * The decoded keywords of a file are only kept when they can be decoded
+     * without looking at the rest of the deck, save for the keywords giving
+     * the number of records of keywords in the file. These are kept with the
+     * keywords, which are only reused when the deck gives the same sizes. A
+     * file with INCLUDE, PATHS or END keywords, or a keyword spanning the end
+     * of the file, only has its cleaned input cached. The cleaned input of a
+     * file is dropped once keywords are decoded from it, and read again if a
+     * parse cannot reuse them.
+     *
+     * The cache holds at most budget bytes, and the files used least recently
+     * are evicted to stay within it. A file counts with the size of its
+     * cleaned input, if kept, and its size on disk for every set of keywords
+     * decoded from it, which is a rough measure of what these take.
+     *
+     * The cache is safe to share between parsers running concurrently.
+     */
+    class IncludeCache {
+    public:
+        /* a keyword whose number of records is given by another keyword */
+        struct SizeDependency {
+            std::string keyword;
+            std::string item;
+            int shift;
+            /* the size, or whether the keyword was not in the deck */
+            bool found;
+            int size;
+        };
+
+        /* the keywords decoded from a file, with one parse context and parser */
+        struct Keywords {
+            uint64_t context;
+            std::vector< SizeDependency > sizes;
+            std::vector< DeckKeyword > keywords;
+            std::vector< Message > messages;
+            /* if the file ended in an unknown keyword */
+            bool unknown;
+        };
+
+        struct File {
+            std::string path;
+            uint64_t size = 0;
+            int64_t mtime = 0;
+            uint64_t digest = 0;
+            /* when the file was last hashed, see find() */
+            int64_t hashed = 0;
+            std::shared_ptr< const std::string > content;
+            std::vector< std::shared_ptr< const Keywords > > keywords;
+        };
+
+        static const size_t default_budget;
+
+        explicit IncludeCache( size_t budget = default_budget );
+
+        /* the cache shared by every parser in the process that asks for it */
+        static std::shared_ptr< IncludeCache > global();
+
+        /*
+         * The file, if it is cached and has not changed. A file that has
+         * been touched, or modified so close to when it was hashed that the
+         * time cannot tell, is hashed again.
+         */
+        std::shared_ptr< const File > find( const std::string& canonical );
+
+        /*
+         * Cache the cleaned content of the file, whose raw content hashed to
+         * digest. The returned entry is the one in the cache, which may be
+         * from a concurrent insert of the same file. Inserting the content of
+         * a file whose content was dropped restores it, and keeps the
+         * keywords.
+         */
+        std::shared_ptr< const File > insert( const std::string& canonical,
+                                              uint64_t size,
+                                              int64_t mtime,
+                                              uint64_t digest,
+                                              std::string&& content );
+
+        /* add the keywords decoded from the file, unless it has been replaced */
+        void addKeywords( const std::shared_ptr< const File >& file,
+                          std::shared_ptr< const Keywords > keywords );
+
+        /* the keywords decoded with this parse context and parser, or nullptr */
+        static std::shared_ptr< const Keywords > keywords( const File&, uint64_t context );
+
+        size_t size() const;
+        void clear();
+
+        /* the bytes held, and the most that is held before evicting files */
+        size_t bytes() const;
+        size_t budget() const;
+        void setBudget( size_t );
+
+    private:
+        struct Entry {
+            std::shared_ptr< const File > file;
+            size_t bytes = 0;
+            std::list< std::string >::iterator used;
+        };
+
+        /* replace or add the entry of the file, with the lock held */
+        void put( const std::string& canonical, std::shared_ptr< const File > );
+        void touch( Entry& );
+        void evict();
+
+        mutable std::mutex lock;
+        std::map< std::string, Entry > files;
+        /* the paths of the files, the most recently used first */
+        std::list< std::string > recent;
+        size_t total = 0;
+        size_t m_budget;
+    };
+}
+
+#endif
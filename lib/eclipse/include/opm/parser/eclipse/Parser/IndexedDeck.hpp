@@ -0,0 +1,94 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_INDEXED_DECK_HPP
+#define OPM_INDEXED_DECK_HPP
+
+#include <map>
+#include <string>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Parser/DecodeCache.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+
+namespace Opm {
+
+    class Parser;
+
+    /*
+     * A deck whose keywords are decoded when they are asked for, for tools
+     * that need a few keywords of a large deck, such as the third WCONPROD of
+     * the SCHEDULE section.
+     *
+     * The index is the deck from Parser::indexFile, with a placeholder for
+     * every keyword that has the file, line, extent and number of records of
+     * the keyword. It is kept in the file indexPath( dataFile ), and read back
+     * from there as long as neither the files of the deck, the ParseContext
+     * nor the keywords of the parser have changed. An index file that cannot
+     * be written is not an error.
+     *
+     * The decoded keywords are kept, and the messages from decoding them are
+     * added to the messages of the index. The cleaned input of the files is
+     * kept as well, so a file is read once however many keywords are
+     * decoded from it. A file is checked against the manifest of the index
+     * when it is read, and its size and time on every decode, so a keyword
+     * of a file changed since the index was made throws rather than decode
+     * the new content. The parser must outlive the deck.
+     */
+    class IndexedDeck {
+        public:
+            IndexedDeck( const Parser&,
+                         const std::string& dataFile,
+                         const ParseContext& = ParseContext() );
+
+            /* the placeholders, and the keywords that were decoded to size others */
+            const Deck& getIndex() const;
+
+            size_t size() const;
+            bool hasKeyword( const std::string& keyword ) const;
+            size_t count( const std::string& keyword ) const;
+
+            const DeckKeyword& getKeyword( size_t index ) const;
+            const DeckKeyword& getKeyword( const std::string& keyword, size_t index ) const;
+            const DeckKeyword& getKeyword( const std::string& keyword ) const;
+
+            /* the index'th keyword with this name in the section */
+            const DeckKeyword& getKeyword( const std::string& section,
+                                           const std::string& keyword,
+                                           size_t index ) const;
+
+            /* the decoded keyword of a keyword of the index, such as from a Section of it */
+            const DeckKeyword& decode( const DeckKeyword& ) const;
+
+            const MessageContainer& getMessageContainer() const;
+            const UnitSystem& getActiveUnitSystem() const;
+
+            /* the file the index of the deck in dataFile is kept in */
+            static std::string indexPath( const std::string& dataFile );
+
+        private:
+            const Parser& parser;
+            const ParseContext parseContext;
+            Deck index;
+            mutable std::map< size_t, DeckKeyword > decoded;
+            mutable DecodeCache inputs;
+    };
+}
+
+#endif
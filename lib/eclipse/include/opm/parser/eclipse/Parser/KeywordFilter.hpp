@@ -0,0 +1,63 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_KEYWORD_FILTER_HPP
+#define OPM_KEYWORD_FILTER_HPP
+
+#include <set>
+#include <string>
+
+namespace Opm {
+
+    /*
+     * The keywords whose records the parser decodes, by keyword name or by
+     * the section the keyword is in, either as a list of the ones to decode
+     * or of the ones to skip. The keywords before the first section keyword
+     * are in the section "".
+     *
+     * The keywords that give the number of records of other keywords, such
+     * as TABDIMS, are decoded whatever the filter says.
+     */
+    class KeywordFilter {
+        public:
+            /* decode only the listed keywords, and the keywords of the listed sections */
+            static KeywordFilter allow( std::set< std::string > keywords,
+                                        std::set< std::string > sections = {} );
+
+            /* decode every keyword but the listed ones, and the ones of the listed sections */
+            static KeywordFilter deny( std::set< std::string > keywords,
+                                       std::set< std::string > sections = {} );
+
+            bool decode( const std::string& keyword, const std::string& section ) const;
+
+            /* true for the keywords that start a section */
+            static bool isSection( const std::string& keyword );
+
+        private:
+            KeywordFilter( bool allowList,
+                           std::set< std::string > keywords,
+                           std::set< std::string > sections );
+
+            bool allowList;
+            std::set< std::string > keywords;
+            std::set< std::string > sections;
+    };
+}
+
+#endif
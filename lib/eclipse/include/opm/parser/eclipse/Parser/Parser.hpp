@@ -20,6 +20,8 @@
 #ifndef OPM_PARSER_HPP
 #define OPM_PARSER_HPP
 
+#include <cstdint>
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -28,6 +30,7 @@
 #include <boost/filesystem.hpp>
 
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/Parser/DeckNameIndex.hpp>
 #include <opm/parser/eclipse/Parser/ParserKeyword.hpp>
 #include <opm/parser/eclipse/Utility/Stringview.hpp>
 
@@ -38,6 +41,9 @@ namespace Json {
 namespace Opm {
 
     class Deck;
+    class DecodeCache;
+    class IncludeCache;
+    class KeywordFilter;
     class ParseContext;
     class RawKeyword;
 
@@ -51,6 +57,83 @@ namespace Opm {
 
         static std::string stripComments(const std::string& inputString);
 
+        /// Decode the keywords on this many threads. The keywords are still
+        /// found and the INCLUDE files opened sequentially, and the resulting
+        /// Deck and its messages are the same as when parsing sequentially,
+        /// which is the default. Zero means one thread per processor.
+        void setParseThreads(size_t threads);
+        size_t getParseThreads() const;
+
+        /// Read and clean INCLUDE files on this many background threads,
+        /// ahead of the parser reaching them. Zero, the default, reads every
+        /// file when the parser gets to it.
+        void setIncludePrefetchThreads(size_t threads);
+        size_t getIncludePrefetchThreads() const;
+
+        /// Called at the end of every parse with the number of INCLUDE files
+        /// that were found prefetched (hits) and that had to be read when the
+        /// parser reached them (misses).
+        using PrefetchHook = std::function< void( size_t hits, size_t misses ) >;
+        void setIncludePrefetchHook(PrefetchHook hook);
+
+        /// Keep the decks parsed by parseFile in this directory, and read a
+        /// deck back from it instead of parsing it when neither its files,
+        /// the ParseContext nor the keywords of the parser have changed. The
+        /// prefetch hook is called with no hits and no misses for a deck read
+        /// from the cache. Empty, the default, turns the cache off.
+        void setDeckCacheDirectory(const std::string& directory);
+        const std::string& getDeckCacheDirectory() const;
+
+        /// Share the INCLUDE files, and the keywords decoded from them, with
+        /// the other parsers using this cache, such as IncludeCache::global().
+        /// A file is then read and decoded once, however many decks include
+        /// it, as long as it does not change. The cache reads the files itself, so
+        /// no files are prefetched when it is set. nullptr, the default,
+        /// turns the cache off.
+        void setIncludeCache(std::shared_ptr< IncludeCache > cache);
+        std::shared_ptr< IncludeCache > getIncludeCache() const;
+
+        /// Only decode the records of the keywords the filter lets through.
+        /// The other keywords are still found, and sized, but end up in the
+        /// deck as placeholders without records, which decodeKeyword
+        /// decodes on demand. The deck cache and the include cache are not
+        /// used while a filter is set. nullptr, the default, decodes every
+        /// keyword.
+        void setKeywordFilter(std::shared_ptr< const KeywordFilter > filter);
+        std::shared_ptr< const KeywordFilter > getKeywordFilter() const;
+
+        /// Convert the double values of the items with a dimension to SI
+        /// in place when the units are applied, with DeckItem::convertToSI,
+        /// so the deck keeps one copy of them. get< double >() then returns
+        /// SI values as well, and DeckItem::getRawDouble the values of the
+        /// deck. Off, the default, converts on the first getSIDouble.
+        void setSIConversion(bool convert);
+        bool getSIConversion() const;
+
+        /// The keyword with the records of a placeholder of the deck, read
+        /// again from its file, which must not have changed since: a file
+        /// whose size or content differs from its stamp in the include graph
+        /// of the deck throws. The values are in the units of the deck, and
+        /// the messages are added to the deck. Other keywords are returned
+        /// as they are. The file is read and cleaned again on every call,
+        /// unless a cache is given to keep it in between.
+        DeckKeyword decodeKeyword(const Deck& deck,
+                                  const DeckKeyword& placeholder,
+                                  const ParseContext& = ParseContext(),
+                                  DecodeCache* cache = nullptr) const;
+
+        /// The deck of the data file with placeholders for its keywords, as
+        /// parsed with a filter that lets no keyword through, whatever the
+        /// filter of the parser. This finds the keywords and the extent of
+        /// their records without decoding them, which makes it the index of
+        /// the deck IndexedDeck is built on.
+        Deck indexFile(const std::string& dataFile,
+                       const ParseContext& = ParseContext()) const;
+
+        /// A hash of the definitions of every keyword of the parser, and of
+        /// the SI conversion, which both change the decoded keywords.
+        uint64_t getKeywordHash() const;
+
         /// The starting point of the parsing process. The supplied file is parsed, and the resulting Deck is returned.
         Deck parseFile(const std::string &dataFile,
                        const ParseContext& = ParseContext()) const;
@@ -58,6 +141,20 @@ namespace Opm {
                          const ParseContext& = ParseContext()) const;
         Deck parseStream(std::unique_ptr<std::istream>&& inputStream , const ParseContext& parseContext) const;
 
+        /// Parse the changed files of a deck again, and splice their new
+        /// keywords and messages into it, as if the whole deck was parsed
+        /// again. Only the changed files are parsed, along with the files
+        /// whose keywords have their number of records given by a keyword
+        /// that changed. When that is not enough, say for a changed data
+        /// file, or if the deck was read from the deck cache, the whole deck
+        /// is parsed again, which throws std::invalid_argument for a deck
+        /// parsed from a string. Returns the number of files that were parsed.
+        /// Sections of the deck, and references to its keywords, are not
+        /// valid after the update.
+        size_t updateDeck(Deck& deck,
+                          const std::vector<std::string>& changedFiles,
+                          const ParseContext& = ParseContext()) const;
+
         /// Method to add ParserKeyword instances, these holding type and size information about the keywords and their data.
         void addParserKeyword(const Json::JsonObject& jsonKeyword);
         void addParserKeyword(std::unique_ptr< const ParserKeyword >&& parserKeyword);
@@ -115,16 +212,38 @@ namespace Opm {
     private:
         // associative map of the parser internal name and the corresponding ParserKeyword object
         std::vector< std::unique_ptr< const ParserKeyword > > keyword_storage;
-        // associative map of deck names and the corresponding ParserKeyword object
+        // the ParserKeyword object of every deck name of the default keywords,
+        // by the slot of the name in defaultDeckNames(). The slots of keywords
+        // that have not been added are nullptr.
+        std::vector< const ParserKeyword* > m_defaultDeckKeywords;
+        // associative map of the other deck names and the corresponding ParserKeyword object
         std::map< string_view, const ParserKeyword* > m_deckParserKeywords;
         // associative map of the parser internal names and the corresponding
         // ParserKeyword object for keywords which match a regular expression
         std::map< string_view, const ParserKeyword* > m_wildCardKeywords;
+        DeckNamePrefixes m_wildCardPrefixes;
+
+        size_t m_parseThreads = 1;
+        size_t m_prefetchThreads = 0;
+        PrefetchHook m_prefetchHook;
+        std::string m_deckCacheDirectory;
+        std::shared_ptr< IncludeCache > m_includeCache;
+        std::shared_ptr< const KeywordFilter > m_keywordFilter;
+        bool m_siConversion = false;
+        // hash of the definitions of every keyword, which is part of the key
+        // of the cached decks and include files
+        uint64_t m_keywordHash = 0;
 
         bool hasWildCardKeyword(const std::string& keyword) const;
         const ParserKeyword* matchingKeyword(const string_view& keyword) const;
+        const ParserKeyword* deckKeyword(const string_view& deckName) const;
 
         void addDefaultKeywords();
+        void hashKeywords();
+        void applyUnitsToKeywords(Deck& deck, Deck& keywords) const;
+        size_t reparseDeck(Deck& deck, const ParseContext&) const;
+        // generated by genkw, along with addDefaultKeywords()
+        static const DeckNameHash& defaultDeckNames();
     };
 
 } // namespace Opm
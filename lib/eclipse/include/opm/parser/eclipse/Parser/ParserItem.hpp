@@ -70,10 +70,11 @@ namespace Opm {
         bool operator==( const ParserItem& ) const;
         bool operator!=( const ParserItem& ) const;
 
-        DeckItem scan( RawRecord& rawRecord ) const;
+        DeckItem scan( RawRecord& rawRecord, size_t sizeHint = 0,
+                       const std::shared_ptr< SymbolTable >& symbols = {} ) const;
         const std::string className() const;
         std::string createCode() const;
-        std::ostream& inlineClass(std::ostream&, const std::string& indent) const;
+        std::ostream& inlineClass(std::ostream&, const std::string& indent, size_t index) const;
         std::string inlineClassInit(const std::string& parentClass,
                                     const std::string* defaultValue = nullptr ) const;
 
@@ -94,6 +94,7 @@ namespace Opm {
         static bool validInternalName(const std::string& name);
         static bool validDeckName(const string_view& name);
         bool hasMatchRegex() const;
+        const std::string& getMatchRegex() const;
         void setMatchRegex(const std::string& deckNameRegexp);
         bool matches(const string_view& ) const;
         bool hasDimension() const;
@@ -123,7 +124,8 @@ namespace Opm {
         SectionNameSet::const_iterator validSectionNamesBegin() const;
         SectionNameSet::const_iterator validSectionNamesEnd() const;
 
-        DeckKeyword parse(const ParseContext& parseContext , MessageContainer& msgContainer, std::shared_ptr< RawKeyword > rawKeyword) const;
+        DeckKeyword parse(const ParseContext& parseContext , MessageContainer& msgContainer, std::shared_ptr< RawKeyword > rawKeyword, size_t dataSizeHint = 0,
+                          const std::shared_ptr< SymbolTable >& symbols = {}) const;
         enum ParserKeywordSizeEnum getSizeType() const;
         const KeywordSize& getKeywordSize() const;
         bool isDataKeyword() const;
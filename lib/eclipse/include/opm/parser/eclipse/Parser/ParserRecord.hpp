@@ -43,7 +43,8 @@ namespace Opm {
         void addDataItem( ParserItem item );
         const ParserItem& get(size_t index) const;
         const ParserItem& get(const std::string& itemName) const;
-        DeckRecord parse( const ParseContext&, MessageContainer&, RawRecord& ) const;
+        DeckRecord parse( const ParseContext&, MessageContainer&, RawRecord&, size_t dataSizeHint = 0,
+                          const std::shared_ptr< SymbolTable >& symbols = {} ) const;
         bool isDataRecord() const;
         bool equal(const ParserRecord& other) const;
         bool hasDimension() const;
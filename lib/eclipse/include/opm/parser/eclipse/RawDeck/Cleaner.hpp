@@ -0,0 +1,70 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_RAW_CLEANER_HPP
+#define OPM_RAW_CLEANER_HPP
+
+namespace Opm {
+
+    /*
+     * The cleaner removes everything from the raw input that isn't
+     * interesting data, line by line: comments, everything after a
+     * (terminating) slash, and leading and trailing whitespace. Comment
+     * markers and slashes inside balanced quotes are kept:
+     *
+     * ABC --Comment                =>  ABC
+     * ABC '--Comment1' --Comment2  =>  ABC '--Comment1'
+     * ABC "-- Not balanced quote?  =>  ABC "-- Not balanced quote?
+     *   1 2 3 / 4 5 -- comment     =>  1 2 3 /
+     *
+     * Every input byte goes through the cleaner, so the input is searched for
+     * the few characters that matter (newline, '-', '/' and quotes) a block
+     * at a time with SSE4.2 or AVX2 when the processor supports it, chosen at
+     * runtime.
+     */
+    namespace Cleaner {
+
+        enum class ISA { scalar, sse42, avx2 };
+
+        /* true if the instruction set is available on this processor */
+        bool supported( ISA );
+
+        /* the fastest instruction set available on this processor */
+        ISA best();
+
+        /*
+         * Clean the input in [begin, end) in place, and return the end of the
+         * cleaned text. Every line, including the last one, is terminated by
+         * a newline, so the cleaned text can be one byte longer than the
+         * input and *end must be writable.
+         *
+         * Lines that are already clean are not written to, which keeps the
+         * untouched pages of a private file mapping shared.
+         */
+        char* clean( char* begin, char* end );
+
+        /*
+         * Clean with a specific instruction set. Throws std::invalid_argument
+         * if it isn't supported.
+         */
+        char* clean( char* begin, char* end, ISA );
+    }
+}
+
+#endif
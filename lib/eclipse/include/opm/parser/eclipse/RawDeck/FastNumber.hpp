@@ -0,0 +1,45 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPM_RAW_FAST_NUMBER_HPP
+#define OPM_RAW_FAST_NUMBER_HPP
+
+namespace Opm {
+
+    /*
+     * Allocation-free parsers for the numbers that make up the bulk of a
+     * deck, like 0.25, -1.5E+03, 1.234D5 and 42. Doubles are correctly
+     * rounded, using Clinger's fast path when the value is exact and the
+     * Eisel-Lemire algorithm otherwise.
+     *
+     * The parsers only handle the common forms, and return false for
+     * anything else: tokens with more than 19 significant digits, extreme
+     * exponents, subnormals, nan and inf, and everything malformed. The
+     * caller is expected to fall back to the general (and slow) parser in
+     * that case, which also decides what is an error.
+     */
+    namespace FastNumber {
+
+        bool parse( const char* begin, const char* end, double& );
+        bool parse( const char* begin, const char* end, int& );
+
+    }
+}
+
+#endif
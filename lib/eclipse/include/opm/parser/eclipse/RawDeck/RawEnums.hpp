@@ -30,6 +30,18 @@ namespace Opm {
             UNKNOWN = 3,
             TABLE_COLLECTION = 4
         };
+
+        /*
+         * What a line that is not part of the records of a keyword holds: the
+         * name of a keyword, data, a lone record terminator or something
+         * else.
+         */
+        enum class LineType {
+            KEYWORD,
+            DATA,
+            TERMINATOR,
+            GARBAGE
+        };
     }
 }
 
@@ -25,7 +25,9 @@
 #include <vector>
 #include <list>
 
+#include <opm/parser/eclipse/RawDeck/RawConsts.hpp>
 #include <opm/parser/eclipse/RawDeck/RawEnums.hpp>
+#include <opm/parser/eclipse/Utility/SourceNames.hpp>
 #include <opm/parser/eclipse/Utility/Stringview.hpp>
 
 namespace Opm {
@@ -42,6 +44,8 @@ namespace Opm {
     public:
         RawKeyword(const string_view& name , Raw::KeywordSizeEnum sizeType , const std::string& filename, size_t lineNR);
         RawKeyword(const string_view& name , const std::string& filename, size_t lineNR , size_t inputSize , bool isTableCollection = false);
+        RawKeyword(const string_view& name , Raw::KeywordSizeEnum sizeType , std::shared_ptr< SourceNames > names, SourceNames::id file, size_t lineNR);
+        RawKeyword(const string_view& name , std::shared_ptr< SourceNames > names, SourceNames::id file, size_t lineNR , size_t inputSize , bool isTableCollection = false);
 
         const std::string& getKeywordName() const;
         void addRawRecordString( const string_view& );
@@ -53,6 +57,17 @@ namespace Opm {
         // iterator interface.
         const RawRecord& getFirstRecord( ) const;
 
+        /// A deck name folded to upper case, stored in place.
+        struct DeckName {
+            char chars[ RawConsts::maxKeywordLength + 1 ];
+            size_t size = 0;
+
+            string_view view() const { return { chars, size }; }
+        };
+
+        /// Decide what a line outside the records of a keyword is, without
+        /// copying it. For a keyword, the name is written to deckName.
+        static Raw::LineType classifyLine(const string_view& line, DeckName& deckName);
         static bool isKeywordPrefix(const string_view& line, std::string& keywordName);
 
         bool isPartialRecordStringEmpty() const;
@@ -61,6 +76,9 @@ namespace Opm {
         void finalizeUnknownSize();
 
         const std::string& getFilename() const;
+        SourceNames::id getFileId() const;
+        /* the table of the names of the file and the keyword */
+        const std::shared_ptr< SourceNames >& getSourceNames() const;
         size_t getLineNR() const;
 
         using const_iterator = std::list< RawRecord >::const_iterator;
@@ -84,10 +102,12 @@ namespace Opm {
         string_view m_partialRecordString;
 
         size_t m_lineNR;
-        std::string m_filename;
+        std::shared_ptr< SourceNames > m_names;
+        SourceNames::id m_file;
+        SourceNames::id m_keyword;
         bool m_is_title = false;
 
-        void commonInit(const std::string& name,const std::string& filename, size_t lineNR);
+        void commonInit(const std::string& name, std::shared_ptr< SourceNames > names, SourceNames::id file, size_t lineNR);
         void setKeywordName(const std::string& keyword);
         static bool isValidKeyword(const std::string& keywordCandidate);
     };
@@ -20,11 +20,16 @@
 #ifndef RECORD_HPP
 #define RECORD_HPP
 
-#include <deque>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <list>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
+#include <opm/parser/eclipse/RawDeck/RawConsts.hpp>
+#include <opm/parser/eclipse/Utility/SourceNames.hpp>
 #include <opm/parser/eclipse/Utility/Stringview.hpp>
 
 namespace Opm {
@@ -32,10 +37,18 @@ namespace Opm {
     /// Class representing the lowest level of the Raw datatypes, a record. A record is simply
     /// a vector containing the record elements, represented as strings. Some logic is present
     /// to handle special elements in a record string, particularly with quote characters.
+    ///
+    /// The tokens are stored contiguously and consumed from the front with a read cursor.
+    /// Tokens added to the front with prepend are kept as (token, count) repeat entries, so
+    /// prepending N copies of a token is O(1). The record string is not split into tokens
+    /// until they are first asked for, so a reader that tokenizes the record string itself
+    /// (see popRecordString) never pays for the token vector.
 
     class RawRecord {
     public:
         RawRecord( const string_view&, const std::string& fileName = "", const std::string& keywordName = "");
+        RawRecord( const string_view&, std::shared_ptr< const SourceNames > names,
+                   SourceNames::id file, SourceNames::id keyword );
 
         inline string_view pop_front();
         void push_front( string_view token );
@@ -43,39 +56,105 @@ namespace Opm {
         inline size_t size() const;
 
         std::string getRecordString() const;
+        inline string_view getRecordView() const;
+        bool popRecordString( string_view& );
         inline string_view getItem(size_t index) const;
         const std::string& getFileName() const;
         const std::string& getKeywordName() const;
 
         static bool isTerminatedRecordString( const string_view& );
+        static inline string_view nextToken( string_view::const_iterator& begin,
+                                             string_view::const_iterator end );
 
        void dump() const;
 
     private:
+        struct repeat {
+            string_view token;
+            size_t count;
+        };
+
         string_view m_sanitizedRecordString;
-        std::deque< string_view > m_recordItems;
-        const std::string m_fileName;
-        const std::string m_keywordName;
+        mutable std::vector< string_view > m_recordItems;
+        mutable bool m_tokenized = false;
+        size_t m_cursor = 0;
+        /* the front of the record is the back of m_repeats */
+        std::vector< repeat > m_repeats;
+        mutable size_t m_size = 0;
+        std::shared_ptr< const SourceNames > m_names;
+        const SourceNames::id m_file;
+        const SourceNames::id m_keyword;
+
+        RawRecord( const string_view&, std::shared_ptr< SourceNames > names,
+                   const std::string& fileName, const std::string& keywordName );
 
         void setRecordString(const std::string& singleRecordString);
+        inline void tokenize() const;
+        void splitRecordString() const;
     };
 
     /*
      * These are frequently called, but fairly trivial in implementation, and
      * inlining the calls gives a decent low-effort performance benefit.
      */
+    void RawRecord::tokenize() const {
+        if( !this->m_tokenized ) this->splitRecordString();
+    }
+
     string_view RawRecord::pop_front() {
-        auto front = m_recordItems.front();
-        this->m_recordItems.pop_front();
-        return front;
+        this->tokenize();
+        --this->m_size;
+
+        if( this->m_repeats.empty() )
+            return this->m_recordItems[ this->m_cursor++ ];
+
+        auto& front = this->m_repeats.back();
+        const auto token = front.token;
+        if( --front.count == 0 ) this->m_repeats.pop_back();
+        return token;
     }
 
     size_t RawRecord::size() const {
-        return m_recordItems.size();
+        this->tokenize();
+        return this->m_size;
     }
 
     string_view RawRecord::getItem(size_t index) const {
-        return this->m_recordItems.at( index );
+        this->tokenize();
+        if( index >= this->m_size )
+            throw std::out_of_range( "RawRecord::getItem: index out of range" );
+
+        for( auto rep = this->m_repeats.rbegin(); rep != this->m_repeats.rend(); ++rep ) {
+            if( index < rep->count ) return rep->token;
+            index -= rep->count;
+        }
+
+        return this->m_recordItems[ this->m_cursor + index ];
+    }
+
+    string_view RawRecord::getRecordView() const {
+        return this->m_sanitizedRecordString;
+    }
+
+    /*
+     * Find the next token in the record string, starting at begin, and move
+     * begin past it. A quoted string is a single token, including the quotes.
+     * Returns an empty view when there are no more tokens.
+     */
+    string_view RawRecord::nextToken( string_view::const_iterator& begin,
+                                      string_view::const_iterator end ) {
+        auto current = std::find_if_not( begin, end, RawConsts::is_separator() );
+        if( current == end ) {
+            begin = end;
+            return {};
+        }
+
+        auto token_end = *current == RawConsts::quote
+                       ? std::find( current + 1, end, RawConsts::quote ) + 1
+                       : std::find_if( current, end, RawConsts::is_separator() );
+
+        begin = token_end;
+        return { current, token_end };
     }
 }
 
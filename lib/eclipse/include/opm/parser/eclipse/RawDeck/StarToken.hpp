@@ -26,9 +26,13 @@
 #include <ert/util/ssize_t.h>
 
 namespace Opm {
+    /*
+     * The count and value strings are views into the token, so the token must
+     * outlive them.
+     */
     bool isStarToken(const string_view& token,
-                           std::string& countString,
-                           std::string& valueString);
+                           string_view& countString,
+                           string_view& valueString);
 
     template <class T>
     T readValueToken( string_view );
@@ -42,7 +46,7 @@ public:
         init_(token);
     }
 
-    StarToken(const string_view& token, const std::string& countStr, const std::string& valueStr)
+    StarToken(const string_view& token, const string_view& countStr, const string_view& valueStr)
         : m_countString(countStr)
         , m_valueString(valueStr)
     {
@@ -60,7 +64,7 @@ public:
     // returns the coubt as rendered in the deck. note that this might be different
     // than just converting the return value of count() to a string because an empty
     // count is interpreted as 1...
-    const std::string& countString() const {
+    const string_view& countString() const {
         return m_countString;
     }
 
@@ -69,18 +73,19 @@ public:
     // might have different representations in the deck (e.g. strings can be
     // specified with and without quotes and but spaces are only allowed using the
     // first representation.)
-    const std::string& valueString() const {
+    const string_view& valueString() const {
         return m_valueString;
     }
 
 private:
     // internal initialization method. the m_countString and m_valueString attributes
-    // must be set before calling this method.
+    // must be set before calling this method. they are views into the token, so
+    // a StarToken must not outlive the token it was made from.
     void init_(const string_view& token);
 
     ssize_t m_count;
-    std::string m_countString;
-    std::string m_valueString;
+    string_view m_countString;
+    string_view m_valueString;
 };
 }
 
@@ -38,6 +38,8 @@ namespace Opm {
         bool equal(const Dimension& other) const;
         const std::string& getName() const;
         bool isCompositable() const;
+        // a factor of NaN, for a unit which is given by other keywords
+        bool isContextDependent() const;
         static Dimension newComposite(const std::string& dim, double SIfactor, double SIoffset = 0.0);
 
         bool operator==( const Dimension& ) const;
@@ -47,6 +49,8 @@ namespace Opm {
         std::string m_name;
         double m_SIfactor;
         double m_SIoffset;
+
+        friend class DeckCache;
     };
 }
 
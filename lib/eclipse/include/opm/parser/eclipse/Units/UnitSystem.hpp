@@ -107,6 +107,8 @@ namespace Opm {
         const double* measure_table_from_si;
         const double* measure_table_to_si;
         const char* const*  unit_name_table;
+
+        friend class DeckCache;
     };
 }
 
@@ -0,0 +1,60 @@
+/*
+  Copyright 2016 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SOURCE_NAMES_HPP
+#define OPM_SOURCE_NAMES_HPP
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Opm {
+
+    /*
+     * The names of input files and keywords, interned once in a table of the
+     * deck. The raw and deck objects refer to their file and keyword with an
+     * id from this table, and share the table with the deck, so the names
+     * live as long as the deck or any keyword that was taken out of it. The
+     * id is only turned back into text when it is asked for.
+     *
+     * The id of the empty name is 0. Names can be interned from several
+     * threads at once.
+     */
+    class SourceNames {
+        public:
+            using id = uint32_t;
+
+            id intern( const std::string& );
+            const std::string& name( id ) const;
+
+            /* the number of names, including the empty one */
+            size_t size() const;
+
+        private:
+            mutable std::mutex lock;
+            /* a deque, so a reference to a name stays valid when names are added */
+            std::deque< std::string > names { std::string() };
+            std::unordered_map< std::string, id > ids { { std::string(), 0 } };
+    };
+
+}
+
+#endif // OPM_SOURCE_NAMES_HPP
@@ -0,0 +1,166 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE CleanerTests
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/RawDeck/Cleaner.hpp>
+#include <opm/parser/eclipse/RawDeck/RawConsts.hpp>
+
+using namespace Opm;
+
+namespace {
+
+/*
+ * The line-by-line reference the cleaner must reproduce exactly: comments are
+ * stripped with Parser::stripComments, then everything after the first
+ * unquoted slash is removed (the slash itself is kept) and the result is
+ * trimmed.
+ */
+std::string strip_slash( const std::string& line ) {
+    auto begin = line.begin();
+    while( true ) {
+        const auto slash = std::find( begin, line.end(), '/' );
+        if( slash == line.end() ) return line;
+
+        const auto qbegin = std::find_if( begin, line.end(), RawConsts::is_quote() );
+        if( qbegin == line.end() || qbegin > slash )
+            return { line.begin(), slash + 1 };
+
+        const auto qend = std::find( qbegin + 1, line.end(), *qbegin );
+        if( qend == line.end() ) return line;
+
+        begin = qend + 1;
+    }
+}
+
+std::string trim( const std::string& line ) {
+    const auto first = std::find_if_not( line.begin(), line.end(), RawConsts::is_separator() );
+    const auto last = std::find_if_not( line.rbegin(), std::string::const_reverse_iterator( first ),
+                                        RawConsts::is_separator() ).base();
+    return { first, last };
+}
+
+std::string reference( const std::string& input ) {
+    std::string output;
+    std::string::size_type begin = 0;
+
+    while( true ) {
+        const auto eol = input.find( '\n', begin );
+        const auto line = input.substr( begin, eol == std::string::npos ? std::string::npos : eol - begin );
+        output += trim( strip_slash( Parser::stripComments( line ) ) ) + '\n';
+
+        if( eol == std::string::npos ) return output;
+        begin = eol + 1;
+    }
+}
+
+std::string clean( std::string input, Cleaner::ISA isa ) {
+    const auto size = input.size();
+    input.push_back( '\0' );
+    auto* begin = &input[ 0 ];
+    input.resize( Cleaner::clean( begin, begin + size, isa ) - begin );
+    return input;
+}
+
+std::vector< Cleaner::ISA > supported_isas() {
+    std::vector< Cleaner::ISA > isas;
+    for( auto isa : { Cleaner::ISA::scalar, Cleaner::ISA::sse42, Cleaner::ISA::avx2 } )
+        if( Cleaner::supported( isa ) ) isas.push_back( isa );
+
+    return isas;
+}
+
+void check_all( const std::string& input ) {
+    const auto expected = reference( input );
+    for( auto isa : supported_isas() )
+        BOOST_CHECK_EQUAL( expected, clean( input, isa ) );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(ScalarAlwaysSupported) {
+    BOOST_CHECK( Cleaner::supported( Cleaner::ISA::scalar ) );
+    BOOST_CHECK( Cleaner::supported( Cleaner::best() ) );
+}
+
+BOOST_AUTO_TEST_CASE(CleanLines) {
+    BOOST_CHECK_EQUAL( "ABC\n", clean( "ABC --Comment", Cleaner::ISA::scalar ) );
+    BOOST_CHECK_EQUAL( "ABC '--Comment1'\n", clean( "ABC '--Comment1' --Comment2", Cleaner::ISA::scalar ) );
+    BOOST_CHECK_EQUAL( "ABC \"-- Not balanced quote?\n", clean( "ABC \"-- Not balanced quote?", Cleaner::ISA::scalar ) );
+    BOOST_CHECK_EQUAL( "1 2 3 /\n", clean( "  1 2 3 / 4 5 -- comment", Cleaner::ISA::scalar ) );
+    BOOST_CHECK_EQUAL( "'A/B' /\n", clean( "'A/B' / C", Cleaner::ISA::scalar ) );
+    BOOST_CHECK_EQUAL( "\n\n", clean( "\n", Cleaner::ISA::scalar ) );
+    BOOST_CHECK_EQUAL( "\n", clean( "", Cleaner::ISA::scalar ) );
+}
+
+BOOST_AUTO_TEST_CASE(CleanFixedInput) {
+    check_all( "RUNSPEC\n\nDIMENS\n 10 10 10 /\n" );
+    check_all( "-- comment only\nTITLE\n  a title with a - dash -- and a comment\n" );
+    check_all( "WELSPECS\n 'PROD' 'G1' 10 10 8400 'OIL' / -- well\n 'INJ--X' 'G1' 1 1 8335 'WATER' /\n/\n" );
+    check_all( "INCLUDE\n  'path/to/file.inc' /\nINCLUDE\n  \"path/--/file.inc\" /\n" );
+    check_all( "ABC'--'DEF\"--\"GHI\nABC'--'DEF'--GHI\n'unbalanced / -- quote\n" );
+    check_all( "PORO\n 1000*0.25 /\n\r\n\t , \t\n-1.5e-3 -2 --3 4- -- 5\n" );
+    check_all( std::string( 200, ' ' ) + "--" + std::string( 100, '-' ) + "\n" + std::string( 300, '1' ) + "/" );
+}
+
+/*
+ * Random input from an alphabet that is dense in the characters the cleaner
+ * cares about, to cover quotes, comments and slashes at every position
+ * relative to the block boundaries.
+ */
+BOOST_AUTO_TEST_CASE(CleanRandomInput) {
+    const std::string alphabet = "0123456789.e-----///''\"\"   ,\t\r\n\nABC*"
+                                 "\xa7\xa2\xa0\x8a";
+    std::mt19937 rng( 1234 );
+    std::uniform_int_distribution< size_t > character( 0, alphabet.size() - 1 );
+    std::uniform_int_distribution< size_t > length( 0, 400 );
+
+    for( int i = 0; i < 2000; ++i ) {
+        std::string input( length( rng ), ' ' );
+        for( auto& ch : input ) ch = alphabet[ character( rng ) ];
+        check_all( input );
+    }
+}
+
+/*
+ * Long data lines with few interesting characters, which is where the vector
+ * paths skip most of the input.
+ */
+BOOST_AUTO_TEST_CASE(CleanLongLines) {
+    std::mt19937 rng( 4321 );
+    std::uniform_int_distribution< size_t > position( 0, 999 );
+    const std::string specials = "-/'\"\n";
+
+    for( int i = 0; i < 500; ++i ) {
+        std::string input( 1000, '7' );
+        for( size_t j = 0; j < 1000; j += 7 ) input[ j ] = ' ';
+        for( int j = 0; j < 4; ++j )
+            input[ position( rng ) ] = specials[ position( rng ) % specials.size() ];
+
+        check_all( input );
+    }
+}
@@ -0,0 +1,232 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE DeckCacheTests
+
+#include <fstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/IncludeGraph.hpp>
+#include <opm/parser/eclipse/Parser/DeckCache.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+
+#include "DeckTestUtils.hpp"
+
+using namespace Opm;
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct CaseDir : test::CaseDir {
+    CaseDir() :
+        test::CaseDir( "deckcache" ),
+        cache( ( dir / "cache" ).string() )
+    {
+        write( "CASE.DATA", R"(
+RUNSPEC
+FIELD
+DIMENS
+ 10 10 1 /
+TABDIMS
+ 1 1 2* /
+GRID
+INCLUDE
+ 'include/poro.inc' /
+INCLUDE
+ 'include/missing.inc' /
+PERMX
+ 50*100 50*200 /
+PROPS
+PVDG
+ 1 2 3
+ 4 5 6 /
+)" );
+        write( "include/poro.inc", "PORO\n 100*0.25 /\n" );
+    }
+
+    size_t entries() const {
+        if( !fs::exists( cache ) ) return 0;
+        return std::distance( fs::directory_iterator( cache ), fs::directory_iterator() );
+    }
+
+    std::string cache;
+};
+
+using test::checkEqual;
+
+}
+
+BOOST_AUTO_TEST_CASE(Hash) {
+    const std::string str = "The quick brown fox jumps over the lazy dog";
+
+    BOOST_CHECK_EQUAL( DeckCache::hash( str.data(), str.size() ),
+                       DeckCache::hash( str.data(), str.size() ) );
+    BOOST_CHECK( DeckCache::hash( str.data(), str.size() )
+              != DeckCache::hash( str.data(), str.size() - 1 ) );
+    BOOST_CHECK( DeckCache::hash( str.data(), str.size() )
+              != DeckCache::hash( str.data(), str.size(), 1 ) );
+}
+
+BOOST_AUTO_TEST_CASE(CacheHitEqualsTextParse) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser text;
+    Parser cached;
+    cached.setDeckCacheDirectory( test.cache );
+    BOOST_CHECK_EQUAL( test.cache, cached.getDeckCacheDirectory() );
+
+    /*
+     * The prefetch hook is called with no hits and no misses when the deck is
+     * read from the cache.
+     */
+    size_t found = 0;
+    cached.setIncludePrefetchThreads( 1 );
+    cached.setIncludePrefetchHook( [&]( size_t hits, size_t misses ) { found = hits + misses; } );
+
+    const auto expected = text.parseFile( test.datafile, context );
+
+    const auto first = cached.parseFile( test.datafile, context );
+    BOOST_CHECK( found > 0 );
+    BOOST_CHECK_EQUAL( 1U, test.entries() );
+    checkEqual( expected, first );
+
+    const auto second = cached.parseFile( test.datafile, context );
+    BOOST_CHECK_EQUAL( 0U, found );
+    checkEqual( expected, second );
+
+    BOOST_CHECK( expected.getKeyword( "PERMX" ).getSIDoubleData()
+              == second.getKeyword( "PERMX" ).getSIDoubleData() );
+    BOOST_CHECK( second.getKeyword( "TABDIMS" ).getRecord( 0 ).getItem( 2 ).defaultApplied( 0 ) );
+    BOOST_CHECK( !second.getKeyword( "TABDIMS" ).getRecord( 0 ).getItem( 1 ).defaultApplied( 0 ) );
+    BOOST_CHECK( expected.getKeyword( "PVDG" ).getRecord( 0 ).getItem( 0 ).getSIDoubleData()
+              == second.getKeyword( "PVDG" ).getRecord( 0 ).getItem( 0 ).getSIDoubleData() );
+
+    /* another parse context is another entry */
+    cached.parseFile( test.datafile, ParseContext( InputError::IGNORE ) );
+    BOOST_CHECK_EQUAL( 2U, test.entries() );
+}
+
+BOOST_AUTO_TEST_CASE(ChangedIncludeIsParsed) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    parser.setDeckCacheDirectory( test.cache );
+    parser.parseFile( test.datafile, context );
+
+    /* same size, so the change is only seen by the content hash */
+    test.write( "include/poro.inc", "PORO\n 100*0.35 /\n" );
+    const auto changed = parser.parseFile( test.datafile, context );
+    BOOST_CHECK_CLOSE( 0.35, changed.getKeyword( "PORO" ).getRawDoubleData()[ 0 ], 1e-12 );
+
+    /* an include that was missing and now is there */
+    test.write( "include/missing.inc", "NTG\n 100*1 /\n" );
+    const auto created = parser.parseFile( test.datafile, context );
+    BOOST_CHECK( created.hasKeyword( "NTG" ) );
+
+    /* and the same entry is used for the new content */
+    BOOST_CHECK_EQUAL( 1U, test.entries() );
+    const auto reread = parser.parseFile( test.datafile, context );
+    BOOST_CHECK( reread.hasKeyword( "NTG" ) );
+    BOOST_CHECK_CLOSE( 0.35, reread.getKeyword( "PORO" ).getRawDoubleData()[ 0 ], 1e-12 );
+}
+
+BOOST_AUTO_TEST_CASE(ManifestIsOfParsedBytes) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    parser.setDeckCacheDirectory( test.cache );
+    const auto deck = parser.parseFile( test.datafile, context );
+
+    const auto& graph = deck.getIncludeGraph();
+    BOOST_REQUIRE_EQUAL( 3U, graph.size() );
+    BOOST_CHECK( graph[ 0 ].stamp.valid );
+    BOOST_CHECK( !graph[ 2 ].stamp.valid );
+
+    const std::string poro = "PORO\n 100*0.25 /\n";
+    BOOST_CHECK( graph[ 1 ].stamp.valid );
+    BOOST_CHECK_EQUAL( poro.size(), graph[ 1 ].stamp.size );
+    BOOST_CHECK_EQUAL( DeckCache::hash( poro.data(), poro.size() ), graph[ 1 ].stamp.digest );
+
+    /*
+     * An include that is edited after it was parsed, but before the entry is
+     * written, leaves the bytes on disk different from the ones parsed.
+     */
+    auto edited = graph;
+    edited[ 1 ].stamp.digest ^= 1;
+    edited[ 1 ].stamp.mtime -= 10;
+
+    const DeckCache cache( test.cache, parser.getKeywordHash() );
+    cache.store( test.datafile, context, edited, deck );
+
+    Deck stale;
+    BOOST_CHECK( !cache.load( test.datafile, context, stale ) );
+}
+
+BOOST_AUTO_TEST_CASE(CorruptEntryIsParsed) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser text;
+    const auto expected = text.parseFile( test.datafile, context );
+
+    Parser parser;
+    parser.setDeckCacheDirectory( test.cache );
+    parser.parseFile( test.datafile, context );
+    BOOST_REQUIRE_EQUAL( 1U, test.entries() );
+
+    const auto entry = fs::directory_iterator( test.cache )->path();
+    const auto size = fs::file_size( entry );
+
+    fs::resize_file( entry, size / 2 );
+    checkEqual( expected, parser.parseFile( test.datafile, context ) );
+
+    {
+        std::ofstream of( entry.string().c_str(), std::ios::binary );
+        of << std::string( size, 'x' );
+    }
+    checkEqual( expected, parser.parseFile( test.datafile, context ) );
+
+    /* a parse from text rewrote the entry */
+    checkEqual( expected, parser.parseFile( test.datafile, context ) );
+}
+
+BOOST_AUTO_TEST_CASE(KeywordDefinitionsAreInKey) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    parser.setDeckCacheDirectory( test.cache );
+    parser.parseFile( test.datafile, context );
+
+    Parser fewer( false );
+    fewer.setDeckCacheDirectory( test.cache );
+    const auto deck = fewer.parseFile( test.datafile, context );
+
+    BOOST_CHECK_EQUAL( 0U, deck.size() );
+    BOOST_CHECK_EQUAL( 2U, test.entries() );
+}
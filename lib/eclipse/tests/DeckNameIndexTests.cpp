@@ -0,0 +1,134 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE DeckNameIndexTests
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/json/JsonObject.hpp>
+#include <opm/parser/eclipse/Parser/DeckNameIndex.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Parser/ParserKeyword.hpp>
+
+using namespace Opm;
+
+BOOST_AUTO_TEST_CASE(PackUnpack) {
+    uint64_t key;
+    BOOST_CHECK( DeckNameHash::pack( "ZCORN", key ) );
+    BOOST_CHECK_EQUAL( "ZCORN", DeckNameHash::unpack( key ) );
+
+    BOOST_CHECK( DeckNameHash::pack( "ABCDEFGH", key ) );
+    BOOST_CHECK_EQUAL( "ABCDEFGH", DeckNameHash::unpack( key ) );
+
+    BOOST_CHECK( !DeckNameHash::pack( "ABCDEFGHI", key ) );
+    BOOST_CHECK( !DeckNameHash::pack( "", key ) );
+}
+
+BOOST_AUTO_TEST_CASE(BuildFindsAllNames) {
+    std::vector< std::string > names;
+    for( char a = 'A'; a <= 'Z'; ++a ) {
+        for( char b = 'A'; b <= 'Z'; ++b ) {
+            names.push_back( std::string{ a, b, 'X' } );
+            names.push_back( std::string{ 'W', a, b, 'P', 'R' } );
+        }
+    }
+
+    const auto table = DeckNameHash::build( names );
+
+    std::set< size_t > slots;
+    for( const auto& name : names ) {
+        const auto slot = table.find( name );
+        BOOST_REQUIRE( slot != DeckNameHash::npos );
+        BOOST_CHECK_EQUAL( name, DeckNameHash::unpack( table.keys()[ slot ] ) );
+        slots.insert( slot );
+    }
+
+    BOOST_CHECK_EQUAL( names.size(), slots.size() );
+
+    BOOST_CHECK_EQUAL( DeckNameHash::npos, table.find( "AAY" ) );
+    BOOST_CHECK_EQUAL( DeckNameHash::npos, table.find( "AA" ) );
+    BOOST_CHECK_EQUAL( DeckNameHash::npos, table.find( "WAAPRXXXX" ) );
+    BOOST_CHECK_EQUAL( DeckNameHash::npos, table.find( "" ) );
+}
+
+BOOST_AUTO_TEST_CASE(BuildThrowsOnLongName) {
+    BOOST_CHECK_THROW( DeckNameHash::build( { "TOOLONGNAME" } ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE(EmptyHashFindsNothing) {
+    const DeckNameHash table;
+    BOOST_CHECK_EQUAL( DeckNameHash::npos, table.find( "ZCORN" ) );
+}
+
+BOOST_AUTO_TEST_CASE(DefaultDeckNames) {
+    Parser parser;
+    for( const auto& name : { "ZCORN", "COORD", "PORO", "TITLE", "WCONHIST" } ) {
+        BOOST_CHECK( parser.hasKeyword( name ) );
+        BOOST_CHECK( parser.isRecognizedKeyword( name ) );
+        BOOST_CHECK_EQUAL( name, parser.getParserKeywordFromDeckName( name )->getName() );
+    }
+
+    BOOST_CHECK( parser.isRecognizedKeyword( "PVT-M" ) );
+    BOOST_CHECK( !parser.hasKeyword( "ZCORNX" ) );
+    BOOST_CHECK( !parser.isRecognizedKeyword( "ZCORNX" ) );
+}
+
+BOOST_AUTO_TEST_CASE(LiteralPrefixes) {
+    using prefixes = std::vector< std::string >;
+
+    BOOST_CHECK( prefixes( { "WU", "", "WTPR" } )
+              == DeckNamePrefixes::literalPrefixes( "WU.+|(WBHWC|WGFWC)[1-9]|WTPR.+" ) );
+    BOOST_CHECK( prefixes( { "R", "RU" } )
+              == DeckNamePrefixes::literalPrefixes( "R[OGW]?[IP][PRT]_.+|RU.+" ) );
+    BOOST_CHECK( prefixes( { "TNUM" } )
+              == DeckNamePrefixes::literalPrefixes( "TNUM(F|S).{1,3}" ) );
+    BOOST_CHECK( prefixes( { "AN", "FTIP" } )
+              == DeckNamePrefixes::literalPrefixes( "ANQ?|FTIP[1-9][0-9]*.+" ) );
+    BOOST_CHECK( prefixes( { "BTDCY" } )
+              == DeckNamePrefixes::literalPrefixes( "BTDCY" ) );
+}
+
+BOOST_AUTO_TEST_CASE(WildcardKeywords) {
+    Parser parser( false );
+    parser.addParserKeyword( Json::JsonObject( "{\"name\" : \"WPROBE\", \"sections\" : [\"SUMMARY\"], \"size\" : 1,"
+                                               " \"deck_name_regex\" : \"WU.+|WTPR.+\"}" ) );
+    parser.addParserKeyword( Json::JsonObject( "{\"name\" : \"APROBE\", \"sections\" : [\"SUMMARY\"], \"size\" : 1,"
+                                               " \"deck_name_regex\" : \"(A|B)X.+\"}" ) );
+
+    BOOST_CHECK( parser.isRecognizedKeyword( "WUFOO" ) );
+    BOOST_CHECK( parser.isRecognizedKeyword( "WTPRBAR" ) );
+    BOOST_CHECK( !parser.isRecognizedKeyword( "WU" ) );
+    BOOST_CHECK( !parser.isRecognizedKeyword( "WOPR" ) );
+    BOOST_CHECK_EQUAL( "WPROBE", parser.getParserKeywordFromDeckName( "WUFOO" )->getName() );
+
+    BOOST_CHECK( parser.isRecognizedKeyword( "BXY" ) );
+    BOOST_CHECK( !parser.isRecognizedKeyword( "CXY" ) );
+    BOOST_CHECK_EQUAL( "APROBE", parser.getParserKeywordFromDeckName( "AXY" )->getName() );
+
+    /* replacing a wildcard keyword replaces its expression */
+    parser.addParserKeyword( Json::JsonObject( "{\"name\" : \"WPROBE\", \"sections\" : [\"SUMMARY\"], \"size\" : 1,"
+                                               " \"deck_name_regex\" : \"WV.+\"}" ) );
+    BOOST_CHECK( !parser.isRecognizedKeyword( "WUFOO" ) );
+    BOOST_CHECK( parser.isRecognizedKeyword( "WVFOO" ) );
+}
@@ -0,0 +1,149 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE DeckReaderTests
+
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckItem.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/DeckRecord.hpp>
+#include <opm/parser/eclipse/Parser/DeckReader.hpp>
+#include <opm/parser/eclipse/Parser/MessageContainer.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+#include "DeckTestUtils.hpp"
+
+using namespace Opm;
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct CaseDir : test::CaseDir {
+    CaseDir() : test::CaseDir( "deckreader" ) {}
+};
+
+/* read the whole deck, and check it against the one of parseFile */
+void checkEqual( const Parser& parser, const std::string& datafile, const ParseContext& context ) {
+    const auto deck = parser.parseFile( datafile, context );
+    DeckReader reader( parser, datafile, context );
+
+    size_t index = 0;
+    for( const auto* keyword = reader.next(); keyword; keyword = reader.next(), ++index ) {
+        BOOST_REQUIRE( index < deck.size() );
+        const auto& expected = deck.getKeyword( index );
+        BOOST_CHECK( expected.equal( *keyword, true, false ) );
+        BOOST_CHECK_EQUAL( expected.getFileName(), keyword->getFileName() );
+        BOOST_CHECK_EQUAL( expected.getLineNumber(), keyword->getLineNumber() );
+    }
+
+    BOOST_CHECK_EQUAL( deck.size(), index );
+    BOOST_CHECK( !reader.next() );
+
+    const auto& msg1 = deck.getMessageContainer();
+    const auto& msg2 = reader.getMessageContainer();
+    BOOST_REQUIRE_EQUAL( msg1.size(), msg2.size() );
+    for( auto m1 = msg1.begin(), m2 = msg2.begin(); m1 != msg1.end(); ++m1, ++m2 )
+        BOOST_CHECK_EQUAL( m1->message, m2->message );
+
+    BOOST_CHECK( deck.getActiveUnitSystem() == reader.getActiveUnitSystem() );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(ReadEqualsParse) {
+    CaseDir test;
+    test.write( "CASE.DATA", R"(
+RUNSPEC
+FIELD
+DIMENS
+ 10 10 1 /
+TABDIMS
+ 1 2 /
+INCLUDE
+ 'grid.inc' /
+FOO
+ garbage /
+PROPS
+PVDG
+ 1 2 3 /
+ 4 5 6 /
+SCHEDULE
+TSTEP
+ 10 /
+)" );
+    test.write( "grid.inc", "GRID\nPORO\n 100*0.25 /\nPERMX\n 100*100 /\n" );
+
+    Parser parser;
+    checkEqual( parser, test.datafile, ParseContext( InputError::WARN ) );
+
+    /* the values are in the units of FIELD */
+    DeckReader reader( parser, test.datafile, ParseContext( InputError::WARN ) );
+    const DeckKeyword* keyword = nullptr;
+    while( ( keyword = reader.next() ) && keyword->name() != "PVDG" ) {}
+
+    BOOST_REQUIRE( keyword );
+    BOOST_CHECK( reader.getActiveUnitSystem() == UnitSystem::newFIELD() );
+    BOOST_CHECK_CLOSE( 6894.757, keyword->getRecord( 0 ).getItem( 0 ).getSIDouble( 0 ), 1e-4 );
+}
+
+BOOST_AUTO_TEST_CASE(SizedWithoutSizingKeyword) {
+    CaseDir test;
+    test.write( "CASE.DATA", R"(
+RUNSPEC
+PROPS
+PVDG
+ 1 2 3 /
+ 4 5 6 /
+)" );
+
+    Parser parser;
+    checkEqual( parser, test.datafile, ParseContext( InputError::WARN ) );
+}
+
+BOOST_AUTO_TEST_CASE(StopsAtEnd) {
+    CaseDir test;
+    test.write( "CASE.DATA", "RUNSPEC\nINCLUDE\n 'end.inc' /\nGRID\n" );
+    test.write( "end.inc", "DIMENS\n 10 10 1 /\nEND\nOIL\n" );
+
+    Parser parser;
+    checkEqual( parser, test.datafile, ParseContext() );
+
+    DeckReader reader( parser, test.datafile );
+    BOOST_CHECK_EQUAL( "RUNSPEC", reader.next()->name() );
+    BOOST_CHECK_EQUAL( "DIMENS", reader.next()->name() );
+    BOOST_CHECK( !reader.next() );
+    BOOST_CHECK( !reader.next() );
+}
+
+BOOST_AUTO_TEST_CASE(ErrorsAreThrown) {
+    CaseDir test;
+    test.write( "CASE.DATA", "RUNSPEC\nFOO\n" );
+
+    Parser parser;
+    DeckReader reader( parser, test.datafile );
+    BOOST_CHECK_EQUAL( "RUNSPEC", reader.next()->name() );
+    BOOST_CHECK_THROW( reader.next(), std::invalid_argument );
+}
@@ -0,0 +1,123 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef OPM_DECK_TEST_UTILS_HPP
+#define OPM_DECK_TEST_UTILS_HPP
+
+#include <fstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/IncludeGraph.hpp>
+#include <opm/parser/eclipse/Parser/MessageContainer.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+/*
+ * The helpers of the tests that parse decks from files: a directory the
+ * files are written to, and checks that two decks are the same.
+ */
+namespace Opm {
+namespace test {
+
+    /* a directory of its own in the temporary directory, removed with its files */
+    struct CaseDir {
+        explicit CaseDir( const std::string& prefix ) :
+            dir( boost::filesystem::temp_directory_path()
+               / boost::filesystem::unique_path( prefix + "-%%%%-%%%%" ) ),
+            datafile( ( dir / "CASE.DATA" ).string() )
+        {
+            boost::filesystem::create_directories( dir );
+        }
+
+        CaseDir( const CaseDir& ) = delete;
+        CaseDir& operator=( const CaseDir& ) = delete;
+
+        ~CaseDir() {
+            boost::filesystem::remove_all( dir );
+        }
+
+        /* write the file, creating the directories it is in */
+        void write( const std::string& name, const std::string& content ) const {
+            const auto file = dir / name;
+            boost::filesystem::create_directories( file.parent_path() );
+
+            std::ofstream of( file.string().c_str(), std::ios::binary );
+            of << content;
+        }
+
+        std::string path( const std::string& name ) const {
+            return ( dir / name ).string();
+        }
+
+        boost::filesystem::path dir;
+        std::string datafile;
+    };
+
+    /* the keywords, their locations and the messages of the decks are the same */
+    inline void checkEqual( const Deck& expected, const Deck& actual ) {
+        BOOST_CHECK_EQUAL( expected.getDataFile(), actual.getDataFile() );
+        BOOST_CHECK( expected.getActiveUnitSystem() == actual.getActiveUnitSystem() );
+        BOOST_CHECK( expected.getDefaultUnitSystem() == actual.getDefaultUnitSystem() );
+
+        BOOST_REQUIRE_EQUAL( expected.size(), actual.size() );
+        for( size_t i = 0; i < expected.size(); ++i ) {
+            const auto& kw1 = expected.getKeyword( i );
+            const auto& kw2 = actual.getKeyword( i );
+            BOOST_CHECK( kw1.equal( kw2, true, false ) );
+            BOOST_CHECK_EQUAL( kw1.getFileName(), kw2.getFileName() );
+            BOOST_CHECK_EQUAL( kw1.getLineNumber(), kw2.getLineNumber() );
+            BOOST_CHECK_EQUAL( kw1.isDataKeyword(), kw2.isDataKeyword() );
+        }
+
+        for( const auto& kw : expected )
+            BOOST_CHECK_EQUAL( expected.count( kw.name() ), actual.count( kw.name() ) );
+
+        const auto& msg1 = expected.getMessageContainer();
+        const auto& msg2 = actual.getMessageContainer();
+        BOOST_REQUIRE_EQUAL( msg1.size(), msg2.size() );
+        for( auto m1 = msg1.begin(), m2 = msg2.begin(); m1 != msg1.end(); ++m1, ++m2 ) {
+            BOOST_CHECK_EQUAL( m1->mtype, m2->mtype );
+            BOOST_CHECK_EQUAL( m1->message, m2->message );
+            BOOST_CHECK_EQUAL( m1->location.filename, m2->location.filename );
+            BOOST_CHECK_EQUAL( m1->location.lineno, m2->location.lineno );
+        }
+    }
+
+    /* the files of the graphs, and the keywords and messages from them, are the same */
+    inline void checkEqual( const IncludeGraph& expected, const IncludeGraph& actual ) {
+        BOOST_REQUIRE_EQUAL( expected.size(), actual.size() );
+        for( size_t i = 0; i < expected.size(); ++i ) {
+            BOOST_CHECK_EQUAL( expected[ i ].path, actual[ i ].path );
+            BOOST_CHECK_EQUAL( expected[ i ].parent, actual[ i ].parent );
+            BOOST_CHECK_EQUAL( expected[ i ].firstKeyword, actual[ i ].firstKeyword );
+            BOOST_CHECK_EQUAL( expected[ i ].lastKeyword, actual[ i ].lastKeyword );
+            BOOST_CHECK_EQUAL( expected[ i ].firstMessage, actual[ i ].firstMessage );
+            BOOST_CHECK_EQUAL( expected[ i ].lastMessage, actual[ i ].lastMessage );
+        }
+    }
+
+}
+}
+
+#endif
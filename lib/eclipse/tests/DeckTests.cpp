@@ -18,8 +18,10 @@
  */
 
 
+#include <limits>
 #include <stdexcept>
 #include <sstream>
+#include <thread>
 
 #define BOOST_TEST_MODULE DeckTests
 
@@ -28,6 +30,7 @@
 #include <opm/parser/eclipse/Deck/DeckOutput.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/SymbolTable.hpp>
 #include <opm/parser/eclipse/Parser/ParseContext.hpp>
 #include <opm/parser/eclipse/Parser/ParserItem.hpp>
 #include <opm/parser/eclipse/Parser/ParserRecord.hpp>
@@ -451,6 +454,259 @@ BOOST_AUTO_TEST_CASE(PushBackMultipleInt) {
         BOOST_CHECK_EQUAL(10 , item.get< int >(i));
 }
 
+BOOST_AUTO_TEST_CASE(CopyAndMoveItems) {
+    DeckItem item( "HEI", int() );
+    item.push_backDefault( 1 );
+    item.push_backDefault( 2 );
+    item.push_back( 3 );
+    item.push_backDefault( 4 );
+
+    BOOST_CHECK( item.defaultApplied( 0 ) );
+    BOOST_CHECK( item.defaultApplied( 1 ) );
+    BOOST_CHECK( !item.defaultApplied( 2 ) );
+    BOOST_CHECK( item.defaultApplied( 3 ) );
+
+    const DeckItem copy( item );
+    BOOST_CHECK( copy.equal( item, true, false ) );
+    BOOST_CHECK_EQUAL( &copy.name(), &item.name() );
+
+    DeckItem other( "HEI", std::string() );
+    other.push_back( "WELL" );
+    BOOST_CHECK( !other.equal( item, false, false ) );
+
+    other = std::move( item );
+    BOOST_CHECK( other.equal( copy, true, false ) );
+    BOOST_CHECK_EQUAL( 4, other.get< int >( 3 ) );
+    BOOST_CHECK_THROW( other.get< std::string >( 0 ), std::invalid_argument );
+
+    other = DeckItem( "HEI", std::string() );
+    other.push_back( "WELL" );
+    BOOST_CHECK_EQUAL( "WELL", other.get< std::string >( 0 ) );
+
+    DeckItem explicitValues( "HEI", int() );
+    for( int i = 1; i <= 4; ++i ) explicitValues.push_back( i );
+    BOOST_CHECK( explicitValues.equal( copy, false, false ) );
+    BOOST_CHECK( !explicitValues.equal( copy, true, false ) );
+}
+
+BOOST_AUTO_TEST_CASE(ItemsShareDimensions) {
+    DeckItem item1( "HEI", double() );
+    DeckItem item2( "HEI", double() );
+    item1.push_back( 1.0 );
+    item2.push_back( 2.0 );
+
+    const Dimension dim( "Length", 100 );
+    item1.push_backDimension( dim, dim );
+    item2.push_backDimension( Dimension( "Length", 100 ), dim );
+    item2.push_backDimension( Dimension( "Length", 10 ), dim );
+
+    BOOST_CHECK_EQUAL( 100, item1.getSIDouble( 0 ) );
+    BOOST_CHECK_EQUAL( 200, item2.getSIDouble( 0 ) );
+}
+
+BOOST_AUTO_TEST_CASE(ValueRuns) {
+    DeckItem item( "HEI", int() );
+    item.push_back( 1 );
+    item.push_back( 2, 3 );
+    item.push_backDefault( 7, 2 );
+    item.push_back( 3 );
+
+    BOOST_CHECK_EQUAL( 7U, item.size() );
+    BOOST_CHECK_EQUAL( 4U, item.runCount() );
+    BOOST_CHECK_EQUAL( 1U, item.runEnd( 0 ) );
+    BOOST_CHECK_EQUAL( 4U, item.runEnd( 1 ) );
+    BOOST_CHECK_EQUAL( 6U, item.runEnd( 2 ) );
+    BOOST_CHECK_EQUAL( 7U, item.runEnd( 3 ) );
+    BOOST_CHECK_THROW( item.runEnd( 4 ), std::out_of_range );
+    BOOST_CHECK_EQUAL( 7, item.runValue< int >( 2 ) );
+
+    BOOST_CHECK_EQUAL( 2, item.get< int >( 3 ) );
+    BOOST_CHECK_EQUAL( 7, item.get< int >( 4 ) );
+    BOOST_CHECK_EQUAL( 3, item.get< int >( 6 ) );
+    BOOST_CHECK_THROW( item.get< int >( 7 ), std::out_of_range );
+    BOOST_CHECK( !item.defaultApplied( 3 ) );
+    BOOST_CHECK( item.defaultApplied( 4 ) );
+    BOOST_CHECK( item.defaultApplied( 5 ) );
+    BOOST_CHECK( !item.defaultApplied( 6 ) );
+
+    DeckItem expanded( "HEI", int() );
+    for( int value : { 1, 2, 2, 2 } ) expanded.push_back( value );
+    expanded.push_backDefault( 7 );
+    expanded.push_backDefault( 7 );
+    expanded.push_back( 3 );
+    BOOST_CHECK( item.equal( expanded, true, false ) );
+
+    /* getData expands the runs into a copy and leaves the item alone */
+    const std::vector< int > data = { 1, 2, 2, 2, 7, 7, 3 };
+    BOOST_CHECK( data == item.getData< int >() );
+    BOOST_CHECK_EQUAL( 4U, item.runCount() );
+    BOOST_CHECK_EQUAL( 4U, item.runEnd( 1 ) );
+    BOOST_CHECK( item.defaultApplied( 5 ) );
+    BOOST_CHECK( item.equal( expanded, true, false ) );
+}
+
+BOOST_AUTO_TEST_CASE(GetDataLeavesRunsInPlace) {
+    DeckItem item( "HEI", double() );
+    item.push_back( 1.0 );
+    item.push_back( 2.0, 3 );
+    item.push_backDimension( Dimension( "Length", 100 ), Dimension( "Length", 100 ) );
+
+    const auto& second = item.get< double >( 1 );
+    const std::vector< double > data = { 1.0, 2.0, 2.0, 2.0 };
+    const std::vector< double > si = { 100.0, 200.0, 200.0, 200.0 };
+
+    std::vector< std::thread > readers;
+    std::vector< int > same( 4, 0 );
+    for( size_t i = 0; i < same.size(); ++i )
+        readers.emplace_back( [&item, &data, &si, &same, i] {
+            same[ i ] = data == item.getData< double >()
+                     && si == item.getSIDoubleData();
+        } );
+    for( auto& reader : readers ) reader.join();
+
+    for( int equal : same ) BOOST_CHECK( equal );
+    BOOST_CHECK_EQUAL( &second, &item.get< double >( 3 ) );
+    BOOST_CHECK_EQUAL( 2U, item.runCount() );
+    BOOST_CHECK_EQUAL( &item.getData< double >(), &item.getData< double >() );
+
+    /* a push drops the expanded copy */
+    item.push_back( 3.0 );
+    BOOST_CHECK_EQUAL( 5U, item.getData< double >().size() );
+    BOOST_CHECK_EQUAL( 300.0, item.getSIDoubleData().back() );
+}
+
+BOOST_AUTO_TEST_CASE(StringValuesAreShared) {
+    const auto symbols = std::make_shared< SymbolTable >();
+    DeckItem first( "WELL", std::string(), 8, symbols );
+    first.push_back( std::string( "PROD" ) );
+    first.push_back( std::string( "INJ" ), 3 );
+
+    DeckItem second( "WELL", std::string(), 8, symbols );
+    second.push_back( std::string( "PROD" ) );
+
+    BOOST_CHECK_EQUAL( "PROD", first.get< std::string >( 0 ) );
+    BOOST_CHECK_EQUAL( "INJ", first.runValue< std::string >( 1 ) );
+    BOOST_CHECK_EQUAL( &first.get< std::string >( 0 ), &second.get< std::string >( 0 ) );
+    BOOST_CHECK_EQUAL( &first.get< std::string >( 1 ), &first.get< std::string >( 3 ) );
+
+    const std::vector< std::string > data = { "PROD", "INJ", "INJ", "INJ" };
+    BOOST_CHECK( data == first.getData< std::string >() );
+
+    /* the strings are spelled out again after a push */
+    first.push_back( std::string( "OBS" ) );
+    BOOST_CHECK_EQUAL( 5U, first.getData< std::string >().size() );
+    BOOST_CHECK_EQUAL( "OBS", first.getData< std::string >().back() );
+
+    DeckItem copy( first );
+    BOOST_CHECK( copy.equal( first, true, false ) );
+    BOOST_CHECK( !copy.equal( second, true, false ) );
+    BOOST_CHECK_EQUAL( 3U, symbols->size() );
+
+    /* an item with a table of its own compares by the values */
+    DeckItem own( "WELL", std::string() );
+    own.push_back( std::string( "PROD" ) );
+    BOOST_CHECK( own.equal( second, true, false ) );
+    BOOST_CHECK( &own.get< std::string >( 0 ) != &second.get< std::string >( 0 ) );
+}
+
+BOOST_AUTO_TEST_CASE(StringValuesLiveWithTheDeck) {
+    ParserItem itemString( "WELL", ParserItem::item_size::ALL, std::string( "" ) );
+    ParserRecord parserRecord;
+    parserRecord.addItem( itemString );
+    ParseContext parseContext;
+    MessageContainer msgContainer;
+
+    std::weak_ptr< SymbolTable > table;
+    DeckItem kept;
+    {
+        Deck deck;
+        table = deck.getSymbols();
+
+        RawRecord rawRecord( "PROD INJ 2*PROD" );
+        const auto record = parserRecord.parse( parseContext, msgContainer, rawRecord,
+                                                0, deck.getSymbols() );
+        BOOST_CHECK_EQUAL( 2U, deck.getSymbols()->size() );
+        kept = record.getItem( 0 );
+    }
+
+    /* the item taken out of the deck keeps the table alive */
+    BOOST_CHECK( !table.expired() );
+    BOOST_CHECK_EQUAL( "PROD", kept.get< std::string >( 3 ) );
+
+    kept = DeckItem();
+    BOOST_CHECK( table.expired() );
+}
+
+BOOST_AUTO_TEST_CASE(SourceNamesLiveWithTheDeck) {
+    std::weak_ptr< SourceNames > table;
+    DeckKeyword kept( "KW" );
+    {
+        Deck deck;
+        table = deck.getSourceNames();
+
+        const auto file = deck.getSourceNames()->intern( "/path/to/FILE" );
+        DeckKeyword keyword( "KW" );
+        keyword.setLocation( deck.getSourceNames(), file, 10 );
+        deck.addKeyword( keyword );
+
+        const Deck copy( deck );
+        BOOST_CHECK_EQUAL( deck.getSourceNames(), copy.getSourceNames() );
+        BOOST_CHECK_EQUAL( "/path/to/FILE", copy.getKeyword( 0 ).getFileName() );
+        kept = deck.getKeyword( 0 );
+    }
+
+    /* the keyword taken out of the deck keeps the table alive */
+    BOOST_CHECK( !table.expired() );
+    BOOST_CHECK_EQUAL( "/path/to/FILE", kept.getFileName() );
+
+    kept = DeckKeyword( "KW" );
+    BOOST_CHECK( table.expired() );
+    BOOST_CHECK_EQUAL( "", kept.getFileName() );
+}
+
+BOOST_AUTO_TEST_CASE(ConvertItemToSI) {
+    DeckItem single( "HEI", double() );
+    single.push_back( 1.0 );
+    single.push_back( 2.0, 1000 );
+    single.push_backDimension( Dimension( "Temperature", 1.0, 273.15 ), Dimension( "Temperature", 1.0 ) );
+
+    single.convertToSI();
+    BOOST_CHECK( single.isSIConverted() );
+    BOOST_CHECK_EQUAL( 2U, single.runCount() );
+    BOOST_CHECK_EQUAL( 274.15, single.get< double >( 0 ) );
+    BOOST_CHECK_EQUAL( 275.15, single.getSIDouble( 1000 ) );
+    BOOST_CHECK_CLOSE( 2.0, single.getRawDouble( 1000 ), 1e-10 );
+
+    /* converting twice does not scale twice */
+    single.convertToSI();
+    BOOST_CHECK_EQUAL( 274.15, single.get< double >( 0 ) );
+
+    DeckItem periodic( "HEI", double() );
+    periodic.push_back( 1.0, 7 );
+    periodic.push_backDimension( Dimension( "Length", 2 ), Dimension( "Length", 2 ) );
+    periodic.push_backDimension( Dimension( "Length", 4 ), Dimension( "Length", 4 ) );
+    periodic.push_backDimension( Dimension( "Length", 8 ), Dimension( "Length", 8 ) );
+
+    periodic.convertToSI();
+    const std::vector< double > expected = { 2, 4, 8, 2, 4, 8, 2 };
+    BOOST_CHECK( expected == periodic.getSIDoubleData() );
+    BOOST_CHECK( expected == periodic.getData< double >() );
+    BOOST_CHECK_EQUAL( 1.0, periodic.getRawDouble( 5 ) );
+
+    std::stringstream written;
+    written << periodic;
+    BOOST_CHECK_EQUAL( "1 1 1 1 1 1 1", written.str() );
+
+    DeckItem contextDependent( "HEI", double() );
+    contextDependent.push_back( 1.0 );
+    const Dimension unknown( "Unknown", std::numeric_limits< double >::quiet_NaN() );
+    contextDependent.push_backDimension( unknown, unknown );
+
+    contextDependent.convertToSI();
+    BOOST_CHECK( !contextDependent.isSIConverted() );
+    BOOST_CHECK_EQUAL( 1.0, contextDependent.get< double >( 0 ) );
+}
+
 BOOST_AUTO_TEST_CASE(size_defaultConstructor_sizezero) {
     DeckRecord deckRecord;
     BOOST_CHECK_EQUAL(0U, deckRecord.size());
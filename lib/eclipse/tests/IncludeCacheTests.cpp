@@ -0,0 +1,290 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE IncludeCacheTests
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Parser/DeckCache.hpp>
+#include <opm/parser/eclipse/Parser/IncludeCache.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+
+#include "DeckTestUtils.hpp"
+
+using namespace Opm;
+namespace fs = boost::filesystem;
+
+namespace {
+
+/*
+ * An ensemble of realisations which share their grid and tables, and only
+ * differ in their porosity.
+ */
+struct Ensemble : test::CaseDir {
+    explicit Ensemble( size_t size ) :
+        test::CaseDir( "includecache" )
+    {
+        write( "shared/grid.inc", R"(
+DIMENS
+ 10 10 1 /
+FOO
+ garbage /
+)" );
+        write( "shared/tables.inc", R"(
+PVDG
+ 1 2 3 /
+ 4 5 6 /
+)" );
+        write( "shared/nested.inc", "INCLUDE\n '../shared/permx.inc' /\n" );
+        write( "shared/permx.inc", "PERMX\n 50*100 50*200 /\n" );
+
+        for( size_t i = 0; i < size; ++i )
+            this->add( "R" + std::to_string( i ), "2", std::to_string( 0.1 + 0.01 * i ) );
+    }
+
+    void add( const std::string& name, const std::string& ntpvt, const std::string& poro ) {
+        write( name + "/poro.inc", "PORO\n 100*" + poro + " /\n" );
+        write( name + "/CASE.DATA", R"(
+RUNSPEC
+TABDIMS
+ 1 )" + ntpvt + R"( /
+INCLUDE
+ '../shared/grid.inc' /
+GRID
+INCLUDE
+ '../shared/nested.inc' /
+INCLUDE
+ 'poro.inc' /
+PROPS
+INCLUDE
+ '../shared/tables.inc' /
+)" );
+        this->datafiles.push_back( ( dir / name / "CASE.DATA" ).string() );
+    }
+
+    std::string path( const std::string& name ) const {
+        return fs::canonical( dir / name ).string();
+    }
+
+    std::vector< std::string > datafiles;
+};
+
+using test::checkEqual;
+
+bool decoded( IncludeCache& cache, const std::string& path ) {
+    const auto file = cache.find( path );
+    return file && !file->keywords.empty();
+}
+
+std::shared_ptr< const IncludeCache::File > insert( IncludeCache& cache,
+                                                    const Ensemble& ensemble,
+                                                    const std::string& name,
+                                                    const std::string& content ) {
+    ensemble.write( name, content );
+    return cache.insert( ensemble.path( name ),
+                         content.size(),
+                         0,
+                         DeckCache::hash( content.data(), content.size() ),
+                         std::string( content ) );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(ReuseEqualsTextParse) {
+    Ensemble ensemble( 3 );
+    const ParseContext context( InputError::WARN );
+    const auto cache = std::make_shared< IncludeCache >();
+
+    Parser text;
+    Parser cached;
+    cached.setIncludeCache( cache );
+    BOOST_CHECK( cache == cached.getIncludeCache() );
+
+    for( const auto& datafile : ensemble.datafiles ) {
+        const auto expected = text.parseFile( datafile, context );
+        checkEqual( expected, cached.parseFile( datafile, context ) );
+    }
+
+    /* the data files, their porosities and the shared files */
+    BOOST_CHECK_EQUAL( 3U + 3U + 4U, cache->size() );
+
+    BOOST_CHECK( decoded( *cache, ensemble.path( "shared/grid.inc" ) ) );
+    BOOST_CHECK( decoded( *cache, ensemble.path( "shared/tables.inc" ) ) );
+    BOOST_CHECK( decoded( *cache, ensemble.path( "shared/permx.inc" ) ) );
+    BOOST_CHECK( decoded( *cache, ensemble.path( "R0/poro.inc" ) ) );
+
+    /* a file with an INCLUDE is read from the cache, but parsed every time */
+    BOOST_CHECK( !decoded( *cache, ensemble.path( "shared/nested.inc" ) ) );
+
+    /* and the cached keywords are the ones of the parse context */
+    const ParseContext ignore( InputError::IGNORE );
+    const auto expected = text.parseFile( ensemble.datafiles.front(), ignore );
+    checkEqual( expected, cached.parseFile( ensemble.datafiles.front(), ignore ) );
+
+    cache->clear();
+    BOOST_CHECK_EQUAL( 0U, cache->size() );
+}
+
+BOOST_AUTO_TEST_CASE(ChangedIncludeIsParsed) {
+    Ensemble ensemble( 1 );
+    const ParseContext context( InputError::WARN );
+    const auto& datafile = ensemble.datafiles.front();
+
+    Parser parser;
+    parser.setIncludeCache( std::make_shared< IncludeCache >() );
+    parser.parseFile( datafile, context );
+
+    /* same size, so the change is only seen by the content hash */
+    ensemble.write( "R0/poro.inc", "PORO\n 100*0.35 /\n" );
+    const auto changed = parser.parseFile( datafile, context );
+    BOOST_CHECK_CLOSE( 0.35, changed.getKeyword( "PORO" ).getRawDoubleData()[ 0 ], 1e-12 );
+
+    ensemble.write( "shared/permx.inc", "PERMX\n 100*300 /\n" );
+    const auto nested = parser.parseFile( datafile, context );
+    BOOST_CHECK_EQUAL( 300, nested.getKeyword( "PERMX" ).getRawDoubleData()[ 0 ] );
+
+    fs::remove( ensemble.dir / "R0/poro.inc" );
+    const auto removed = parser.parseFile( datafile, context );
+    BOOST_CHECK( !removed.hasKeyword( "PORO" ) );
+}
+
+BOOST_AUTO_TEST_CASE(ReusedOnlyWithSameSizes) {
+    Ensemble ensemble( 0 );
+    ensemble.add( "TWO", "2", "0.1" );
+    ensemble.add( "ONE", "1", "0.1" );
+    const ParseContext context( InputError::WARN );
+
+    const auto cache = std::make_shared< IncludeCache >();
+    Parser parser;
+    parser.setIncludeCache( cache );
+
+    /* the number of PVDG tables is given by TABDIMS in the data file */
+    const auto two = parser.parseFile( ensemble.datafiles[ 0 ], context );
+    const auto one = parser.parseFile( ensemble.datafiles[ 1 ], context );
+    BOOST_CHECK_EQUAL( 2U, two.getKeyword( "PVDG" ).size() );
+    BOOST_CHECK_EQUAL( 1U, one.getKeyword( "PVDG" ).size() );
+
+    Parser text;
+    checkEqual( text.parseFile( ensemble.datafiles[ 1 ], context ), one );
+    checkEqual( text.parseFile( ensemble.datafiles[ 0 ], context ),
+                parser.parseFile( ensemble.datafiles[ 0 ], context ) );
+}
+
+BOOST_AUTO_TEST_CASE(InputDroppedOnceDecoded) {
+    Ensemble ensemble( 1 );
+    const ParseContext context( InputError::WARN );
+
+    const auto cache = std::make_shared< IncludeCache >();
+    Parser parser;
+    parser.setIncludeCache( cache );
+    parser.parseFile( ensemble.datafiles.front(), context );
+
+    const auto grid = cache->find( ensemble.path( "shared/grid.inc" ) );
+    BOOST_REQUIRE( grid );
+    BOOST_CHECK( !grid->keywords.empty() );
+    BOOST_CHECK( !grid->content );
+
+    const auto nested = cache->find( ensemble.path( "shared/nested.inc" ) );
+    BOOST_REQUIRE( nested );
+    BOOST_CHECK( nested->content );
+
+    /* another parse context cannot reuse the keywords, and reads the input again */
+    const ParseContext ignore( InputError::IGNORE );
+    Parser text;
+    checkEqual( text.parseFile( ensemble.datafiles.front(), ignore ),
+                parser.parseFile( ensemble.datafiles.front(), ignore ) );
+
+    const auto both = cache->find( ensemble.path( "shared/grid.inc" ) );
+    BOOST_REQUIRE( both );
+    BOOST_CHECK_EQUAL( 2U, both->keywords.size() );
+    BOOST_CHECK( !both->content );
+}
+
+BOOST_AUTO_TEST_CASE(BudgetEvictsLeastRecentlyUsed) {
+    Ensemble ensemble( 0 );
+    IncludeCache cache( 10 );
+    BOOST_CHECK_EQUAL( 10U, cache.budget() );
+
+    insert( cache, ensemble, "a.inc", "1234" );
+    insert( cache, ensemble, "b.inc", "5678" );
+    BOOST_CHECK_EQUAL( 2U, cache.size() );
+    BOOST_CHECK_EQUAL( 8U, cache.bytes() );
+
+    /* a is used again, so b is the one evicted */
+    BOOST_CHECK( cache.find( ensemble.path( "a.inc" ) ) );
+    insert( cache, ensemble, "c.inc", "abcd" );
+    BOOST_CHECK_EQUAL( 2U, cache.size() );
+    BOOST_CHECK_EQUAL( 8U, cache.bytes() );
+    BOOST_CHECK( !cache.find( ensemble.path( "b.inc" ) ) );
+    BOOST_CHECK( cache.find( ensemble.path( "a.inc" ) ) );
+    BOOST_CHECK( cache.find( ensemble.path( "c.inc" ) ) );
+
+    cache.setBudget( 4 );
+    BOOST_CHECK_EQUAL( 1U, cache.size() );
+    BOOST_CHECK( cache.find( ensemble.path( "c.inc" ) ) );
+
+    /* a file bigger than the budget is returned, but not kept */
+    const auto big = insert( cache, ensemble, "d.inc", "0123456789" );
+    BOOST_REQUIRE( big );
+    BOOST_CHECK_EQUAL( "0123456789", *big->content );
+    BOOST_CHECK_EQUAL( 0U, cache.size() );
+    BOOST_CHECK_EQUAL( 0U, cache.bytes() );
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentParses) {
+    Ensemble ensemble( 8 );
+    const ParseContext context( InputError::WARN );
+
+    Parser text;
+    std::vector< size_t > expected;
+    for( const auto& datafile : ensemble.datafiles )
+        expected.push_back( text.parseFile( datafile, context ).size() );
+
+    Parser parser;
+    parser.setIncludeCache( std::make_shared< IncludeCache >() );
+
+    std::vector< size_t > sizes( ensemble.datafiles.size() );
+    std::vector< double > poro( ensemble.datafiles.size() );
+    std::vector< std::thread > threads;
+    for( size_t i = 0; i < ensemble.datafiles.size(); ++i ) {
+        threads.emplace_back( [&, i] {
+            for( int repeat = 0; repeat < 3; ++repeat ) {
+                const auto deck = parser.parseFile( ensemble.datafiles[ i ], context );
+                sizes[ i ] = deck.size();
+                poro[ i ] = deck.getKeyword( "PORO" ).getRawDoubleData()[ 0 ];
+            }
+        } );
+    }
+
+    for( auto& thread : threads )
+        thread.join();
+
+    for( size_t i = 0; i < ensemble.datafiles.size(); ++i ) {
+        BOOST_CHECK_EQUAL( expected[ i ], sizes[ i ] );
+        BOOST_CHECK_CLOSE( 0.1 + 0.01 * i, poro[ i ], 1e-12 );
+    }
+}
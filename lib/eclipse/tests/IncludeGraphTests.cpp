@@ -0,0 +1,214 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE IncludeGraphTests
+
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/IncludeGraph.hpp>
+#include <opm/parser/eclipse/Deck/Section.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+
+#include "DeckTestUtils.hpp"
+
+using namespace Opm;
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct CaseDir : test::CaseDir {
+    CaseDir() :
+        test::CaseDir( "includegraph" )
+    {
+        write( "CASE.DATA", R"(
+RUNSPEC
+DIMENS
+ 10 10 1 /
+INCLUDE
+ 'include/tabdims.inc' /
+GRID
+INCLUDE
+ 'include/grid.inc' /
+INCLUDE
+ 'include/missing.inc' /
+PROPS
+INCLUDE
+ 'include/tables.inc' /
+SCHEDULE
+INCLUDE
+ 'include/schedule.inc' /
+)" );
+        write( "include/tabdims.inc", "TABDIMS\n 1 1 /\n" );
+        write( "include/grid.inc", "INCLUDE\n 'include/poro.inc' /\nPERMX\n 100*100 /\n" );
+        write( "include/poro.inc", "PORO\n 100*0.25 /\n" );
+        write( "include/tables.inc", "PVDG\n 1 2 3 /\n 4 5 6 /\n" );
+        write( "include/schedule.inc", "TSTEP\n 10 /\n" );
+    }
+};
+
+/* the decks, and the files they were parsed from, are the same */
+void checkEqual( const Deck& expected, const Deck& actual ) {
+    test::checkEqual( expected, actual );
+    test::checkEqual( expected.getIncludeGraph(), actual.getIncludeGraph() );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(GraphHasEveryFile) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    const auto deck = parser.parseFile( test.datafile, context );
+    const auto& graph = deck.getIncludeGraph();
+
+    BOOST_REQUIRE_EQUAL( 7U, graph.size() );
+    BOOST_CHECK( !graph.ended() );
+
+    BOOST_CHECK_EQUAL( fs::canonical( test.datafile ).string(), graph[ 0 ].path );
+    BOOST_CHECK_EQUAL( IncludeGraph::npos, graph[ 0 ].parent );
+    BOOST_CHECK_EQUAL( 0U, graph[ 0 ].firstKeyword );
+    BOOST_CHECK_EQUAL( deck.size(), graph[ 0 ].lastKeyword );
+    BOOST_CHECK_EQUAL( deck.getMessageContainer().size(), graph[ 0 ].lastMessage );
+
+    /* grid.inc includes poro.inc */
+    BOOST_CHECK_EQUAL( fs::canonical( test.path( "include/poro.inc" ) ).string(), graph[ 3 ].path );
+    BOOST_CHECK_EQUAL( 2U, graph[ 3 ].parent );
+    BOOST_CHECK( graph.includes( 0, 3 ) );
+    BOOST_CHECK( graph.includes( 2, 3 ) );
+    BOOST_CHECK( !graph.includes( 1, 3 ) );
+    BOOST_CHECK_EQUAL( 4U, graph.last( 2 ) );
+    BOOST_CHECK_EQUAL( 2U, graph[ 2 ].lastKeyword - graph[ 2 ].firstKeyword );
+    BOOST_CHECK_EQUAL( "PORO", deck.getKeyword( graph[ 3 ].firstKeyword ).name() );
+
+    /* the missing file is there, with the message about it */
+    BOOST_CHECK_EQUAL( test.path( "include/missing.inc" ), graph[ 4 ].path );
+    BOOST_CHECK_EQUAL( graph[ 4 ].firstKeyword, graph[ 4 ].lastKeyword );
+    BOOST_CHECK_EQUAL( 1U, graph[ 4 ].lastMessage - graph[ 4 ].firstMessage );
+
+    /* PVDG is sized by TABDIMS */
+    BOOST_CHECK_EQUAL( 1U, graph[ 5 ].sizedBy.count( "TABDIMS" ) );
+    BOOST_CHECK_EQUAL( 0U, graph[ 6 ].sizedBy.size() );
+}
+
+/* the files begin and end among the keywords still queued for decoding */
+BOOST_AUTO_TEST_CASE(RangesWithParallelDecode) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser serial;
+    Parser parallel;
+    parallel.setParseThreads( 4 );
+
+    checkEqual( serial.parseFile( test.datafile, context ),
+                parallel.parseFile( test.datafile, context ) );
+}
+
+BOOST_AUTO_TEST_CASE(ChangedFileIsParsedAgain) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    auto deck = parser.parseFile( test.datafile, context );
+
+    test.write( "include/schedule.inc", "TSTEP\n 10 20 /\nTSTEP\n 30 /\n" );
+    BOOST_CHECK_EQUAL( 1U, parser.updateDeck( deck, { test.path( "include/schedule.inc" ) }, context ) );
+    checkEqual( parser.parseFile( test.datafile, context ), deck );
+    BOOST_CHECK_EQUAL( 2U, deck.count( "TSTEP" ) );
+
+    /* a nested file, which adds a keyword to the sections of the deck */
+    test.write( "include/poro.inc", "PORO\n 100*0.25 /\nNTG\n 100*1 /\n" );
+    BOOST_CHECK_EQUAL( 1U, parser.updateDeck( deck, { test.path( "include/poro.inc" ) }, context ) );
+    checkEqual( parser.parseFile( test.datafile, context ), deck );
+    BOOST_CHECK( GRIDSection( deck ).hasKeyword( "NTG" ) );
+    BOOST_CHECK( !PROPSSection( deck ).hasKeyword( "NTG" ) );
+
+    /* the including file is parsed with the files it includes */
+    test.write( "include/grid.inc", "PERMX\n 100*100 /\nINCLUDE\n 'include/poro.inc' /\n" );
+    BOOST_CHECK_EQUAL( 2U, parser.updateDeck( deck, { test.path( "include/grid.inc" ) }, context ) );
+    checkEqual( parser.parseFile( test.datafile, context ), deck );
+
+    /* unchanged */
+    BOOST_CHECK_EQUAL( 0U, parser.updateDeck( deck, {}, context ) );
+}
+
+BOOST_AUTO_TEST_CASE(SizedKeywordsAreParsedAgain) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    auto deck = parser.parseFile( test.datafile, context );
+    BOOST_CHECK_EQUAL( 1U, deck.getKeyword( "PVDG" ).size() );
+
+    /* two tables, so the second table in tables.inc is not random text anymore */
+    test.write( "include/tabdims.inc", "TABDIMS\n 1 2 /\n" );
+    BOOST_CHECK_EQUAL( 2U, parser.updateDeck( deck, { test.path( "include/tabdims.inc" ) }, context ) );
+    BOOST_CHECK_EQUAL( 2U, deck.getKeyword( "PVDG" ).size() );
+    checkEqual( parser.parseFile( test.datafile, context ), deck );
+}
+
+BOOST_AUTO_TEST_CASE(CreatedFileIsParsed) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    auto deck = parser.parseFile( test.datafile, context );
+    const auto messages = deck.getMessageContainer().size();
+
+    test.write( "include/missing.inc", "MULTX\n 100*1 /\n" );
+    BOOST_CHECK_EQUAL( 1U, parser.updateDeck( deck, { test.path( "include/missing.inc" ) }, context ) );
+    BOOST_CHECK( deck.hasKeyword( "MULTX" ) );
+    BOOST_CHECK_EQUAL( messages - 1, deck.getMessageContainer().size() );
+    checkEqual( parser.parseFile( test.datafile, context ), deck );
+}
+
+BOOST_AUTO_TEST_CASE(WholeDeckIsParsedAgain) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    auto deck = parser.parseFile( test.datafile, context );
+
+    /* the data file */
+    test.write( "CASE.DATA", "RUNSPEC\nINCLUDE\n 'include/tabdims.inc' /\n" );
+    BOOST_CHECK_EQUAL( 2U, parser.updateDeck( deck, { test.datafile }, context ) );
+    checkEqual( parser.parseFile( test.datafile, context ), deck );
+
+    /* the unit system */
+    test.write( "include/tabdims.inc", "FIELD\nTABDIMS\n 1 1 /\n" );
+    BOOST_CHECK_EQUAL( 2U, parser.updateDeck( deck, { test.path( "include/tabdims.inc" ) }, context ) );
+    BOOST_CHECK( deck.getActiveUnitSystem() == UnitSystem::newFIELD() );
+    checkEqual( parser.parseFile( test.datafile, context ), deck );
+
+    /* a deck parsed from a string only has its included files parsed again */
+    auto string = parser.parseString( "RUNSPEC\nINCLUDE\n '" + test.path( "include/tabdims.inc" ) + "' /\n", context );
+    test.write( "include/tabdims.inc", "FIELD\nTABDIMS\n 1 2 /\n" );
+    BOOST_CHECK_EQUAL( 1U, parser.updateDeck( string, { test.path( "include/tabdims.inc" ) }, context ) );
+    BOOST_CHECK_EQUAL( 2, string.getKeyword( "TABDIMS" ).getRecord( 0 ).getItem( "NTPVT" ).get< int >( 0 ) );
+
+    test.write( "include/tabdims.inc", "TABDIMS\n 1 2 /\n" );
+    BOOST_CHECK_THROW( parser.updateDeck( string, { test.path( "include/tabdims.inc" ) }, context ),
+                       std::invalid_argument );
+}
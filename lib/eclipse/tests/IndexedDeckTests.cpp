@@ -0,0 +1,182 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE IndexedDeckTests
+
+#include <ctime>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/Section.hpp>
+#include <opm/parser/eclipse/Parser/IndexedDeck.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+#include "DeckTestUtils.hpp"
+
+using namespace Opm;
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct CaseDir : test::CaseDir {
+    CaseDir() :
+        test::CaseDir( "indexeddeck" )
+    {
+        write( "CASE.DATA", R"(
+RUNSPEC
+FIELD
+DIMENS
+ 10 10 1 /
+TABDIMS
+ 1 2 /
+GRID
+INCLUDE
+ 'grid.inc' /
+PROPS
+PVDG
+ 1 2 3 /
+ 4 5 6 /
+SCHEDULE
+TSTEP
+ 10 /
+TSTEP
+ 20 /
+TSTEP
+ 30 40 /
+)" );
+        write( "grid.inc", "PORO\n 100*0.25 /\nPERMX\n 100*100 /\n" );
+    }
+};
+
+void checkEqual( const IndexedDeck& indexed, const Deck& expected ) {
+    BOOST_REQUIRE_EQUAL( expected.size(), indexed.size() );
+
+    for( size_t i = 0; i < expected.size(); ++i ) {
+        const auto& keyword = indexed.getKeyword( i );
+        BOOST_CHECK( !keyword.isPlaceholder() );
+        BOOST_CHECK( expected.getKeyword( i ).equal( keyword, true, false ) );
+        BOOST_CHECK_EQUAL( expected.getKeyword( i ).getFileName(), keyword.getFileName() );
+        BOOST_CHECK_EQUAL( expected.getKeyword( i ).getLineNumber(), keyword.getLineNumber() );
+    }
+
+    BOOST_CHECK( expected.getActiveUnitSystem() == indexed.getActiveUnitSystem() );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(DecodedOnDemand) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    const auto expected = parser.parseFile( test.datafile, context );
+    const IndexedDeck indexed( parser, test.datafile, context );
+
+    BOOST_CHECK( fs::exists( IndexedDeck::indexPath( test.datafile ) ) );
+    BOOST_CHECK( indexed.getIndex().getKeyword( "PORO" ).isPlaceholder() );
+    BOOST_CHECK( indexed.getIndex().getKeyword( "PVDG" ).isPlaceholder() );
+    BOOST_CHECK( !indexed.getIndex().getKeyword( "TABDIMS" ).isPlaceholder() );
+
+    const auto& tstep = indexed.getKeyword( "SCHEDULE", "TSTEP", 2 );
+    BOOST_CHECK( expected.getKeyword( "TSTEP", 2 ).equal( tstep, true, false ) );
+    BOOST_CHECK_EQUAL( 3U, indexed.count( "TSTEP" ) );
+    BOOST_CHECK_EQUAL( 2U, indexed.getKeyword( "PVDG" ).size() );
+    BOOST_CHECK_EQUAL( 3U, indexed.getKeyword( "PVDG" ).getRecord( 0 ).getItem( 0 ).size() );
+
+    /* the values are in the units of FIELD */
+    BOOST_CHECK_CLOSE( expected.getKeyword( "PVDG" ).getRecord( 0 ).getItem( 0 ).getSIDouble( 0 ),
+                       indexed.getKeyword( "PVDG" ).getRecord( 0 ).getItem( 0 ).getSIDouble( 0 ),
+                       1e-10 );
+
+    /* a keyword is only decoded once */
+    BOOST_CHECK_EQUAL( &indexed.getKeyword( "PORO" ), &indexed.getKeyword( "PORO", 0 ) );
+    BOOST_CHECK_EQUAL( &indexed.getKeyword( "PORO" ),
+                       &indexed.decode( Section( indexed.getIndex(), "GRID" ).getKeyword( "PORO" ) ) );
+
+    checkEqual( indexed, expected );
+}
+
+BOOST_AUTO_TEST_CASE(IndexFileIsReused) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+    const auto path = IndexedDeck::indexPath( test.datafile );
+
+    Parser parser;
+    {
+        const IndexedDeck indexed( parser, test.datafile, context );
+    }
+
+    const std::time_t written = std::time( nullptr ) - 100;
+    fs::last_write_time( path, written );
+    {
+        const IndexedDeck indexed( parser, test.datafile, context );
+        BOOST_CHECK_EQUAL( written, fs::last_write_time( path ) );
+        checkEqual( indexed, parser.parseFile( test.datafile, context ) );
+    }
+
+    /* a changed file makes for a new index */
+    test.write( "grid.inc", "PERMX\n 100*100 /\n\nPORO\n 100*0.3 /\n" );
+    {
+        const IndexedDeck indexed( parser, test.datafile, context );
+        BOOST_CHECK( written != fs::last_write_time( path ) );
+        BOOST_CHECK_CLOSE( 0.3, indexed.getKeyword( "PORO" ).getRecord( 0 ).getItem( 0 ).getSIDouble( 0 ), 1e-10 );
+        checkEqual( indexed, parser.parseFile( test.datafile, context ) );
+    }
+
+    /* and so does another parse context */
+    fs::last_write_time( path, written );
+    {
+        const IndexedDeck indexed( parser, test.datafile, ParseContext( InputError::IGNORE ) );
+        BOOST_CHECK( written != fs::last_write_time( path ) );
+    }
+}
+
+/* the index is read back, and then the file changes without changing size */
+BOOST_AUTO_TEST_CASE(ChangedAfterIndexing) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    {
+        const IndexedDeck indexed( parser, test.datafile, context );
+    }
+
+    const IndexedDeck indexed( parser, test.datafile, context );
+    BOOST_CHECK_EQUAL( 2U, indexed.getIndex().getIncludeGraph().size() );
+
+    test.write( "grid.inc", "PORO\n 100*0.35 /\nPERMX\n 100*100 /\n" );
+    BOOST_CHECK_THROW( indexed.getKeyword( "PORO" ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE(KeywordFromOtherDeck) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    const auto deck = parser.parseFile( test.datafile, context );
+    const IndexedDeck indexed( parser, test.datafile, context );
+
+    BOOST_CHECK_THROW( indexed.decode( deck.getKeyword( "PORO" ) ), std::invalid_argument );
+}
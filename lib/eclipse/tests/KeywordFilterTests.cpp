@@ -0,0 +1,235 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE KeywordFilterTests
+
+#include <memory>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Parser/DeckReader.hpp>
+#include <opm/parser/eclipse/Parser/DecodeCache.hpp>
+#include <opm/parser/eclipse/Parser/KeywordFilter.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+
+#include "DeckTestUtils.hpp"
+
+using namespace Opm;
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct CaseDir : test::CaseDir {
+    CaseDir() :
+        test::CaseDir( "keywordfilter" )
+    {
+        write( "CASE.DATA", R"(
+RUNSPEC
+FIELD
+DIMENS
+ 10 10 1 /
+TABDIMS
+ 1 2 /
+GRID
+INCLUDE
+ 'grid.inc' /
+PROPS
+PVDG
+ 1 2 3 /
+ 4 5 6 /
+SCHEDULE
+TSTEP
+ 10 /
+)" );
+        write( "grid.inc", R"(
+-- the porosity
+PORO
+ 50*0.25
+ 50*0.3 /
+
+PERMX
+ 100*100 /
+)" );
+    }
+};
+
+/* the placeholders decode to the keywords of a full parse */
+void checkDecoded( const Parser& parser, const Deck& deck, const Deck& expected ) {
+    BOOST_REQUIRE_EQUAL( expected.size(), deck.size() );
+
+    for( size_t i = 0; i < deck.size(); ++i ) {
+        const auto& keyword = deck.getKeyword( i );
+        const auto decoded = parser.decodeKeyword( deck, keyword );
+
+        BOOST_CHECK( expected.getKeyword( i ).equal( decoded, true, false ) );
+        BOOST_CHECK_EQUAL( expected.getKeyword( i ).getFileName(), decoded.getFileName() );
+        BOOST_CHECK_EQUAL( expected.getKeyword( i ).getLineNumber(), decoded.getLineNumber() );
+
+        if( decoded.isDataKeyword() )
+            BOOST_CHECK_EQUAL( expected.getKeyword( i ).getSIDoubleData()[ 0 ],
+                               decoded.getSIDoubleData()[ 0 ] );
+    }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(Sections) {
+    const auto filter = KeywordFilter::allow( { "PERMX" }, { "SCHEDULE" } );
+    BOOST_CHECK( filter.decode( "TSTEP", "SCHEDULE" ) );
+    BOOST_CHECK( filter.decode( "PERMX", "GRID" ) );
+    BOOST_CHECK( !filter.decode( "PORO", "GRID" ) );
+    BOOST_CHECK( !filter.decode( "TITLE", "" ) );
+
+    const auto deny = KeywordFilter::deny( { "PERMX" }, { "SCHEDULE" } );
+    BOOST_CHECK( !deny.decode( "TSTEP", "SCHEDULE" ) );
+    BOOST_CHECK( !deny.decode( "PERMX", "GRID" ) );
+    BOOST_CHECK( deny.decode( "PORO", "GRID" ) );
+
+    BOOST_CHECK( KeywordFilter::isSection( "REGIONS" ) );
+    BOOST_CHECK( !KeywordFilter::isSection( "TSTEP" ) );
+}
+
+BOOST_AUTO_TEST_CASE(OnlySchedule) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    const auto expected = parser.parseFile( test.datafile, context );
+
+    parser.setKeywordFilter( std::make_shared< KeywordFilter >(
+                KeywordFilter::allow( {}, { "SCHEDULE" } ) ) );
+    const auto deck = parser.parseFile( test.datafile, context );
+
+    BOOST_CHECK( deck.getKeyword( "TSTEP" ).equal( expected.getKeyword( "TSTEP" ) ) );
+    BOOST_CHECK( !deck.getKeyword( "TSTEP" ).isPlaceholder() );
+
+    /* needed for the size of PVDG */
+    BOOST_CHECK( !deck.getKeyword( "TABDIMS" ).isPlaceholder() );
+
+    const auto& poro = deck.getKeyword( "PORO" );
+    BOOST_CHECK( poro.isPlaceholder() );
+    BOOST_CHECK( poro.isDataKeyword() );
+    BOOST_CHECK_EQUAL( 0U, poro.size() );
+    BOOST_CHECK_EQUAL( 1U, poro.getSkippedRecords() );
+    BOOST_CHECK_EQUAL( expected.getKeyword( "PORO" ).getLineNumber(), poro.getLineNumber() );
+    BOOST_CHECK_EQUAL( expected.getKeyword( "PORO" ).getFileName(), poro.getFileName() );
+
+    const auto& pvdg = deck.getKeyword( "PVDG" );
+    BOOST_CHECK( pvdg.isPlaceholder() );
+    BOOST_CHECK_EQUAL( 2U, pvdg.getSkippedRecords() );
+
+    checkDecoded( parser, deck, expected );
+    BOOST_CHECK_EQUAL( expected.getMessageContainer().size(),
+                       deck.getMessageContainer().size() );
+
+    /* with the parse threads */
+    parser.setParseThreads( 4 );
+    checkDecoded( parser, parser.parseFile( test.datafile, context ), expected );
+}
+
+BOOST_AUTO_TEST_CASE(DenyKeywords) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    const auto expected = parser.parseFile( test.datafile, context );
+
+    parser.setKeywordFilter( std::make_shared< KeywordFilter >(
+                KeywordFilter::deny( { "PERMX", "PVDG" } ) ) );
+    const auto deck = parser.parseFile( test.datafile, context );
+
+    size_t placeholders = 0;
+    for( const auto& keyword : deck )
+        if( keyword.isPlaceholder() ) ++placeholders;
+
+    BOOST_CHECK_EQUAL( 2U, placeholders );
+    BOOST_CHECK( deck.getKeyword( "PERMX" ).isPlaceholder() );
+    BOOST_CHECK( !deck.getKeyword( "PORO" ).isPlaceholder() );
+    checkDecoded( parser, deck, expected );
+
+    /* and the same from the deck reader */
+    DeckReader reader( parser, test.datafile, context );
+    placeholders = 0;
+    while( const auto* keyword = reader.next() )
+        if( keyword->isPlaceholder() ) ++placeholders;
+
+    BOOST_CHECK_EQUAL( 2U, placeholders );
+}
+
+BOOST_AUTO_TEST_CASE(StringsAreDecoded) {
+    Parser parser;
+    parser.setKeywordFilter( std::make_shared< KeywordFilter >(
+                KeywordFilter::allow( {} ) ) );
+
+    const auto deck = parser.parseString( "RUNSPEC\nDIMENS\n 10 10 1 /\n" );
+    BOOST_CHECK( !deck.getKeyword( "DIMENS" ).isPlaceholder() );
+    BOOST_CHECK_EQUAL( 1U, deck.getKeyword( "DIMENS" ).size() );
+}
+
+BOOST_AUTO_TEST_CASE(ChangedFile) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    parser.setKeywordFilter( std::make_shared< KeywordFilter >(
+                KeywordFilter::deny( { "PERMX" } ) ) );
+    const auto deck = parser.parseFile( test.datafile, context );
+
+    test.write( "grid.inc", "PERMX\n 100*100 /\n" );
+    BOOST_CHECK_THROW( parser.decodeKeyword( deck, deck.getKeyword( "PERMX" ) ), std::invalid_argument );
+}
+
+/* a change that keeps the size of the file and the extent of every keyword */
+BOOST_AUTO_TEST_CASE(ChangedValues) {
+    CaseDir test;
+    const ParseContext context( InputError::WARN );
+
+    Parser parser;
+    parser.setKeywordFilter( std::make_shared< KeywordFilter >(
+                KeywordFilter::deny( { "PORO", "PERMX" } ) ) );
+    const auto deck = parser.parseFile( test.datafile, context );
+
+    DecodeCache cache;
+    const auto poro = parser.decodeKeyword( deck, deck.getKeyword( "PORO" ), context, &cache );
+    const auto permx = parser.decodeKeyword( deck, deck.getKeyword( "PERMX" ), context, &cache );
+    BOOST_CHECK_EQUAL( 1U, cache.size() );
+    BOOST_CHECK_CLOSE( 0.3, poro.getRawDoubleData()[ 50 ], 1e-12 );
+    BOOST_CHECK_EQUAL( 100, permx.getRawDoubleData()[ 0 ] );
+
+    test.write( "grid.inc", R"(
+-- the porosity
+PORO
+ 50*0.25
+ 50*0.4 /
+
+PERMX
+ 100*100 /
+)" );
+
+    DecodeCache fresh;
+    BOOST_CHECK_THROW( parser.decodeKeyword( deck, deck.getKeyword( "PORO" ), context, &fresh ),
+                       std::invalid_argument );
+    BOOST_CHECK_THROW( parser.decodeKeyword( deck, deck.getKeyword( "PORO" ) ), std::invalid_argument );
+    BOOST_CHECK_EQUAL( 0U, fresh.size() );
+}
@@ -18,16 +18,22 @@
  */
 
 #define BOOST_TEST_MODULE ParserTests
+#include <fstream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include <opm/json/JsonObject.hpp>
 
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/DeckRecord.hpp>
 #include <opm/parser/eclipse/Parser/ParseContext.hpp>
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/parser/eclipse/Parser/ParserKeyword.hpp>
 #include <opm/parser/eclipse/Parser/ParserKeywords/A.hpp>
+#include <opm/parser/eclipse/Parser/ParserKeywords/C.hpp>
 #include <opm/parser/eclipse/Parser/ParserRecord.hpp>
 #include <opm/parser/eclipse/RawDeck/RawKeyword.hpp>
 #include <opm/parser/eclipse/RawDeck/RawRecord.hpp>
@@ -305,6 +311,46 @@ BOOST_AUTO_TEST_CASE( quoted_comments ) {
     BOOST_CHECK_EQUAL( Parser::stripComments("ABC'--'DEF'--GHI") , "ABC'--'DEF'--GHI");
 }
 
+namespace {
+
+void checkParseFileEqualsParseString( const std::string& input ) {
+    namespace fs = boost::filesystem;
+    const auto datafile = fs::temp_directory_path() / fs::unique_path( "%%%%-%%%%.DATA" );
+    {
+        std::ofstream of( datafile.string().c_str(), std::ios::binary );
+        of << input;
+    }
+
+    Parser parser;
+    const auto fromFile = parser.parseFile( datafile.string(), ParseContext() );
+    const auto fromString = parser.parseString( input, ParseContext() );
+    fs::remove( datafile );
+
+    BOOST_REQUIRE_EQUAL( fromString.size(), fromFile.size() );
+    for( size_t i = 0; i < fromString.size(); ++i )
+        BOOST_CHECK( fromString.getKeyword( i ).equal_data( fromFile.getKeyword( i ), true ) );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( parseFile_no_trailing_newline ) {
+    checkParseFileEqualsParseString( "RUNSPEC\nDIMENS\n 10 10 1 /\nGRID\nPORO\n 100*0.25 /" );
+    checkParseFileEqualsParseString( "RUNSPEC\nDIMENS\n 10 10 1 /\nTITLE\n" );
+}
+
+BOOST_AUTO_TEST_CASE( parseFile_large_input ) {
+    std::string input = "RUNSPEC\nDIMENS\n 100 100 10 /\nGRID\nPORO\n";
+    for( int i = 0; i < 100000; ++i )
+        input += std::to_string( 0.001 * (i % 100) ) + ( i % 7 ? " " : " -- comment /\n" );
+    input += "/\nPERMX\n 100000*100 / -- comment\n";
+
+    checkParseFileEqualsParseString( input );
+
+    /* a file ending on a page boundary takes the non-mapped path */
+    input.resize( input.size() + 65536 - input.size() % 65536, ' ' );
+    checkParseFileEqualsParseString( input );
+}
+
 BOOST_AUTO_TEST_CASE( PATHS_has_global_scope ) {
     Parser parser;
     ParseContext parseContext;
@@ -364,6 +410,166 @@ SWOF
  }
 
 
+namespace {
+
+void checkParallelEqualsSerial( const std::string& input, const ParseContext& parseContext ) {
+    Parser serial;
+    Parser parallel;
+    parallel.setParseThreads( 4 );
+    BOOST_CHECK_EQUAL( 4U, parallel.getParseThreads() );
+
+    const auto deck1 = serial.parseString( input, parseContext );
+    const auto deck2 = parallel.parseString( input, parseContext );
+
+    BOOST_REQUIRE_EQUAL( deck1.size(), deck2.size() );
+    for( size_t i = 0; i < deck1.size(); ++i )
+        BOOST_CHECK( deck1.getKeyword( i ).equal( deck2.getKeyword( i ), true ) );
+
+    const auto& msg1 = deck1.getMessageContainer();
+    const auto& msg2 = deck2.getMessageContainer();
+    BOOST_REQUIRE_EQUAL( msg1.size(), msg2.size() );
+    for( auto m1 = msg1.begin(), m2 = msg2.begin(); m1 != msg1.end(); ++m1, ++m2 ) {
+        BOOST_CHECK_EQUAL( m1->mtype, m2->mtype );
+        BOOST_CHECK_EQUAL( m1->message, m2->message );
+    }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( parallel_parse_equals_serial ) {
+    std::string input = R"(
+RUNSPEC
+TABDIMS
+ 2 /
+DIMENS
+ 10 10 1 /
+GRID
+PORO
+ 100*0.25 /
+XYZ
+ random text
+PERMX
+ 100*10.5 /
+PERMY
+ 100*10.5 1 2 3 /
+PROPS
+SWOF
+0.1 0 1 0
+0.9 1 0 0 /
+0.2 0 1 0
+0.8 1 0 0 /
+SGOF
+0 0 1 0
+1 1 0 0 /
+0 0 1 0
+1 1 0 0 /
+SCHEDULE
+WELSPECS
+ 'PROD' 'G1' 10 10 8400 'OIL' /
+/
+)";
+
+    /* enough keywords to decode in more than one batch */
+    for( int i = 0; i < 5000; ++i )
+        input += "WCONPROD\n 'PROD' 'OPEN' 'ORAT' " + std::to_string( i ) + " /\n/\n";
+
+    checkParallelEqualsSerial( input, ParseContext( InputError::WARN ) );
+    checkParallelEqualsSerial( input, ParseContext( InputError::IGNORE ) );
+}
+
+BOOST_AUTO_TEST_CASE( parallel_parse_throws_first_error ) {
+    const std::string input = R"(
+RUNSPEC
+DIMENS
+ 10 10 1 /
+EQLDIMS
+ 1 2 3 4 5 6 7 /
+GRID
+PORO
+ 100*0.25 /
+XYZ
+ random text
+)";
+
+    ParseContext parseContext( InputError::WARN );
+    parseContext.update( ParseContext::PARSE_EXTRA_DATA, InputError::THROW_EXCEPTION );
+    parseContext.update( ParseContext::PARSE_UNKNOWN_KEYWORD, InputError::THROW_EXCEPTION );
+
+    Parser parser;
+    parser.setParseThreads( 4 );
+    try {
+        parser.parseString( input, parseContext );
+        BOOST_FAIL( "Expected an exception" );
+    } catch( const std::invalid_argument& e ) {
+        BOOST_CHECK_EQUAL( 0U, std::string( e.what() ).find( ParseContext::PARSE_EXTRA_DATA ) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( include_prefetch_equals_serial ) {
+    namespace fs = boost::filesystem;
+    const auto dir = fs::temp_directory_path() / fs::unique_path( "prefetch-%%%%-%%%%" );
+    fs::create_directories( dir / "include" );
+
+    const auto write = [&dir]( const std::string& name, const std::string& content ) {
+        std::ofstream of( ( dir / name ).string().c_str(), std::ios::binary );
+        of << content;
+    };
+
+    write( "CASE.DATA", R"(
+RUNSPEC
+DIMENS
+ 10 10 1 /
+PATHS
+ 'INC' 'include' /
+/
+GRID
+INCLUDE
+ 'include/poro.inc' /
+INCLUDE
+ '$INC/perm.inc' /
+INCLUDE
+ 'include/missing.inc' /
+PROPS
+INCLUDE
+ 'include/props.inc' /
+)" );
+    write( "include/poro.inc", "PORO\n 100*0.25 /\n" );
+    write( "include/perm.inc", "PERMX\n 100*10 /\nINCLUDE\n 'include/permy.inc' /\n" );
+    write( "include/permy.inc", "PERMY\n 100*20 /\n" );
+    write( "include/props.inc", "TABDIMS\n 1 /\n" );
+
+    ParseContext parseContext( InputError::WARN );
+    const auto datafile = ( dir / "CASE.DATA" ).string();
+
+    Parser serial;
+    Parser prefetch;
+    prefetch.setIncludePrefetchThreads( 2 );
+    BOOST_CHECK_EQUAL( 0U, serial.getIncludePrefetchThreads() );
+    BOOST_CHECK_EQUAL( 2U, prefetch.getIncludePrefetchThreads() );
+
+    size_t hits = 0, misses = 0;
+    prefetch.setIncludePrefetchHook( [&]( size_t h, size_t m ) { hits = h; misses = m; } );
+
+    const auto deck1 = serial.parseFile( datafile, parseContext );
+    const auto deck2 = prefetch.parseFile( datafile, parseContext );
+    fs::remove_all( dir );
+
+    BOOST_REQUIRE_EQUAL( deck1.size(), deck2.size() );
+    for( size_t i = 0; i < deck1.size(); ++i )
+        BOOST_CHECK( deck1.getKeyword( i ).equal( deck2.getKeyword( i ), true ) );
+
+    const auto& msg1 = deck1.getMessageContainer();
+    const auto& msg2 = deck2.getMessageContainer();
+    BOOST_REQUIRE_EQUAL( msg1.size(), msg2.size() );
+    for( auto m1 = msg1.begin(), m2 = msg2.begin(); m1 != msg1.end(); ++m1, ++m2 )
+        BOOST_CHECK_EQUAL( m1->message, m2->message );
+
+    /* every include that exists was found, the missing one is reported as usual */
+    BOOST_CHECK( deck2.hasKeyword( "PERMY" ) );
+    BOOST_CHECK_EQUAL( 5U, hits + misses );
+    BOOST_TEST_MESSAGE( "include prefetch: " << hits << " hits, " << misses << " misses" );
+}
+
 BOOST_AUTO_TEST_CASE(ParseTNUM) {
     const char * deck1 =
         "REGIONS\n"
@@ -1873,3 +2079,136 @@ AQUTAB
   BOOST_CHECK_EQUAL( 1, aqutab.size());
 }
 
+BOOST_AUTO_TEST_CASE(ParseDataKeywordWithDimensHint) {
+  const auto * deck_string = R"(
+RUNSPEC
+
+DIMENS
+ 2 2 1 /
+
+GRID
+
+PORO
+ 0.25 2*0.5
+ 1* /
+
+ACTNUM
+ 4*1 /
+
+ZCORN
+ 32*10 /
+
+DXV
+ 2*100 /
+)";
+
+  for( size_t threads : { 1, 2 } ) {
+      Parser parser;
+      parser.setParseThreads( threads );
+      const auto deck = parser.parseString( deck_string, ParseContext());
+
+      const auto& poro = deck.getKeyword("PORO").getRecord(0).getItem(0);
+      BOOST_CHECK_EQUAL( 4U, poro.size() );
+      BOOST_CHECK_EQUAL( 0.25, poro.get< double >( 0 ) );
+      BOOST_CHECK_EQUAL( 0.5, poro.get< double >( 1 ) );
+      BOOST_CHECK_EQUAL( 0.5, poro.get< double >( 2 ) );
+      BOOST_CHECK( !poro.defaultApplied( 2 ) );
+      BOOST_CHECK( poro.defaultApplied( 3 ) );
+
+      const auto& actnum = deck.getKeyword("ACTNUM").getRecord(0).getItem(0);
+      BOOST_CHECK_EQUAL( 4U, actnum.size() );
+      BOOST_CHECK_EQUAL( 1, actnum.get< int >( 3 ) );
+
+      BOOST_CHECK_EQUAL( 32U, deck.getKeyword("ZCORN").getRecord(0).getItem(0).size() );
+      BOOST_CHECK_EQUAL( 2U, deck.getKeyword("DXV").getRecord(0).getItem(0).size() );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ConvertToSIWhenApplyingUnits) {
+  const auto * deck_string = R"(
+RUNSPEC
+
+FIELD
+
+DIMENS
+ 2 2 1 /
+
+TABDIMS
+ 1 1 /
+
+GRID
+
+DXV
+ 2*100 /
+
+PROPS
+
+PVDG
+ 14.7 166.6 0.008
+ 264.7 12.09 0.0096 /
+)";
+
+  Parser lazy;
+  Parser eager;
+  eager.setSIConversion( true );
+  BOOST_CHECK( eager.getSIConversion() );
+  BOOST_CHECK( lazy.getKeywordHash() != eager.getKeywordHash() );
+
+  const auto expected = lazy.parseString( deck_string, ParseContext() );
+  const auto deck = eager.parseString( deck_string, ParseContext() );
+
+  for( const auto* name : { "DXV", "PVDG" } ) {
+      const auto& raw = expected.getKeyword( name ).getRecord( 0 ).getItem( 0 );
+      const auto& item = deck.getKeyword( name ).getRecord( 0 ).getItem( 0 );
+
+      BOOST_CHECK( !raw.isSIConverted() );
+      BOOST_CHECK( item.isSIConverted() );
+      BOOST_REQUIRE_EQUAL( raw.size(), item.size() );
+
+      for( size_t i = 0; i < item.size(); ++i ) {
+          BOOST_CHECK_CLOSE( raw.getSIDouble( i ), item.getSIDouble( i ), 1e-10 );
+          BOOST_CHECK_CLOSE( raw.getSIDouble( i ), item.get< double >( i ), 1e-10 );
+          BOOST_CHECK_CLOSE( raw.get< double >( i ), item.getRawDouble( i ), 1e-10 );
+      }
+  }
+
+  BOOST_CHECK_CLOSE( 30.48, deck.getKeyword( "DXV" ).getRecord( 0 ).getItem( 0 ).get< double >( 1 ), 1e-10 );
+
+  /* the keywords are written in the units of the deck */
+  std::stringstream written, expected_written;
+  written << deck.getKeyword( "PVDG" );
+  expected_written << expected.getKeyword( "PVDG" );
+  BOOST_CHECK_EQUAL( expected_written.str(), written.str() );
+}
+
+BOOST_AUTO_TEST_CASE(GetItemByGeneratedIndex) {
+  const auto * deck_string = R"(
+SCHEDULE
+
+COMPSEGS
+ 'PROD' /
+ 1 1 1 1 100 200 'X' 2 /
+/
+)";
+
+  Parser parser;
+  const auto deck = parser.parseString( deck_string, ParseContext() );
+  const auto& compsegs = deck.getKeyword( "COMPSEGS" );
+  const auto& well = compsegs.getRecord( 0 );
+  const auto& segment = compsegs.getRecord( 1 );
+
+  BOOST_CHECK_EQUAL( 0U, size_t( ParserKeywords::COMPSEGS::WELL::itemIndex ) );
+  BOOST_CHECK_EQUAL( 4U, size_t( ParserKeywords::COMPSEGS::DISTANCE_START::itemIndex ) );
+
+  BOOST_CHECK_EQUAL( &well.getItem( "WELL" ), &well.getItem< ParserKeywords::COMPSEGS::WELL >() );
+  BOOST_CHECK_EQUAL( &segment.getItem( 4 ), &segment.getItem< ParserKeywords::COMPSEGS::DISTANCE_START >() );
+  BOOST_CHECK_EQUAL( 100, segment.getItem< ParserKeywords::COMPSEGS::DISTANCE_START >().get< double >( 0 ) );
+
+  /* the index of I is the index of WELL in the first record */
+  BOOST_CHECK_THROW( well.getItem< ParserKeywords::COMPSEGS::I >(), std::invalid_argument );
+
+  /* a record of a deck made by hand has its items anywhere */
+  DeckRecord record;
+  record.addItem( DeckItem( "DISTANCE_START", double() ) );
+  BOOST_CHECK_EQUAL( &record.getItem( 0 ), &record.getItem< ParserKeywords::COMPSEGS::DISTANCE_START >() );
+}
@@ -19,12 +19,14 @@
 
 #define BOOST_TEST_MODULE RawKeywordTests
 #include <cstring>
+#include <iterator>
 #include <stdexcept>
 #include <boost/test/unit_test.hpp>
 
 #include <opm/parser/eclipse/RawDeck/RawEnums.hpp>
 #include <opm/parser/eclipse/RawDeck/RawKeyword.hpp>
 #include <opm/parser/eclipse/RawDeck/RawRecord.hpp>
+#include <opm/parser/eclipse/Utility/SourceNames.hpp>
 
 
 using namespace Opm;
@@ -191,6 +193,45 @@ BOOST_AUTO_TEST_CASE(isUnknownSize) {
     BOOST_CHECK_EQUAL( Raw::UNKNOWN  , keyword.getSizeType( ));
  }
 
+BOOST_AUTO_TEST_CASE(classifyLine) {
+    RawKeyword::DeckName name;
+
+    BOOST_CHECK( Raw::LineType::KEYWORD == RawKeyword::classifyLine( "ZCORN", name ) );
+    BOOST_CHECK_EQUAL( "ZCORN", name.view() );
+    BOOST_CHECK( Raw::LineType::KEYWORD == RawKeyword::classifyLine( "wconHIST  -- comment", name ) );
+    BOOST_CHECK_EQUAL( "WCONHIST", name.view() );
+    BOOST_CHECK( Raw::LineType::KEYWORD == RawKeyword::classifyLine( "pvt-m\t", name ) );
+    BOOST_CHECK_EQUAL( "PVT-M", name.view() );
+
+    BOOST_CHECK( Raw::LineType::DATA == RawKeyword::classifyLine( "", name ) );
+    BOOST_CHECK( Raw::LineType::DATA == RawKeyword::classifyLine( "100 200 /", name ) );
+    BOOST_CHECK( Raw::LineType::DATA == RawKeyword::classifyLine( "-1.5", name ) );
+    BOOST_CHECK( Raw::LineType::DATA == RawKeyword::classifyLine( "+7", name ) );
+    BOOST_CHECK( Raw::LineType::DATA == RawKeyword::classifyLine( ".5", name ) );
+    BOOST_CHECK( Raw::LineType::DATA == RawKeyword::classifyLine( "'OP_1' 1 1 /", name ) );
+    BOOST_CHECK( Raw::LineType::DATA == RawKeyword::classifyLine( "3* 1 /", name ) );
+
+    BOOST_CHECK( Raw::LineType::TERMINATOR == RawKeyword::classifyLine( "/", name ) );
+    BOOST_CHECK( Raw::LineType::TERMINATOR == RawKeyword::classifyLine( "/  \t", name ) );
+
+    BOOST_CHECK( Raw::LineType::GARBAGE == RawKeyword::classifyLine( "/ 1", name ) );
+    BOOST_CHECK( Raw::LineType::GARBAGE == RawKeyword::classifyLine( "BAD(NAME", name ) );
+    BOOST_CHECK( Raw::LineType::GARBAGE == RawKeyword::classifyLine( " ZCORN", name ) );
+    BOOST_CHECK( Raw::LineType::GARBAGE == RawKeyword::classifyLine( "_ZCORN", name ) );
+    BOOST_CHECK_EQUAL( 0U, name.size );
+}
+
+BOOST_AUTO_TEST_CASE(classifyLineCutsLongNames) {
+    RawKeyword::DeckName name;
+
+    /* reported as an unknown keyword, so that its data lines are skipped */
+    BOOST_CHECK( Raw::LineType::KEYWORD == RawKeyword::classifyLine( "abcdefghijkl", name ) );
+    BOOST_CHECK_EQUAL( "ABCDEFGHI", name.view() );
+    BOOST_CHECK( Raw::LineType::KEYWORD == RawKeyword::classifyLine( "TOOLONGNA(ME", name ) );
+    BOOST_CHECK_EQUAL( "TOOLONGNA", name.view() );
+    BOOST_CHECK( Raw::LineType::GARBAGE == RawKeyword::classifyLine( "TOO(LONGNAME", name ) );
+}
+
 BOOST_AUTO_TEST_CASE(RawRecordGetRecordsCorrectElementsReturned) {
     Opm::RawRecord record(" 'NODIR '  'REVERS'  1  20                                       ");
 
@@ -231,6 +272,62 @@ BOOST_AUTO_TEST_CASE(Rawrecord_PushFront_OK) {
     BOOST_CHECK_EQUAL("String2", record.getItem(1));
 }
 
+BOOST_AUTO_TEST_CASE(Rawrecord_PrependRepeat_OK) {
+    Opm::RawRecord record("1 2 3");
+    record.pop_front();
+    record.prepend( 1000000, "X" );
+    record.prepend( 0, "NONE" );
+    record.prepend( 2, "Y" );
+
+    BOOST_CHECK_EQUAL(1000004U, record.size());
+    BOOST_CHECK_EQUAL("Y", record.getItem(1));
+    BOOST_CHECK_EQUAL("X", record.getItem(2));
+    BOOST_CHECK_EQUAL("X", record.getItem(1000001));
+    BOOST_CHECK_EQUAL("2", record.getItem(1000002));
+    BOOST_CHECK_EQUAL("3", record.getItem(1000003));
+    BOOST_CHECK_THROW(record.getItem(1000004), std::out_of_range);
+
+    BOOST_CHECK_EQUAL("Y", record.pop_front());
+    BOOST_CHECK_EQUAL("Y", record.pop_front());
+    for (size_t i = 0; i < 1000000; i++)
+        record.pop_front();
+
+    BOOST_CHECK_EQUAL(2U, record.size());
+    BOOST_CHECK_EQUAL("2", record.pop_front());
+    BOOST_CHECK_EQUAL("3", record.pop_front());
+    BOOST_CHECK_EQUAL(0U, record.size());
+}
+
+BOOST_AUTO_TEST_CASE(Rawrecord_PopRecordString_OK) {
+    Opm::RawRecord record(" 1 2*3 'A B' ");
+    Opm::string_view str;
+
+    BOOST_CHECK( record.popRecordString( str ) );
+    BOOST_CHECK_EQUAL(" 1 2*3 'A B' ", str);
+    BOOST_CHECK_EQUAL(0U, record.size());
+    BOOST_CHECK( !record.popRecordString( str ) );
+
+    Opm::RawRecord split("1 2 3");
+    BOOST_CHECK_EQUAL(3U, split.size());
+    BOOST_CHECK( !split.popRecordString( str ) );
+
+    Opm::RawRecord prepended("1 2 3");
+    prepended.prepend( 1, "0" );
+    BOOST_CHECK( !prepended.popRecordString( str ) );
+    BOOST_CHECK_EQUAL(4U, prepended.size());
+}
+
+BOOST_AUTO_TEST_CASE(Rawrecord_NextToken_OK) {
+    const Opm::string_view str( " 1,\t'A B'  3*  " );
+    auto current = str.begin();
+
+    BOOST_CHECK_EQUAL("1", Opm::RawRecord::nextToken( current, str.end() ));
+    BOOST_CHECK_EQUAL("'A B'", Opm::RawRecord::nextToken( current, str.end() ));
+    BOOST_CHECK_EQUAL("3*", Opm::RawRecord::nextToken( current, str.end() ));
+    BOOST_CHECK( Opm::RawRecord::nextToken( current, str.end() ).empty() );
+    BOOST_CHECK( current == str.end() );
+}
+
 BOOST_AUTO_TEST_CASE(Rawrecord_size_OK) {
     Opm::RawRecord record(" 'NODIR '  'REVERS'  1  20  ");
 
@@ -263,3 +360,27 @@ BOOST_AUTO_TEST_CASE(Rawrecord_FileAndKeywordGiven_CorrectStringsReturned) {
     BOOST_CHECK_EQUAL(keywordName, record.getKeywordName());
     BOOST_CHECK_EQUAL(fileName, record.getFileName());
 }
+
+BOOST_AUTO_TEST_CASE(RawKeywordRecordsShareInternedNames) {
+    RawKeyword keyword("TEST", Raw::SLASH_TERMINATED , "/path/to/FILE" , 10U);
+    keyword.addRawRecordString("1 2 /");
+    keyword.addRawRecordString("3 4 /");
+
+    const auto& first = *keyword.begin();
+    const auto& second = *std::next( keyword.begin() );
+
+    BOOST_CHECK_EQUAL( keyword.getSourceNames()->intern( "/path/to/FILE" ), keyword.getFileId() );
+    BOOST_CHECK_EQUAL( "/path/to/FILE", keyword.getFilename() );
+    BOOST_CHECK_EQUAL( "TEST", first.getKeywordName() );
+    BOOST_CHECK_EQUAL( &first.getFileName(), &second.getFileName() );
+    BOOST_CHECK_EQUAL( &keyword.getFilename(), &first.getFileName() );
+
+    BOOST_CHECK_EQUAL( &keyword.getFilename(), &keyword.getSourceNames()->name( keyword.getFileId() ) );
+
+    SourceNames names;
+    BOOST_CHECK_EQUAL( 0U, names.intern( "" ) );
+    BOOST_CHECK_EQUAL( 1U, names.intern( "/path/to/FILE" ) );
+    BOOST_CHECK_EQUAL( 1U, names.intern( "/path/to/FILE" ) );
+    BOOST_CHECK_EQUAL( 2U, names.size() );
+    BOOST_CHECK_THROW( names.name( SourceNames::id( -1 ) ), std::out_of_range );
+}
@@ -56,6 +56,41 @@ BOOST_AUTO_TEST_CASE(SectionTest) {
     BOOST_CHECK(!gridSection.hasKeyword("TEST1"));
 }
 
+BOOST_AUTO_TEST_CASE(SectionSharesIndexOfDeck) {
+    Deck deck;
+    deck.addKeyword( DeckKeyword( "RUNSPEC" ) );
+    deck.addKeyword( DeckKeyword( "TEST1" ) );
+    deck.addKeyword( DeckKeyword( "GRID" ) );
+    deck.addKeyword( DeckKeyword( "TEST1" ) );
+    deck.addKeyword( DeckKeyword( "TEST2" ) );
+    deck.addKeyword( DeckKeyword( "TEST1" ) );
+    deck.addKeyword( DeckKeyword( "SCHEDULE" ) );
+    deck.addKeyword( DeckKeyword( "TEST1" ) );
+
+    const Section grid( deck, "GRID" );
+    BOOST_CHECK_EQUAL( 4U, grid.size() );
+    BOOST_CHECK_EQUAL( 2U, grid.count( "TEST1" ) );
+    BOOST_CHECK_EQUAL( 2U, grid.getKeywordList( "TEST1" ).size() );
+    BOOST_CHECK_EQUAL( &deck.getKeyword( "TEST1", 1 ), &grid.getKeyword( "TEST1", 0 ) );
+    BOOST_CHECK_EQUAL( &deck.getKeyword( "TEST1", 2 ), &grid.getKeyword( "TEST1" ) );
+    BOOST_CHECK_EQUAL( &deck.getKeyword( 4 ), &grid.getKeyword( 2 ) );
+    BOOST_CHECK_THROW( grid.getKeyword( "TEST1", 2 ), std::out_of_range );
+    BOOST_CHECK_THROW( grid.getKeyword( "TEST3" ), std::invalid_argument );
+
+    BOOST_CHECK( grid.hasKeyword( deck.getKeyword( "TEST1", 1 ) ) );
+    BOOST_CHECK( !grid.hasKeyword( deck.getKeyword( "TEST1", 0 ) ) );
+    BOOST_CHECK( !grid.hasKeyword( deck.getKeyword( "TEST1", 3 ) ) );
+
+    Section schedule( deck, "SCHEDULE" );
+    BOOST_CHECK_EQUAL( 1U, schedule.count( "TEST1" ) );
+    BOOST_CHECK_EQUAL( 0U, schedule.count( "TEST2" ) );
+    BOOST_CHECK_EQUAL( 0U, Section( deck, "PROPS" ).size() );
+
+    const Deck copy( deck );
+    BOOST_CHECK_EQUAL( 4U, copy.count( "TEST1" ) );
+    BOOST_CHECK_EQUAL( &copy.getKeyword( 4 ), &Section( copy, "GRID" ).getKeyword( "TEST2" ) );
+}
+
 BOOST_AUTO_TEST_CASE(IteratorTest) {
     Deck deck;
     deck.addKeyword( DeckKeyword( "RUNSPEC" ) );
@@ -18,6 +18,14 @@
  */
 
 #define BOOST_TEST_MODULE ParserTests
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
 #include <stdexcept>
 #include <boost/test/unit_test.hpp>
 #include <opm/parser/eclipse/RawDeck/StarToken.hpp>
@@ -88,7 +96,7 @@ BOOST_AUTO_TEST_CASE(CorrectValueString) {
 }
 
 BOOST_AUTO_TEST_CASE( ContainsStar_WithStar_ReturnsTrue ) {
-    std::string countString, valueString;
+    Opm::string_view countString, valueString;
     BOOST_CHECK_EQUAL( true , Opm::isStarToken("*", countString, valueString) );
     BOOST_CHECK_EQUAL( true , Opm::isStarToken("*1", countString, valueString) );
     BOOST_CHECK_EQUAL( true , Opm::isStarToken("1*", countString, valueString) );
@@ -98,6 +106,28 @@ BOOST_AUTO_TEST_CASE( ContainsStar_WithStar_ReturnsTrue ) {
     BOOST_CHECK_EQUAL( false , Opm::isStarToken("'12*34'", countString, valueString) );
 }
 
+BOOST_AUTO_TEST_CASE( StarToken_ViewsIntoToken ) {
+    const std::string token = "12*0.25";
+    Opm::string_view countString, valueString;
+    BOOST_REQUIRE( Opm::isStarToken( token, countString, valueString ) );
+
+    BOOST_CHECK( countString.begin() == token.data() );
+    BOOST_CHECK( valueString.begin() == token.data() + 3 );
+    BOOST_CHECK( valueString.end() == token.data() + token.size() );
+
+    Opm::StarToken st( token );
+    BOOST_CHECK_EQUAL( 12U, st.count() );
+    BOOST_CHECK_EQUAL( "12", st.countString() );
+    BOOST_CHECK_EQUAL( "0.25", st.valueString() );
+}
+
+BOOST_AUTO_TEST_CASE( StarToken_CountOverflowThrows ) {
+    Opm::StarToken st( "2147483647*" );
+    BOOST_CHECK_EQUAL( 2147483647U, st.count() );
+    BOOST_CHECK_THROW( Opm::StarToken( "2147483648*" ), std::out_of_range );
+    BOOST_CHECK_THROW( Opm::StarToken( "99999999999999999999*1" ), std::out_of_range );
+}
+
 BOOST_AUTO_TEST_CASE( readValueToken_basic_validity_tests ) {
     BOOST_CHECK_THROW( Opm::readValueToken<int>( std::string( "3.3" ) ), std::invalid_argument );
     BOOST_CHECK_EQUAL( 3, Opm::readValueToken<int>( std::string( "3" ) ) );
@@ -124,3 +154,69 @@ BOOST_AUTO_TEST_CASE( readValueToken_basic_validity_tests ) {
     BOOST_CHECK_EQUAL( "123*456", Opm::readValueToken<std::string>( std::string( "123*456" ) ) );
     BOOST_CHECK_EQUAL( "123*456", Opm::readValueToken<std::string>( std::string( "'123*456'" ) ) );
 }
+
+BOOST_AUTO_TEST_CASE( readValueToken_malformed_numbers ) {
+    for( const auto* token : { "", ".", "-", "+", "e5", ".e5", "1e", "1.5E+", "1d-", "--1",
+                               "+-1", "1.0.0", "1e5.0", "1,5", "0x10", "1 ", " 1", "1*" } )
+        BOOST_CHECK_THROW( Opm::readValueToken<double>( std::string( token ) ), std::invalid_argument );
+
+    for( const auto* token : { "", "-", "+", "1.", "1e5", "--1", "2147483648", "-2147483649", " 1" } )
+        BOOST_CHECK_THROW( Opm::readValueToken<int>( std::string( token ) ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( readValueToken_number_forms ) {
+    BOOST_CHECK_EQUAL( 2147483647, Opm::readValueToken<int>( std::string( "2147483647" ) ) );
+    BOOST_CHECK_EQUAL( -2147483647 - 1, Opm::readValueToken<int>( std::string( "-2147483648" ) ) );
+    BOOST_CHECK_EQUAL( 7, Opm::readValueToken<int>( std::string( "0000000000007" ) ) );
+
+    BOOST_CHECK_EQUAL( 1.0, Opm::readValueToken<double>( std::string( "1." ) ) );
+    BOOST_CHECK_EQUAL( -0.5, Opm::readValueToken<double>( std::string( "-.5" ) ) );
+    BOOST_CHECK_EQUAL( 0.25, Opm::readValueToken<double>( std::string( "0.25" ) ) );
+    BOOST_CHECK_EQUAL( -1.5e3, Opm::readValueToken<double>( std::string( "-1.5E+03" ) ) );
+    BOOST_CHECK_EQUAL( 1.234e5, Opm::readValueToken<double>( std::string( "1.234D5" ) ) );
+    BOOST_CHECK_EQUAL( 1.234e-5, Opm::readValueToken<double>( std::string( "1.234d-5" ) ) );
+    BOOST_CHECK_EQUAL( 1e23, Opm::readValueToken<double>( std::string( "1e23" ) ) );
+    BOOST_CHECK_EQUAL( 1e-300, Opm::readValueToken<double>( std::string( "1e-300" ) ) );
+    BOOST_CHECK_EQUAL( 9007199254740992.0, Opm::readValueToken<double>( std::string( "9007199254740993" ) ) );
+    BOOST_CHECK_EQUAL( 1.7976931348623157e308, Opm::readValueToken<double>( std::string( "1.7976931348623157e308" ) ) );
+    BOOST_CHECK_EQUAL( 2.2250738585072014e-308, Opm::readValueToken<double>( std::string( "2.2250738585072014e-308" ) ) );
+    BOOST_CHECK_EQUAL( 0.1, Opm::readValueToken<double>( std::string( "0.1000000000000000000000000001" ) ) );
+    BOOST_CHECK( std::signbit( Opm::readValueToken<double>( std::string( "-0" ) ) ) );
+    BOOST_CHECK( std::isinf( Opm::readValueToken<double>( std::string( "-inf" ) ) ) );
+    BOOST_CHECK( std::isnan( Opm::readValueToken<double>( std::string( "nan" ) ) ) );
+}
+
+/*
+ * Doubles printed with every precision and in every exponent style the deck
+ * writers use must read back as the correctly rounded value.
+ */
+BOOST_AUTO_TEST_CASE( readValueToken_correctly_rounded ) {
+    std::mt19937_64 rng( 2017 );
+    std::uniform_real_distribution< double > mantissa( -10, 10 );
+    std::uniform_int_distribution< int > exponent( -30, 30 );
+    std::uniform_int_distribution< std::uint64_t > bits;
+
+    char buffer[ 64 ];
+    for( int i = 0; i < 200000; ++i ) {
+        double x = mantissa( rng ) * std::pow( 10.0, exponent( rng ) );
+        if( i % 4 == 0 ) {
+            const auto b = bits( rng );
+            std::memcpy( &x, &b, sizeof( x ) );
+            if( !std::isfinite( x ) ) continue;
+        }
+
+        const int precision = 1 + i % 17;
+        std::snprintf( buffer, sizeof( buffer ), i % 2 ? "%.*g" : "%.*E", precision, x );
+        const double expected = std::strtod( buffer, nullptr );
+
+        /* subnormals and overflow are left to the general parser */
+        if( std::fabs( expected ) < DBL_MIN || std::isinf( expected ) ) continue;
+
+        std::string token( buffer );
+        std::replace( token.begin(), token.end(), 'E', 'D' );
+
+        const double actual = Opm::readValueToken<double>( token );
+        if( actual != expected )
+            BOOST_ERROR( token << " read as " << actual << ", expected " << expected );
+    }
+}
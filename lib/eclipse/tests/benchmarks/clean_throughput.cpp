@@ -0,0 +1,102 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Throughput of the input cleaner for every instruction set supported by the
+ * processor, on synthetic input resembling a large grid property include:
+ * long lines of numbers with the occasional comment.
+ *
+ *   clean_throughput [megabytes] [repetitions]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <opm/parser/eclipse/RawDeck/Cleaner.hpp>
+
+namespace {
+
+std::string make_input( size_t size ) {
+    std::mt19937 rng( 42 );
+    std::uniform_real_distribution< double > value( 0, 1000 );
+    std::uniform_int_distribution< int > line( 0, 50 );
+
+    std::string input = "-- synthetic input\nPERMX\n";
+    while( input.size() < size ) {
+        for( int i = 0; i < 8; ++i )
+            input += std::to_string( value( rng ) ) + ' ';
+
+        if( line( rng ) == 0 ) input += "  -- a comment with a / slash";
+        input += '\n';
+    }
+
+    return input + "/\n";
+}
+
+const char* name( Opm::Cleaner::ISA isa ) {
+    switch( isa ) {
+        case Opm::Cleaner::ISA::avx2:  return "avx2";
+        case Opm::Cleaner::ISA::sse42: return "sse4.2";
+        default: return "scalar";
+    }
+}
+
+}
+
+int main( int argc, char** argv ) {
+    const size_t megabytes = argc > 1 ? std::atoi( argv[ 1 ] ) : 256;
+    const int repetitions = argc > 2 ? std::atoi( argv[ 2 ] ) : 5;
+
+    const auto input = make_input( megabytes << 20 );
+    std::string buffer;
+    buffer.reserve( input.size() + 1 );
+
+    for( auto isa : { Opm::Cleaner::ISA::scalar,
+                      Opm::Cleaner::ISA::sse42,
+                      Opm::Cleaner::ISA::avx2 } ) {
+
+        if( !Opm::Cleaner::supported( isa ) ) continue;
+
+        double best = 0;
+        size_t cleaned = 0;
+        for( int i = 0; i < repetitions; ++i ) {
+            buffer.assign( input );
+            buffer.push_back( '\n' );
+            auto* begin = &buffer[ 0 ];
+
+            const auto start = std::chrono::steady_clock::now();
+            auto* end = Opm::Cleaner::clean( begin, begin + input.size(), isa );
+            const auto stop = std::chrono::steady_clock::now();
+
+            const std::chrono::duration< double > elapsed = stop - start;
+            best = std::max( best, input.size() / elapsed.count() / ( 1 << 20 ) );
+            cleaned = end - begin;
+        }
+
+        std::cout << std::setw( 8 ) << name( isa ) << ": "
+                  << std::fixed << std::setprecision( 1 ) << best << " MB/s"
+                  << " (" << input.size() << " -> " << cleaned << " bytes)"
+                  << std::endl;
+    }
+}
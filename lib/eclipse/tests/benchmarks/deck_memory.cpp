@@ -0,0 +1,157 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The heap memory held by the deck of a synthetic schedule, with a WCONHIST
+ * and a COMPDAT record for every well at every report step. The allocations
+ * are counted by replacing the global operator new and delete.
+ *
+ *   deck_memory [wells] [steps]
+ */
+
+#define OPM_PARSER_DECK_API 1
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckItem.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/DeckRecord.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+
+namespace {
+
+std::atomic< size_t > live_bytes( 0 );
+std::atomic< size_t > allocations( 0 );
+
+/* the size of an allocation is kept in front of it */
+const size_t header = 16;
+
+}
+
+void* operator new( std::size_t size ) {
+    auto* block = static_cast< char* >( std::malloc( size + header ) );
+    if( !block ) throw std::bad_alloc();
+
+    *reinterpret_cast< std::size_t* >( block ) = size;
+    live_bytes += size;
+    ++allocations;
+    return block + header;
+}
+
+void operator delete( void* ptr ) noexcept {
+    if( !ptr ) return;
+
+    auto* block = static_cast< char* >( ptr ) - header;
+    live_bytes -= *reinterpret_cast< std::size_t* >( block );
+    std::free( block );
+}
+
+void* operator new[]( std::size_t size ) {
+    return ::operator new( size );
+}
+
+void operator delete[]( void* ptr ) noexcept {
+    ::operator delete( ptr );
+}
+
+void* operator new( std::size_t size, const std::nothrow_t& ) noexcept {
+    try {
+        return ::operator new( size );
+    } catch( const std::bad_alloc& ) {
+        return nullptr;
+    }
+}
+
+void operator delete( void* ptr, const std::nothrow_t& ) noexcept {
+    ::operator delete( ptr );
+}
+
+namespace {
+
+std::string make_schedule( size_t wells, size_t steps ) {
+    std::string input = "SCHEDULE\n";
+
+    for( size_t step = 0; step < steps; ++step ) {
+        input += "WCONHIST\n";
+        for( size_t well = 0; well < wells; ++well )
+            input += "  'W" + std::to_string( well ) + "' 'OPEN' 'ORAT' "
+                   + std::to_string( 100 + step % 7 ) + " 10.5 2* /\n";
+        input += "/\n";
+
+        input += "COMPDAT\n";
+        for( size_t well = 0; well < wells; ++well )
+            input += "  'W" + std::to_string( well ) + "' 2* 1 3 'OPEN' 2* 0.5 /\n";
+        input += "/\n";
+
+        input += "TSTEP\n 30 /\n";
+    }
+
+    return input;
+}
+
+}
+
+int main( int argc, char** argv ) {
+    const size_t wells = argc > 1 ? std::atoi( argv[ 1 ] ) : 2000;
+    const size_t steps = argc > 2 ? std::atoi( argv[ 2 ] ) : 500;
+
+    const auto input = make_schedule( wells, steps );
+    const Opm::ParseContext context( Opm::InputError::IGNORE );
+    const Opm::Parser parser;
+
+    const size_t before = live_bytes;
+    const size_t allocations_before = allocations;
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto deck = parser.parseString( input, context );
+
+    const auto stop = std::chrono::steady_clock::now();
+    const size_t bytes = live_bytes - before;
+
+    size_t items = 0, values = 0;
+    for( const auto& keyword : deck ) {
+        for( const auto& record : keyword ) {
+            for( const auto& item : record ) {
+                ++items;
+                values += item.out_size();
+            }
+        }
+    }
+
+    const std::chrono::duration< double > elapsed = stop - start;
+    std::cout << wells << " wells, " << steps << " steps: "
+              << deck.size() << " keywords, "
+              << items << " items, "
+              << values << " values\n"
+              << "  sizeof( DeckItem ): " << sizeof( Opm::DeckItem ) << " bytes\n"
+              << "  deck:               " << std::fixed << std::setprecision( 1 )
+              << bytes / double( 1 << 20 ) << " MB, "
+              << std::setprecision( 1 ) << double( bytes ) / items << " bytes per item\n"
+              << "  allocations:        " << allocations - allocations_before << "\n"
+              << "  parse:              " << std::setprecision( 2 ) << elapsed.count() << " s"
+              << std::endl;
+}
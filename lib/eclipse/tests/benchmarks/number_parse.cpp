@@ -0,0 +1,176 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Number parsing with readValueToken compared to the boost::spirit parser it
+ * used to be, on token distributions resembling the big keywords of a deck:
+ *
+ *   poro    porosities, 0.2534
+ *   permx   permeabilities, 1234.5 and 0.75
+ *   zcorn   depths, 2045.1234
+ *   sci     scientific, -1.5E+03 and 1.234D5
+ *   int     region numbers and ACTNUM, 0 1 17
+ *
+ *   number_parse [tokens] [repetitions]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/spirit/include/qi.hpp>
+
+#include <opm/parser/eclipse/RawDeck/StarToken.hpp>
+#include <opm/parser/eclipse/Utility/Stringview.hpp>
+
+namespace qi = boost::spirit::qi;
+
+namespace {
+
+template< typename T >
+struct fortran_double : qi::real_policies< T > {
+    template< typename It >
+    static bool parse_exp( It& first, const It& last ) {
+        if( first == last ||
+            (*first != 'e' && *first != 'E' &&
+            *first != 'd' && *first != 'D' ) )
+            return false;
+        ++first;
+        return true;
+    }
+};
+
+double spirit_double( Opm::string_view view ) {
+    double n = 0;
+    qi::real_parser< double, fortran_double< double > > double_;
+    auto cursor = view.begin();
+    const auto ok = qi::parse( cursor, view.end(), double_, n );
+
+    if( ok && cursor == view.end() ) return n;
+    throw std::invalid_argument( "Malformed floating point number '" + view + "'" );
+}
+
+int spirit_int( Opm::string_view view ) {
+    int n = 0;
+    auto cursor = view.begin();
+    const bool ok = qi::parse( cursor, view.end(), qi::int_, n );
+
+    if( ok && cursor == view.end() ) return n;
+    throw std::invalid_argument( "Malformed integer '" + view + "'" );
+}
+
+std::string format( const char* fmt, double x ) {
+    char buffer[ 64 ];
+    std::snprintf( buffer, sizeof( buffer ), fmt, x );
+    return buffer;
+}
+
+std::vector< std::string > make_tokens( const std::string& kind, size_t count ) {
+    std::mt19937 rng( 42 );
+    std::uniform_real_distribution< double > unit( 0, 1 );
+    std::uniform_int_distribution< int > region( 0, 20 );
+
+    std::vector< std::string > tokens;
+    tokens.reserve( count );
+    for( size_t i = 0; i < count; ++i ) {
+        const auto u = unit( rng );
+        if( kind == "poro" )
+            tokens.push_back( format( "%.4f", 0.05 + 0.3 * u ) );
+        else if( kind == "permx" )
+            tokens.push_back( format( i % 3 ? "%.1f" : "%.2f", i % 3 ? 5000 * u : u ) );
+        else if( kind == "zcorn" )
+            tokens.push_back( format( "%.4f", 2000 + 100 * u ) );
+        else if( kind == "sci" )
+            tokens.push_back( format( i % 2 ? "%.6E" : "%.3E", ( u - 0.5 ) * 1e4 ) );
+        else
+            tokens.push_back( std::to_string( i % 2 ? region( rng ) : int( u < 0.9 ) ) );
+
+        if( kind == "sci" && i % 4 == 0 )
+            std::replace( tokens.back().begin(), tokens.back().end(), 'E', 'D' );
+    }
+
+    return tokens;
+}
+
+template< typename T >
+double time( const std::vector< Opm::string_view >& tokens,
+             int repetitions,
+             T (*parse)( Opm::string_view ),
+             std::vector< T >& out ) {
+    double best = 1e100;
+    for( int i = 0; i < repetitions; ++i ) {
+        out.clear();
+        const auto start = std::chrono::steady_clock::now();
+        for( const auto& token : tokens )
+            out.push_back( parse( token ) );
+        const auto stop = std::chrono::steady_clock::now();
+
+        const std::chrono::duration< double, std::nano > elapsed = stop - start;
+        best = std::min( best, elapsed.count() / tokens.size() );
+    }
+
+    return best;
+}
+
+template< typename T >
+void run( const std::string& kind, size_t count, int repetitions,
+          T (*fast)( Opm::string_view ),
+          T (*spirit)( Opm::string_view ) ) {
+
+    const auto strings = make_tokens( kind, count );
+    const std::vector< Opm::string_view > tokens( strings.begin(), strings.end() );
+
+    std::vector< T > fast_values, spirit_values;
+    fast_values.reserve( count );
+    spirit_values.reserve( count );
+
+    const auto t_spirit = time( tokens, repetitions, spirit, spirit_values );
+    const auto t_fast = time( tokens, repetitions, fast, fast_values );
+
+    size_t differ = 0;
+    for( size_t i = 0; i < count; ++i )
+        differ += fast_values[ i ] != spirit_values[ i ];
+
+    std::cout << std::setw( 6 ) << kind << ": "
+              << std::fixed << std::setprecision( 1 )
+              << "spirit " << std::setw( 6 ) << t_spirit << " ns/token, "
+              << "readValueToken " << std::setw( 6 ) << t_fast << " ns/token, "
+              << "speedup " << std::setprecision( 2 ) << t_spirit / t_fast << "x"
+              << " (" << differ << " values differ in rounding)"
+              << std::endl;
+}
+
+}
+
+int main( int argc, char** argv ) {
+    const size_t count = argc > 1 ? std::atoi( argv[ 1 ] ) : 1000000;
+    const int repetitions = argc > 2 ? std::atoi( argv[ 2 ] ) : 5;
+
+    for( const auto* kind : { "poro", "permx", "zcorn", "sci" } )
+        run< double >( kind, count, repetitions,
+                       &Opm::readValueToken< double >, &spirit_double );
+
+    run< int >( "int", count, repetitions, &Opm::readValueToken< int >, &spirit_int );
+}